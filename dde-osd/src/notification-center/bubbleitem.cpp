@@ -14,7 +14,11 @@
 #include "notification/appbodylabel.h"
 #include "notifymodel.h"
 #include "notifylistview.h"
+#include "relativetimescheduler.h"
+#include "cardbackgroundcache.h"
 #include "notification/signalbridge.h"
+#include "notification/notifystyle.h"
+#include "desktopentryindex.h"
 
 #include <QTimer>
 #include <QDateTime>
@@ -23,12 +27,11 @@
 #include <QProcess>
 #include <QMouseEvent>
 #include <QScroller>
-#include <QPainterPath>
+#include <QPainter>
 
 #include <DIconButton>
 #include <DStyleHelper>
 #include <DGuiApplicationHelper>
-#include <DFontSizeManager>
 
 AlphaWidget::AlphaWidget(QWidget *parent)
     : DWidget(parent)
@@ -39,34 +42,13 @@ void AlphaWidget::paintEvent(QPaintEvent *event)
 {
     Q_UNUSED(event)
     QPainter painter(this);
-    painter.setRenderHint(QPainter::Antialiasing);
 
     QPalette pe = this->palette();
     QColor brushColor(pe.color(QPalette::Base));
     brushColor.setAlpha(m_hasFocus ? m_hoverAlpha : m_unHoverAlpha);
-    painter.setBrush(brushColor);
-
-    QPen borderPen;
-    borderPen.setColor(Qt::transparent);
-    painter.setPen(borderPen);
-
-    QRect rect = this->rect();
-    const QPoint topLeft = rect.topLeft();
-    const QPoint topRight = rect.topRight();
-    const QPoint bottomLeft = rect.bottomLeft();
-    const QPoint bottomRight = rect.bottomRight();
-
-    QPainterPath path;
-    path.moveTo(topLeft.x() + m_topRedius, topRight.y());
-    path.lineTo(topRight.x() - m_topRedius, topRight.y());
-    path.arcTo(topRight.x() - 2 * m_topRedius, topRight.y(), 2 * m_topRedius, 2 * m_topRedius, 90, -90);
-    path.lineTo(bottomRight.x(), bottomRight.y() - m_bottomRedius);
-    path.arcTo(bottomRight.x() - 2 * m_bottomRedius, bottomRight.y() - 2 * m_bottomRedius, 2 * m_bottomRedius, 2 * m_bottomRedius, 0, -90);
-    path.lineTo(bottomLeft.x() + m_bottomRedius, bottomLeft.y());
-    path.arcTo(bottomLeft.x(), bottomLeft.y() - 2 * m_bottomRedius, 2 * m_bottomRedius, 2 * m_bottomRedius, 270, -90);
-    path.lineTo(topLeft.x(), topLeft.y() - m_topRedius);
-    path.arcTo(topLeft.x(), topLeft.y(), 2 * m_topRedius, 2 * m_topRedius, 180, -90);
-    painter.drawPath(path);
+
+    // 圆角背景预先绘制好,这里只拉伸贴图
+    CardBackgroundCache::ref().draw(&painter, rect(), m_topRedius, m_bottomRedius, brushColor, devicePixelRatioF());
 }
 
 BubbleItem::BubbleItem(QWidget *parent, EntityPtr entity)
@@ -135,13 +117,11 @@ void BubbleItem::initUI()
     m_appTimeLabel->setForegroundRole(QPalette::BrightText);
     m_appTimeLabel->setAlignment(Qt::AlignRight | Qt::AlignVCenter);
     m_actionButton->setSizePolicy(QSizePolicy::Expanding, QSizePolicy::Expanding);
-    DFontSizeManager::instance()->bind(m_appNameLabel, DFontSizeManager::T8);
-    DFontSizeManager::instance()->bind(m_appTimeLabel, DFontSizeManager::T8);
 
     setAlpha(Notify::BubbleDefaultAlpha);
     titleLayout->addWidget(m_closeButton);
     m_titleWidget->setLayout(titleLayout);
-    m_titleWidget->setFixedHeight(qMax(m_appNameLabel->fontMetrics().height(), BubbleItemTitleHeight));
+    m_titleWidget->setFixedHeight(qMax(NotifyStyle::ref().current()->captionHeight, BubbleItemTitleHeight));
     mainLayout->addWidget(m_titleWidget);
     m_body->setStyle(OSD::BUBBLEWIDGET);
     m_body->setObjectName("notification_body");
@@ -172,9 +152,13 @@ void BubbleItem::initContent()
 {
     if (m_entity == nullptr) return;
 
-    m_body->setTitle(m_entity->summary());
+    m_body->setTitle(BubbleTool::displaySummary(m_entity));
     m_body->setText(OSD::removeHTML(m_entity->body()));
     m_appNameLabel->setText(BubbleTool::getDeepinAppName(m_entity->appName()));
+    // 应用索引构建完成之前显示的是通知中的应用名称,完成后重新获取
+    connect(DesktopEntryIndex::instance(), &DesktopEntryIndex::updated, m_appNameLabel, [ this ] {
+        m_appNameLabel->setText(BubbleTool::getDeepinAppName(m_entity->appName()));
+    });
     onRefreshTime();
 
     connect(m_actionButton, &ActionButton::buttonClicked, this, [ = ](const QString & id) {
@@ -184,8 +168,9 @@ void BubbleItem::initContent()
     });
     connect(this, &BubbleItem::havorStateChanged, this, &BubbleItem::onHavorStateChanged);
     connect(m_closeButton, &DIconButton::clicked, this, &BubbleItem::onCloseBubble);
-    connect(DGuiApplicationHelper::instance(), &DGuiApplicationHelper::themeTypeChanged, this, &BubbleItem::refreshTheme);
-    refreshTheme();
+    NotifyStyle::ref().subscribe(this, [this](const NotifyStylePtr &style) {
+        refreshTheme(style);
+    });
 }
 
 void BubbleItem::setAlpha(int alpha)
@@ -198,14 +183,21 @@ void BubbleItem::setAlpha(int alpha)
 
 void BubbleItem::onRefreshTime()
 {
-    qint64 msec = QDateTime::currentMSecsSinceEpoch() - m_entity->ctime().toLongLong();
+    const QString &text = timeText(m_entity->ctime().toLongLong());
+    if (!text.isEmpty())
+        m_appTimeLabel->setText(text);
+}
+
+QString BubbleItem::timeText(qint64 ctime)
+{
+    qint64 msec = QDateTime::currentMSecsSinceEpoch() - ctime;
     if (msec < 0) {
-        return;
+        return QString();
     }
 
     QString text;
 
-    QDateTime bubbleDateTime = QDateTime::fromMSecsSinceEpoch(m_entity->ctime().toLongLong());
+    QDateTime bubbleDateTime = QDateTime::fromMSecsSinceEpoch(ctime);
     QDateTime currentDateTime = QDateTime::currentDateTime();
     int elapsedDay = int(bubbleDateTime.daysTo(currentDateTime));
     int minute = int(msec / 1000 / 60);
@@ -225,7 +217,7 @@ void BubbleItem::onRefreshTime()
     } else {
         text = bubbleDateTime.toString("yyyy/MM/dd");
     }
-    m_appTimeLabel->setText(text);
+    return text;
 }
 
 void BubbleItem::setOverlapWidget(bool isOverlap)
@@ -334,6 +326,7 @@ void BubbleItem::onHavorStateChanged(bool hover)
 
 void BubbleItem::onCloseBubble()
 {
+    m_view->finishAnimation();
     m_view->createRemoveAnimation(this);
     Q_EMIT bubbleRemove();
 }
@@ -354,12 +347,21 @@ void BubbleItem::setParentModel(NotifyModel *model)
 void BubbleItem::setParentView(NotifyListView *view)
 {
     m_view = view;
-    connect(m_view, &NotifyListView::refreshItemTime, this, &BubbleItem::onRefreshTime);
+    // 只在时间文本需要变化时刷新
+    if (m_timeHandle == 0) {
+        m_timeHandle = RelativeTimeScheduler::ref().add(m_entity->ctime().toLongLong(), this, [ this ] {
+            onRefreshTime();
+        });
+    }
 }
 
-void BubbleItem::refreshTheme()
+void BubbleItem::refreshTheme(const NotifyStylePtr &style)
 {
     m_appNameLabel->setForegroundRole(QPalette::BrightText);
+    m_appNameLabel->setFont(style->captionFont);
+    m_appTimeLabel->setFont(style->captionFont);
+    m_titleWidget->setFixedHeight(qMax(style->captionHeight, BubbleItemTitleHeight));
+    setFixedHeight(bubbleItemHeight());
 }
 
 QList<QPointer<QWidget>> BubbleItem::bubbleElements()
@@ -386,7 +388,7 @@ void BubbleItem::setHasFocus(bool focus)
 int BubbleItem::bubbleItemHeight()
 {
     int appBodyHeight = qMax(AppBody::bubbleWidgetAppBodyHeight(), BubbleItemBodyHeight);
-    int bubbleTitleHeight = qMax(QFontMetrics(DFontSizeManager::instance()->t8()).height(), BubbleItemTitleHeight);
+    int bubbleTitleHeight = qMax(NotifyStyle::ref().current()->captionHeight, BubbleItemTitleHeight);
 
     return appBodyHeight + bubbleTitleHeight;
 }
@@ -11,6 +11,7 @@
 #include <QDBusArgument>
 
 #include "notification/constants.h"
+#include "notification/notifystyle.h"
 
 class NotificationEntity;
 class NotifyModel;
@@ -82,6 +83,8 @@ public:
     // 通知列表在显示之前会获取所有item的sizeHint，bubbleItem中的控件字体有一些是不一样的，大小也不同
     // 所以需要根据实际的情况去获取每个控件的在当前字体字号情况下的高度，求和组成BubbleItem的高度
     static int bubbleItemHeight();
+    // 通知时间的显示文本,如“刚刚”、“5分钟前”,时间在未来时返回空字符串
+    static QString timeText(qint64 ctime);
 
 Q_SIGNALS:
     void havorStateChanged(bool);
@@ -106,7 +109,7 @@ protected:
 private:
     void initUI();          //初始化UI界面
     void initContent();     //初始化信号槽连接
-    void refreshTheme();    //刷新主题
+    void refreshTheme(const NotifyStylePtr &style);    //刷新主题和字体
 
 private:
     EntityPtr m_entity;
@@ -131,6 +134,7 @@ private:
     QPoint m_pressPoint;
     bool m_isOverlapWidget = false;
     QString m_actionId;
+    quint64 m_timeHandle = 0;
 };
 
 #endif // BUBBLEITEM_H
@@ -5,12 +5,13 @@
 #include "bubbletitlewidget.h"
 #include "notification/bubbletool.h"
 #include "notifylistview.h"
+#include "notification/notifystyle.h"
+#include "desktopentryindex.h"
 
 #include <QKeyEvent>
 #include <QBoxLayout>
 #include <QScroller>
 
-#include <DFontSizeManager>
 #include <DSysInfo>
 
 BubbleTitleWidget::BubbleTitleWidget(NotifyModel *model, EntityPtr entity, QWidget *parent)
@@ -22,13 +23,15 @@ BubbleTitleWidget::BubbleTitleWidget(NotifyModel *model, EntityPtr entity, QWidg
     m_titleLabel = new DLabel;
     m_titleLabel->setForegroundRole(QPalette::BrightText);
     m_titleLabel->setAlignment(Qt::AlignLeft | Qt::AlignVCenter);
-
-    QFont font = m_titleLabel->font();
-    font.setBold(true);
-    font.setWeight(QFont::DemiBold);
-    m_titleLabel->setFont(font);
     m_titleLabel->setText(BubbleTool::getDeepinAppName(entity->appName()));
-    DFontSizeManager::instance()->bind(m_titleLabel, DFontSizeManager::T4);
+    // 应用索引构建完成之前显示的是通知中的应用名称,完成后重新获取
+    const QString appName = entity->appName();
+    connect(DesktopEntryIndex::instance(), &DesktopEntryIndex::updated, m_titleLabel, [ this, appName ] {
+        m_titleLabel->setText(BubbleTool::getDeepinAppName(appName));
+    });
+    NotifyStyle::ref().subscribe(m_titleLabel, [this](const NotifyStylePtr &style) {
+        m_titleLabel->setFont(style->groupTitleFont);
+    });
 
     m_closeButton = new DIconButton(DStyle::SP_CloseButton);
     m_closeButton->setObjectName(entity->appName() + "-CloseButton");
@@ -111,5 +114,5 @@ void BubbleTitleWidget::setParentView(NotifyListView *view)
 
 int BubbleTitleWidget::bubbleTitleWidgetHeight()
 {
-    return qMax(QFontMetrics(DFontSizeManager::instance()->t4()).height(), BubbleTitleHeight);
+    return qMax(NotifyStyle::ref().current()->groupTitleHeight, BubbleTitleHeight);
 }
@@ -0,0 +1,81 @@
+// SPDX-FileCopyrightText: 2024 UnionTech Software Technology Co., Ltd.
+//
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+#include "cardbackgroundcache.h"
+#include "notification/notifystyle.h"
+
+#include <QPainter>
+#include <QPainterPath>
+#include <qdrawutil.h>
+
+// 卡片的圆角和颜色只有几种组合,缓存数量很小
+static const int CardBackgroundCacheSize = 32;
+
+CardBackgroundCache::CardBackgroundCache(QObject *parent)
+    : QObject(parent)
+    , m_cache(CardBackgroundCacheSize)
+{
+    connect(&NotifyStyle::ref(), &NotifyStyle::styleChanged, this, &CardBackgroundCache::clear);
+}
+
+void CardBackgroundCache::draw(QPainter *painter, const QRect &rect, int topRadius, int bottomRadius, const QColor &color, qreal pixelRatio)
+{
+    if (rect.isEmpty() || color.alpha() == 0)
+        return;
+
+    // 没有圆角时直接填充
+    if (topRadius <= 0 && bottomRadius <= 0) {
+        painter->fillRect(rect, color);
+        return;
+    }
+
+    const int side = qMax(topRadius, bottomRadius);
+    const QMargins margins(side, qMax(0, topRadius), side, qMax(0, bottomRadius));
+    qDrawBorderPixmap(painter, rect, margins, tile(topRadius, bottomRadius, color, pixelRatio));
+}
+
+QPixmap CardBackgroundCache::tile(int topRadius, int bottomRadius, const QColor &color, qreal pixelRatio)
+{
+    const QString key = QString("%1|%2|%3|%4").arg(topRadius).arg(bottomRadius).arg(color.rgba()).arg(pixelRatio);
+    if (QPixmap *cached = m_cache.object(key))
+        return *cached;
+
+    const QPixmap &pixmap = renderTile(topRadius, bottomRadius, color, pixelRatio);
+    m_cache.insert(key, new QPixmap(pixmap));
+    return pixmap;
+}
+
+QPixmap CardBackgroundCache::renderTile(int topRadius, int bottomRadius, const QColor &color, qreal pixelRatio)
+{
+    const int top = qMax(0, topRadius);
+    const int bottom = qMax(0, bottomRadius);
+    const int side = qMax(top, bottom);
+    const QSize size(side * 2 + 1, top + bottom + 1);
+
+    QPixmap pixmap(size * pixelRatio);
+    pixmap.setDevicePixelRatio(pixelRatio);
+    pixmap.fill(Qt::transparent);
+
+    // 和原来 AlphaWidget 绘制的路径一致: 上边两个角半径为 top,下边两个角半径为 bottom
+    const QRectF rect(QPointF(0, 0), size);
+    QPainterPath path;
+    path.moveTo(rect.left() + top, rect.top());
+    path.lineTo(rect.right() - top, rect.top());
+    path.arcTo(rect.right() - 2 * top, rect.top(), 2 * top, 2 * top, 90, -90);
+    path.lineTo(rect.right(), rect.bottom() - bottom);
+    path.arcTo(rect.right() - 2 * bottom, rect.bottom() - 2 * bottom, 2 * bottom, 2 * bottom, 0, -90);
+    path.lineTo(rect.left() + bottom, rect.bottom());
+    path.arcTo(rect.left(), rect.bottom() - 2 * bottom, 2 * bottom, 2 * bottom, 270, -90);
+    path.lineTo(rect.left(), rect.top() + top);
+    path.arcTo(rect.left(), rect.top(), 2 * top, 2 * top, 180, -90);
+    path.closeSubpath();
+
+    QPainter painter(&pixmap);
+    painter.setRenderHint(QPainter::Antialiasing);
+    painter.setPen(Qt::NoPen);
+    painter.setBrush(color);
+    painter.drawPath(path);
+
+    return pixmap;
+}
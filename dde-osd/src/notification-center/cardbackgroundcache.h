@@ -0,0 +1,49 @@
+// SPDX-FileCopyrightText: 2024 UnionTech Software Technology Co., Ltd.
+//
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+#ifndef CARDBACKGROUNDCACHE_H
+#define CARDBACKGROUNDCACHE_H
+
+#include <QObject>
+#include <QCache>
+#include <QPixmap>
+#include <DSingleton>
+
+class QPainter;
+
+/*!
+ * \~chinese \class CardBackgroundCache
+ * \~chinese \brief 通知中心卡片背景的九宫格缓存,以(上圆角, 下圆角, 颜色, 缩放比)为键预先绘制带抗锯齿圆角的小图,
+ * \~chinese 绘制时按九宫格拉伸到卡片大小,滚动和悬停时不再重新光栅化圆角路径;主题变化时清空
+ */
+class CardBackgroundCache : public QObject, public Dtk::Core::DSingleton<CardBackgroundCache>
+{
+    Q_OBJECT
+    friend class Dtk::Core::DSingleton<CardBackgroundCache>;
+
+public:
+    /*!
+     * \~chinese \name draw
+     * \~chinese \brief 在 rect 中绘制卡片背景,color 带有透明度
+     */
+    void draw(QPainter *painter, const QRect &rect, int topRadius, int bottomRadius, const QColor &color, qreal pixelRatio);
+    /*!
+     * \~chinese \name tile
+     * \~chinese \brief 九宫格的原图,四角是圆角,中间一个像素用于拉伸
+     */
+    QPixmap tile(int topRadius, int bottomRadius, const QColor &color, qreal pixelRatio);
+
+    void clear() { m_cache.clear(); }
+    int count() const { return m_cache.count(); }
+
+private:
+    explicit CardBackgroundCache(QObject *parent = nullptr);
+
+    static QPixmap renderTile(int topRadius, int bottomRadius, const QColor &color, qreal pixelRatio);
+
+private:
+    QCache<QString, QPixmap> m_cache;
+};
+
+#endif // CARDBACKGROUNDCACHE_H
@@ -0,0 +1,128 @@
+// SPDX-FileCopyrightText: 2024 UnionTech Software Technology Co., Ltd.
+//
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+#include "expiryscheduler.h"
+
+#include <QTimer>
+#include <QDateTime>
+
+#include <algorithm>
+
+// 单次等待的上限,系统休眠或者修改时间之后最晚在这个时间内纠正
+static const qint64 MaxWakeupInterval = 60 * 60 * 1000;
+
+ExpiryScheduler::ExpiryScheduler(qint64 lifetime, QObject *parent)
+    : QObject(parent)
+    , m_lifetime(lifetime)
+    , m_timer(new QTimer(this))
+{
+    m_timer->setSingleShot(true);
+    connect(m_timer, &QTimer::timeout, this, &ExpiryScheduler::onTimeout);
+}
+
+void ExpiryScheduler::add(uint id, qint64 ctime)
+{
+    const qint64 deadline = ctime + m_lifetime;
+    auto it = m_deadlines.find(id);
+    if (it != m_deadlines.end() && it.value() == deadline)
+        return;
+
+    m_deadlines.insert(id, deadline);
+    m_heap.append({deadline, id});
+    std::push_heap(m_heap.begin(), m_heap.end(), &ExpiryScheduler::laterThan);
+
+    // 更新到期时间后堆顶可能是旧条目
+    dropStale();
+    compact();
+    arm();
+}
+
+void ExpiryScheduler::remove(uint id)
+{
+    if (m_deadlines.remove(id) == 0)
+        return;
+
+    dropStale();
+    compact();
+    arm();
+}
+
+void ExpiryScheduler::clear()
+{
+    m_heap.clear();
+    m_deadlines.clear();
+    m_timer->stop();
+}
+
+qint64 ExpiryScheduler::nextExpiry() const
+{
+    // 堆顶总是有效的条目
+    return m_heap.isEmpty() ? -1 : m_heap.first().time;
+}
+
+QList<uint> ExpiryScheduler::takeExpired(qint64 now)
+{
+    QList<uint> ids;
+    while (!m_heap.isEmpty() && m_heap.first().time <= now) {
+        ids.append(m_heap.first().id);
+        m_deadlines.remove(m_heap.first().id);
+        std::pop_heap(m_heap.begin(), m_heap.end(), &ExpiryScheduler::laterThan);
+        m_heap.removeLast();
+        dropStale();
+    }
+
+    arm();
+    return ids;
+}
+
+bool ExpiryScheduler::laterThan(const Deadline &d1, const Deadline &d2)
+{
+    // std 的堆是最大堆,比较时反过来得到最小堆
+    return d1.time > d2.time;
+}
+
+void ExpiryScheduler::onTimeout()
+{
+    const QList<uint> ids = takeExpired(QDateTime::currentMSecsSinceEpoch());
+    if (!ids.isEmpty())
+        Q_EMIT expired(ids);
+}
+
+void ExpiryScheduler::arm()
+{
+    const qint64 deadline = nextExpiry();
+    if (deadline < 0) {
+        m_timer->stop();
+        return;
+    }
+
+    const qint64 interval = qBound<qint64>(0, deadline - QDateTime::currentMSecsSinceEpoch(), MaxWakeupInterval);
+    m_timer->start(int(interval));
+}
+
+void ExpiryScheduler::dropStale()
+{
+    while (!m_heap.isEmpty()) {
+        const Deadline &top = m_heap.first();
+        auto it = m_deadlines.constFind(top.id);
+        if (it != m_deadlines.constEnd() && it.value() == top.time)
+            break;
+
+        std::pop_heap(m_heap.begin(), m_heap.end(), &ExpiryScheduler::laterThan);
+        m_heap.removeLast();
+    }
+}
+
+void ExpiryScheduler::compact()
+{
+    if (m_heap.size() <= 2 * m_deadlines.size() + 16)
+        return;
+
+    m_heap.clear();
+    m_heap.reserve(m_deadlines.size());
+    for (auto it = m_deadlines.constBegin(); it != m_deadlines.constEnd(); ++it) {
+        m_heap.append({it.value(), it.key()});
+    }
+    std::make_heap(m_heap.begin(), m_heap.end(), &ExpiryScheduler::laterThan);
+}
@@ -0,0 +1,65 @@
+// SPDX-FileCopyrightText: 2024 UnionTech Software Technology Co., Ltd.
+//
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+#ifndef EXPIRYSCHEDULER_H
+#define EXPIRYSCHEDULER_H
+
+#include <QObject>
+#include <QHash>
+#include <QVector>
+
+class QTimer;
+
+/*!
+ * \~chinese \class ExpiryScheduler
+ * \~chinese \brief 通知保留期限的调度,按到期时间维护一个最小堆,只为最早到期的通知启动一个单次定时器.
+ * \~chinese 添加和删除的代价是对数时间,没有通知到期之前不会做任何检查.
+ */
+class ExpiryScheduler : public QObject
+{
+    Q_OBJECT
+public:
+    /*!
+     * \~chinese \name ExpiryScheduler
+     * \~chinese \param lifetime 通知的保留时间(毫秒),到期时间为通知的创建时间加上保留时间
+     */
+    explicit ExpiryScheduler(qint64 lifetime, QObject *parent = nullptr);
+
+    void add(uint id, qint64 ctime);            // 添加或者更新一条通知
+    void remove(uint id);
+    void clear();
+    bool contains(uint id) const { return m_deadlines.contains(id); }
+    int count() const { return m_deadlines.size(); }
+    qint64 lifetime() const { return m_lifetime; }
+    qint64 nextExpiry() const;                  // 最早的到期时间,没有通知时返回-1
+
+    /*!
+     * \~chinese \name takeExpired
+     * \~chinese \brief 取出在 now 之前到期的通知,返回的通知不再调度
+     */
+    QList<uint> takeExpired(qint64 now);
+
+Q_SIGNALS:
+    void expired(const QList<uint> &ids);       // 定时器到期时发送,包含所有已经到期的通知
+
+private:
+    void onTimeout();
+    void arm();                                 // 按堆顶的到期时间启动定时器
+    void dropStale();                           // 丢掉堆顶已经删除或者更新过的旧条目
+    void compact();                             // 旧条目过多时按有效的条目重建堆
+
+private:
+    struct Deadline {
+        qint64 time;
+        uint id;
+    };
+    static bool laterThan(const Deadline &d1, const Deadline &d2);
+
+    qint64 m_lifetime;
+    QVector<Deadline> m_heap;                   // 删除时不从堆中移除,旧条目按 m_deadlines 判断
+    QHash<uint, qint64> m_deadlines;            // 每条通知当前有效的到期时间
+    QTimer *m_timer;
+};
+
+#endif // EXPIRYSCHEDULER_H
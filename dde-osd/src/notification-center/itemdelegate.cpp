@@ -6,16 +6,45 @@
 #include "bubbletitlewidget.h"
 #include "bubbleitem.h"
 #include "../notification/constants.h"
+#include "../notification/bubbletool.h"
+#include "../notification/textelider.h"
+#include "../notification/notifystyle.h"
 #include "overlapwidet.h"
 #include "notifylistview.h"
+#include "cardbackgroundcache.h"
+#include "desktopentryindex.h"
 
 #include <QDebug>
+#include <QPainter>
+
+#include <DGuiApplicationHelper>
+#include <DPalette>
+
+DGUI_USE_NAMESPACE
+DWIDGET_USE_NAMESPACE
+
+static const int LayoutCacheSize = 64;     // 缓存的行数,大于一屏可以显示的行数即可
 
 ItemDelegate::ItemDelegate(NotifyListView *view, NotifyModel *model, QObject *parent)
     : QStyledItemDelegate(parent)
     , m_model(model)
     , m_view(view)
+    , m_layouts(LayoutCacheSize)
 {
+    if (m_model != nullptr) {
+        connect(m_model, &NotifyModel::rowsAboutToBeRemoved, this, [ this ](const QModelIndex &, int first, int last) {
+            removeLayouts(first, last);
+        });
+        connect(m_model, &NotifyModel::modelReset, this, &ItemDelegate::clearLayouts);
+    }
+    // 主题或者字体变化后省略的文字和图标都要重新计算
+    connect(&NotifyStyle::ref(), &NotifyStyle::styleChanged, this, &ItemDelegate::clearLayouts);
+    // 应用索引构建完成之前显示的是通知中的应用名称,完成后重新获取
+    connect(DesktopEntryIndex::instance(), &DesktopEntryIndex::updated, this, [ this ] {
+        clearLayouts();
+        if (m_view != nullptr)
+            m_view->viewport()->update();
+    });
 }
 
 QWidget *ItemDelegate::createEditor(QWidget *parent, const QStyleOptionViewItem &option, const QModelIndex &index) const
@@ -48,10 +77,18 @@ QSize ItemDelegate::sizeHint(const QStyleOptionViewItem &option, const QModelInd
 {
     Q_UNUSED(option);
 
-    EntityPtr notify = index.data().value<EntityPtr>();
     QSize bubbleSize(BubbleItemWidth, BubbleItem::bubbleItemHeight() + BubbleSpacing);
 
-    if(notify && notify->isTitle())
+    // 每次布局和绘制都会调用,直接读取模型中的行
+    EntityPtr notify;
+    if (m_model != nullptr && index.model() == m_model && index.row() < m_model->rowCount(QModelIndex()))
+        notify = m_model->rowAt(index.row()).entity;
+    else
+        notify = index.data().value<EntityPtr>();
+    if (!notify)
+        return bubbleSize;
+
+    if(notify->isTitle())
         bubbleSize = QSize(BubbleTitleWidth, BubbleTitleWidget::bubbleTitleWidgetHeight());
     else if(notify->hideCount() != 0)
         bubbleSize = bubbleSize + QSize(0,notify->hideCount()*10);
@@ -67,3 +104,174 @@ void ItemDelegate::updateEditorGeometry(QWidget *editor, const QStyleOptionViewI
     QSize size = sizeHint(option, index);
     editor->setGeometry(rect.x(), rect.y(), size.width(), size.height() - BubbleSpacing);
 }
+
+void ItemDelegate::paint(QPainter *painter, const QStyleOptionViewItem &option, const QModelIndex &index) const
+{
+    if (m_view == nullptr || !m_view->paintedRows())
+        return QStyledItemDelegate::paint(painter, option, index);
+
+    // 已经打开编辑控件的行由控件自己绘制
+    if (m_view->indexWidget(index) != nullptr)
+        return;
+
+    EntityPtr notify = index.data().value<EntityPtr>();
+    if (!notify)
+        return;
+
+    // 和 updateEditorGeometry 中编辑控件的位置保持一致
+    const QSize size = sizeHint(option, index);
+    const QRect rect(option.rect.topLeft(), QSize(size.width(), size.height() - BubbleSpacing));
+
+    painter->save();
+    painter->setRenderHint(QPainter::Antialiasing);
+    if (notify->isTitle()) {
+        paintTitle(painter, rect, notify);
+    } else {
+        const QRect bubbleRect(rect.topLeft(), QSize(rect.width(), BubbleItem::bubbleItemHeight()));
+        if (notify->hideCount() != 0)
+            paintOverlap(painter, bubbleRect, notify->hideCount());
+        paintBubble(painter, bubbleRect, notify);
+    }
+    painter->restore();
+}
+
+const ItemDelegate::RowLayout *ItemDelegate::rowLayout(EntityPtr entity) const
+{
+    RowLayout *layout = m_layouts.object(entity.get());
+    if (layout != nullptr)
+        return layout;
+
+    layout = new RowLayout;
+    layout->entity = entity;
+    layout->appName = BubbleTool::getDeepinAppName(entity->appName());
+    if (!entity->isTitle()) {
+        const int textWidth = BubbleItemWidth - 20;
+        layout->ctime = entity->ctime().toLongLong();
+        layout->timeText = BubbleItem::timeText(layout->ctime);
+        const NotificationEntity *key = entity.get();
+        layout->timeHandle = RelativeTimeScheduler::ref().add(layout->ctime, m_view, [ this, key ] {
+            RowLayout *cached = m_layouts.object(key);
+            if (cached == nullptr)
+                return;
+            cached->timeText = BubbleItem::timeText(cached->ctime);
+            if (m_view->paintedRows())
+                m_view->viewport()->update();
+        });
+        const NotifyStylePtr &style = NotifyStyle::ref().current();
+        layout->title = QFontMetrics(style->summaryFont)
+                .elidedText(BubbleTool::displaySummary(entity), Qt::ElideRight, textWidth);
+        // 正文可能很长,只排版第一行能显示的部分
+        layout->body = TextElider::ref().elide(OSD::removeHTML(entity->body()), style->bodyFont, QSize(textWidth, style->bodyHeight));
+        layout->icon = BubbleTool::iconPixmap(entity, OSD::IconSize(OSD::BUBBLEWIDGET), m_view->devicePixelRatioF());
+    }
+    m_layouts.insert(entity.get(), layout);
+    return layout;
+}
+
+void ItemDelegate::paintTitle(QPainter *painter, const QRect &rect, EntityPtr entity) const
+{
+    const RowLayout *layout = rowLayout(entity);
+    const DPalette &pa = DGuiApplicationHelper::instance()->applicationPalette();
+
+    // 和 BubbleTitleWidget 的标题保持一致,右侧留出关闭按钮的位置
+    painter->setFont(NotifyStyle::ref().current()->groupTitleFont);
+    painter->setPen(pa.color(QPalette::BrightText));
+
+    const QRect textRect = rect.adjusted(10, 0, -Notify::GroupButtonSize, 0);
+    const QString &text = painter->fontMetrics().elidedText(layout->appName, Qt::ElideRight, textRect.width());
+    painter->drawText(textRect, Qt::AlignLeft | Qt::AlignVCenter, text);
+}
+
+void ItemDelegate::paintBubble(QPainter *painter, const QRect &rect, EntityPtr entity) const
+{
+    const RowLayout *layout = rowLayout(entity);
+    const DPalette &pa = DGuiApplicationHelper::instance()->applicationPalette();
+    const NotifyStylePtr &style = NotifyStyle::ref().current();
+    const int radius = 8;
+    const int titleHeight = qMax(style->captionHeight, BubbleItemTitleHeight);
+
+    // 背景和标题栏,透明度和未悬停时的 BubbleItem 一致
+    const qreal pixelRatio = painter->device()->devicePixelRatioF();
+    QColor brushColor = pa.color(QPalette::Base);
+    brushColor.setAlpha(Notify::BubbleDefaultAlpha * 3);
+    CardBackgroundCache::ref().draw(painter, rect, radius, radius, brushColor, pixelRatio);
+
+    const QRect titleRect(rect.topLeft(), QSize(rect.width(), titleHeight));
+    brushColor.setAlpha(Notify::BubbleDefaultAlpha);
+    CardBackgroundCache::ref().draw(painter, titleRect, radius, 0, brushColor, pixelRatio);
+
+    // 标题栏: 图标、应用名称、时间
+    const QSize iconSize = OSD::IconSize(OSD::BUBBLEWIDGET);
+    const QRect iconRect(QPoint(titleRect.x() + 10, titleRect.y() + (titleHeight - iconSize.height()) / 2), iconSize);
+    painter->drawPixmap(iconRect, layout->icon);
+
+    painter->setFont(style->captionFont);
+    const int timeWidth = painter->fontMetrics().horizontalAdvance(layout->timeText);
+    const QRect timeRect(titleRect.right() - 10 - timeWidth, titleRect.y(), timeWidth, titleHeight);
+    const QRect nameRect(iconRect.right() + 10, titleRect.y(), timeRect.left() - 10 - iconRect.right() - 10, titleHeight);
+
+    painter->setPen(pa.color(DPalette::TextTitle));
+    painter->drawText(nameRect, Qt::AlignLeft | Qt::AlignVCenter,
+                      painter->fontMetrics().elidedText(layout->appName, Qt::ElideRight, nameRect.width()));
+    painter->setPen(pa.color(QPalette::BrightText));
+    painter->setOpacity(0.6);
+    painter->drawText(timeRect, Qt::AlignRight | Qt::AlignVCenter, layout->timeText);
+    painter->setOpacity(1.0);
+
+    // 内容: 标题和正文在内容区域中垂直居中
+    const QRect bodyRect = QRect(rect.x(), titleRect.bottom() + 1, rect.width(), rect.bottom() - titleRect.bottom())
+            .adjusted(10, BubbleAppBodyPaddingTop, -10, -BubbleAppBodyPaddingBottom);
+    const int titleLineHeight = layout->title.isEmpty() ? 0 : style->summaryHeight;
+    const int bodyLineHeight = layout->body.isEmpty() ? 0 : style->bodyHeight;
+    int y = bodyRect.y() + (bodyRect.height() - titleLineHeight - bodyLineHeight) / 2;
+
+    if (titleLineHeight != 0) {
+        painter->setFont(style->summaryFont);
+        painter->drawText(QRect(bodyRect.x(), y, bodyRect.width(), titleLineHeight), Qt::AlignLeft | Qt::AlignVCenter, layout->title);
+        y += titleLineHeight;
+    }
+    if (bodyLineHeight != 0) {
+        painter->setFont(style->bodyFont);
+        painter->setOpacity(Notify::BubbleOpacity);
+        painter->drawText(QRect(bodyRect.x(), y, bodyRect.width(), bodyLineHeight), Qt::AlignLeft | Qt::AlignVCenter, layout->body);
+        painter->setOpacity(1.0);
+    }
+}
+
+void ItemDelegate::paintOverlap(QPainter *painter, const QRect &rect, int hideCount) const
+{
+    // 和 OverLapWidet 中 HalfRoundedRectWidget 的大小和位置保持一致
+    const DPalette &pa = DGuiApplicationHelper::instance()->applicationPalette();
+    QColor brushColor = pa.color(QPalette::Base);
+    brushColor.setAlpha(Notify::BubbleDefaultAlpha * 2);
+
+    const int radius = 6;
+    qreal scalRatio = 1;
+    int height = BubbleOverLapHeight;
+    int y = rect.bottom() + 1;
+    for (int i = 0; i < qMin(3, hideCount); ++i) {
+        scalRatio = (scalRatio * 19) / 20;
+        height -= 2;
+        const int width = int(rect.width() * scalRatio);
+        const QRect card(rect.x() + (rect.width() - width) / 2, y, width, height);
+        y += height;
+
+        CardBackgroundCache::ref().draw(painter, card, 0, radius, brushColor, painter->device()->devicePixelRatioF());
+    }
+}
+
+void ItemDelegate::removeLayouts(int first, int last)
+{
+    for (int row = first; row <= last; ++row) {
+        EntityPtr entity = m_model->index(row).data().value<EntityPtr>();
+        if (entity)
+            m_layouts.remove(entity.get());
+    }
+}
+
+void ItemDelegate::clearLayouts()
+{
+    m_layouts.clear();
+    if (m_view != nullptr && m_view->paintedRows())
+        m_view->viewport()->update();
+}
@@ -6,8 +6,11 @@
 #define ItemDelegate_H
 
 #include "notifymodel.h"
+#include "relativetimescheduler.h"
 
 #include <QStyledItemDelegate>
+#include <QCache>
+#include <QPixmap>
 
 class NotifyListView;
 
@@ -21,10 +24,42 @@ public:
     QWidget *createEditor(QWidget *parent, const QStyleOptionViewItem &option, const QModelIndex &index) const override;
     QSize sizeHint(const QStyleOptionViewItem &option, const QModelIndex &index) const override;
     void updateEditorGeometry(QWidget *editor, const QStyleOptionViewItem &option, const QModelIndex &index) const override;
+    /*!
+     * \~chinese \name paint
+     * \~chinese \brief 绘制模式下没有编辑控件的行由这里直接绘制,外观和 BubbleItem、BubbleTitleWidget、OverLapWidet 一致,
+     * \~chinese 按钮等交互控件只在鼠标悬停或者键盘焦点所在行的编辑控件上出现
+     */
+    void paint(QPainter *painter, const QStyleOptionViewItem &option, const QModelIndex &index) const override;
+
+    int layoutCacheCount() const { return m_layouts.count(); }
+
+private:
+    // 绘制一行需要的数据,文字已经按当前字体省略好
+    struct RowLayout {
+        ~RowLayout() { RelativeTimeScheduler::ref().remove(timeHandle); }
+
+        EntityPtr entity;           // 持有作为键的通知,缓存项存在期间这个地址不会被新的通知复用
+        QString appName;
+        qint64 ctime = 0;           // 标题行为0
+        QString timeText;
+        quint64 timeHandle = 0;     // 时间文本的刷新
+        QString title;
+        QString body;
+        QPixmap icon;
+    };
+
+    const RowLayout *rowLayout(EntityPtr entity) const;
+    void paintTitle(QPainter *painter, const QRect &rect, EntityPtr entity) const;
+    void paintBubble(QPainter *painter, const QRect &rect, EntityPtr entity) const;
+    void paintOverlap(QPainter *painter, const QRect &rect, int hideCount) const;
+    void removeLayouts(int first, int last);
+    void clearLayouts();
 
 private:
     NotifyModel *m_model;
     NotifyListView *m_view;
+    // 只缓存最近绘制过的行,数量和视图中可见的行数相关,和通知总数无关
+    mutable QCache<const NotificationEntity *, RowLayout> m_layouts;
 };
 
 #endif // ItemDelegate_H
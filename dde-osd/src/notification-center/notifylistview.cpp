@@ -9,9 +9,9 @@
 #include "bubbletitlewidget.h"
 #include "notification/iconbutton.h"
 #include "notification/button.h"
+#include "relativetimescheduler.h"
+#include "snapshotanimator.h"
 
-#include <QParallelAnimationGroup>
-#include <QSequentialAnimationGroup>
 #include <QPropertyAnimation>
 #include <QDebug>
 #include <QTimer>
@@ -21,25 +21,21 @@
 #include <QScrollBar>
 #include <QScroller>
 #include <QTimer>
-
-#define RefreshTime 900
+#include <QApplication>
 
 NotifyListView::NotifyListView(QWidget *parent)
     : DListView(parent)
     , m_scrollAni(new QPropertyAnimation(verticalScrollBar(), "value" ,this))
-    , m_refreshTimer(new QTimer(this))
+    , m_snapshotAnimator(new SnapshotAnimator(viewport()))
 {
-    qApp->installEventFilter(this);
     this->setAccessibleName("List_Notifications");
     m_scrollAni->setEasingCurve(QEasingCurve::OutQuint);
     m_scrollAni->setDuration(800);
 
-    m_refreshTimer->setInterval(RefreshTime);
-
     setVerticalScrollMode(QAbstractItemView::ScrollPerPixel);
-    connect(m_refreshTimer, &QTimer::timeout, this, &NotifyListView::refreshItemTime);
     connect(m_scrollAni, &QPropertyAnimation::valueChanged, this, &NotifyListView::handleScrollValueChanged);
     connect(m_scrollAni, &QPropertyAnimation::finished, this, &NotifyListView::handleScrollFinished);
+    connect(this, &NotifyListView::entered, this, &NotifyListView::setHoverIndex);
 
     QScroller::grabGesture(this, QScroller::LeftMouseButtonGesture);
     QScroller *scroller = QScroller::scroller(this);
@@ -52,19 +48,22 @@ NotifyListView::~NotifyListView()
 {
 }
 
+void NotifyListView::finishAnimation()
+{
+    m_snapshotAnimator->finish();
+}
+
 void NotifyListView::createRemoveAnimation(BubbleItem *item)
 {
-    QParallelAnimationGroup *removeAniGroup = new QParallelAnimationGroup(this);
-    connect(removeAniGroup, &QParallelAnimationGroup::finished, this, [ = ] {
-        m_aniState = false;
-        Q_EMIT removeAniFinished(item->getEntity());
-    });
+    m_snapshotAnimator->finish();
 
-    QPropertyAnimation *rightMoveAni = new QPropertyAnimation(item, "pos", this);
-    rightMoveAni->setStartValue(item->pos());
-    rightMoveAni->setEndValue(item->pos() + QPoint(OSD::BubbleWidth(OSD::ShowStyle::BUBBLEWIDGET), 0));
-    rightMoveAni->setDuration(AnimationTime);
-    removeAniGroup->addAnimation(rightMoveAni);
+    // 上一个动画结束时这一行可能已经被移除
+    const QModelIndex &itemIndex = model()->index(item->indexRow(), 0);
+    if (!itemIndex.isValid() || itemIndex.data().value<EntityPtr>() != item->getEntity())
+        return;
+
+    const QRect itemRect = m_snapshotAnimator->widgetRect(item);
+    m_snapshotAnimator->addWidget(item, itemRect.translated(OSD::BubbleWidth(OSD::ShowStyle::BUBBLEWIDGET), 0), AnimationTime);
 
     const int bubbleItemHeight = BubbleItem::bubbleItemHeight();
 
@@ -84,15 +83,16 @@ void NotifyListView::createRemoveAnimation(BubbleItem *item)
         if (!widget) {
             break;
         }
-        QPropertyAnimation *topMoveAni = new QPropertyAnimation(widget, "pos", this);
-        topMoveAni->setStartValue(widget->pos());
-        topMoveAni->setEndValue(widget->pos() + QPoint(0, moveValue));
-        topMoveAni->setDuration(AnimationTime);
-        removeAniGroup->addAnimation(topMoveAni);
+        const QRect &rect = m_snapshotAnimator->widgetRect(widget);
+        m_snapshotAnimator->addWidget(widget, rect.translated(0, moveValue), AnimationTime);
     }
 
-    removeAniGroup->start(QPropertyAnimation::DeleteWhenStopped);
+    EntityPtr entity = item->getEntity();
     m_aniState = true;
+    m_snapshotAnimator->start([ = ] {
+        m_aniState = false;
+        Q_EMIT removeAniFinished(entity);
+    });
 }
 
 void NotifyListView::createExpandAnimation(int idx, const ListItem appItem)
@@ -103,36 +103,22 @@ void NotifyListView::createExpandAnimation(int idx, const ListItem appItem)
     if (!currentWidget)
         return;
 
-    QSequentialAnimationGroup *insertAniGroup = new QSequentialAnimationGroup(this);    // 逐个插入的串行动画
-    QParallelAnimationGroup *downMoveAniGroup = new QParallelAnimationGroup(this);      // 整体向下移动的动画
-
-    connect(insertAniGroup, &QParallelAnimationGroup::finished, this, [ = ] {
-        m_aniState = false;
-        Q_EMIT expandAniFinished(appItem.appName);
-    });
+    m_snapshotAnimator->finish();
 
-    QPoint startPos = currentWidget->pos();
+    const QPoint startPos = m_snapshotAnimator->widgetRect(currentWidget).topLeft();
     const int bubbleItemHight = BubbleItem::bubbleItemHeight();
     int maxCount = (height() - startPos.y()) / (bubbleItemHight + BubbleSpacing);
     int needCount = appItem.hideList.size() > maxCount ? maxCount : appItem.hideList.size();
 
+    // 展开的通知逐个插入,每条通知只创建一次控件用于截图
+    const QSize itemSize(currentWidget->width(), bubbleItemHight);
     for (int i = 0; i < needCount; i++) {
-        BubbleItem *item = new BubbleItem(this, appItem.hideList[i]);
-        item->setAccessibleName("BubbleItem");
-        QPoint itemStartPos = startPos + QPoint(0, (bubbleItemHight + BubbleSpacing) * i);
-        QPoint itemEndPos = itemStartPos + QPoint(0, bubbleItemHight + BubbleSpacing);
-        QPropertyAnimation *ani = new QPropertyAnimation(item, "pos", this);
-        connect(ani, &QPropertyAnimation::stateChanged, item, [ = ] (QAbstractAnimation::State newState, QAbstractAnimation::State oldState) {
-            if (newState == QAbstractAnimation::Running && oldState == QAbstractAnimation::Stopped) {
-                item->move(startPos);
-                item->show();
-            }
-        });
-        connect(insertAniGroup, &QParallelAnimationGroup::finished, item, &BubbleItem::deleteLater);
-        ani->setStartValue(itemStartPos);
-        ani->setEndValue(itemEndPos);
-        ani->setDuration(ExpandAnimationTime);
-        insertAniGroup->addAnimation(ani);
+        BubbleItem item(viewport(), std::make_shared<NotificationEntity>(appItem.hideList[i]));
+        item.hide();
+        const QPixmap &pixmap = SnapshotAnimator::snapshot(&item, itemSize);
+        const QRect itemStartRect(startPos + QPoint(0, (bubbleItemHight + BubbleSpacing) * i), itemSize);
+        const QRect itemEndRect = itemStartRect.translated(0, bubbleItemHight + BubbleSpacing);
+        m_snapshotAnimator->addPixmap(pixmap, itemStartRect, itemEndRect, ExpandAnimationTime, ExpandAnimationTime * i);
     }
 
     QPoint offsetPos = QPoint(0, (bubbleItemHight + BubbleSpacing) * needCount - 22);
@@ -142,15 +128,15 @@ void NotifyListView::createExpandAnimation(int idx, const ListItem appItem)
         if (!moveDownWidget) {
             break;
         }
-        QPropertyAnimation *ani = new QPropertyAnimation(moveDownWidget, "pos", this);
-        ani->setStartValue(moveDownWidget->pos());
-        ani->setEndValue(moveDownWidget->pos() + offsetPos);
-        ani->setDuration(ExpandAnimationTime * needCount);
-        downMoveAniGroup->addAnimation(ani);
+        const QRect &rect = m_snapshotAnimator->widgetRect(moveDownWidget);
+        m_snapshotAnimator->addWidget(moveDownWidget, rect.translated(offsetPos), ExpandAnimationTime * needCount);
     }
-    insertAniGroup->start(QPropertyAnimation::DeleteWhenStopped);
-    downMoveAniGroup->start(QPropertyAnimation::DeleteWhenStopped);
+
     m_aniState = true;
+    m_snapshotAnimator->start([ = ] {
+        m_aniState = false;
+        Q_EMIT expandAniFinished(appItem.appName);
+    });
 }
 
 void NotifyListView::createAddedAnimation(EntityPtr entity, const ListItem appItem)
@@ -160,28 +146,18 @@ void NotifyListView::createAddedAnimation(EntityPtr entity, const ListItem appIt
     if (!currentWidget)
         return;
 
-    QParallelAnimationGroup *addedAniGroup = new QParallelAnimationGroup(this);
-    connect(addedAniGroup, &QParallelAnimationGroup::finished, this, [ = ] { //动画完成发出动画完成的信号
-        m_aniState = false;
-        Q_EMIT addedAniFinished(entity);
-    });
+    m_snapshotAnimator->finish();
 
-    QPoint startPos = currentWidget->pos();    //动画基准位置
+    const QPoint startPos = m_snapshotAnimator->widgetRect(currentWidget).topLeft();    //动画基准位置
     const int bubbleItemHight = BubbleItem::bubbleItemHeight();
 
-    BubbleItem *newItem = new BubbleItem(this, entity);
-    newItem->setAccessibleName("BubbleItem");
-    newItem->show();
+    // 新通知从高度为0展开
+    BubbleItem newItem(viewport(), entity);
+    newItem.hide();
+    const QPixmap &pixmap = SnapshotAnimator::snapshot(&newItem, currentWidget->size());
     QRect startRect = QRect(startPos, QSize(currentWidget->width(), 0));
     QRect endRect = QRect(startPos, QSize(currentWidget->width(), currentWidget->height()));
-    QPropertyAnimation *addAni = new QPropertyAnimation(newItem, "geometry", this);
-    connect(addAni, &QPropertyAnimation::finished, newItem, [ = ] {
-        newItem->deleteLater();
-    });
-    addAni->setStartValue(startRect);
-    addAni->setEndValue(endRect);
-    addAni->setDuration(AnimationTime);
-    addedAniGroup->addAnimation(addAni);
+    m_snapshotAnimator->addPixmap(pixmap, startRect, endRect, AnimationTime);
 
     if (appItem.showList.size() != 3 && canShow(appItem.showList.last())) {
         for (int i = 1; i < this->model()->rowCount(QModelIndex()); ++i) {
@@ -189,11 +165,8 @@ void NotifyListView::createAddedAnimation(EntityPtr entity, const ListItem appIt
             if (!widget) {
                 break;
             }
-            QPropertyAnimation *downMoveAni = new QPropertyAnimation(widget, "pos", this);
-            downMoveAni->setStartValue(widget->pos());
-            downMoveAni->setEndValue(widget->pos() + QPoint(0, bubbleItemHight + BubbleSpacing));
-            downMoveAni->setDuration(AnimationTime);
-            addedAniGroup->addAnimation(downMoveAni);
+            const QRect &rect = m_snapshotAnimator->widgetRect(widget);
+            m_snapshotAnimator->addWidget(widget, rect.translated(0, bubbleItemHight + BubbleSpacing), AnimationTime);
         }
     } else {
         for (int i = 0; i < appItem.showList.size(); i++) {
@@ -201,11 +174,11 @@ void NotifyListView::createAddedAnimation(EntityPtr entity, const ListItem appIt
                 break;
             }
             QWidget *widget = this->indexWidget(this->model()->index(1 + i, 0));
-            QPropertyAnimation *downMoveAni = new QPropertyAnimation(widget, "pos", this);
-            downMoveAni->setStartValue(widget->pos());
-            downMoveAni->setEndValue(widget->pos() + QPoint(0, bubbleItemHight + BubbleSpacing));
-            downMoveAni->setDuration(AnimationTime);
-            addedAniGroup->addAnimation(downMoveAni);
+            if (!widget) {
+                break;
+            }
+            const QRect &rect = m_snapshotAnimator->widgetRect(widget);
+            m_snapshotAnimator->addWidget(widget, rect.translated(0, bubbleItemHight + BubbleSpacing), AnimationTime);
         }
         QWidget *lastWidget = this->indexWidget(this->model()->index(appItem.showList.size(), 0));
         OverLapWidet *overLapWidget = qobject_cast<OverLapWidet *> (lastWidget);
@@ -216,21 +189,51 @@ void NotifyListView::createAddedAnimation(EntityPtr entity, const ListItem appIt
             faceWidget = qobject_cast<BubbleItem *> (lastWidget);
         }
 
-        QRect startRect1 = QRect(faceWidget->pos(), faceWidget->size());
-        QRect endRect1 = QRect(startRect1.x(), startRect1.y() + bubbleItemHight, startRect.width(), 0);
-        QPropertyAnimation *removeAni = new QPropertyAnimation(faceWidget, "geometry", this);
-        removeAni->setStartValue(startRect1);
-        removeAni->setEndValue(endRect1);
-        removeAni->setDuration(AnimationTime);
-        addedAniGroup->addAnimation(removeAni);
+        // 被挤出显示列表的通知向下收起
+        if (faceWidget != nullptr) {
+            QRect startRect1 = m_snapshotAnimator->widgetRect(faceWidget);
+            QRect endRect1 = QRect(startRect1.x(), startRect1.y() + bubbleItemHight, startRect.width(), 0);
+            m_snapshotAnimator->addWidget(faceWidget, endRect1, AnimationTime);
+        }
     }
-    addedAniGroup->start(QPropertyAnimation::DeleteWhenStopped);
+
     m_aniState = true;
+    m_snapshotAnimator->start([ = ] {
+        m_aniState = false;
+        Q_EMIT addedAniFinished(entity);
+    });
 }
 
 void NotifyListView::setCurrentRow(int row)
 {
     m_currentIndex = row;
+    if (m_paintedRows && model() != nullptr) {
+        m_focusIndex = model()->index(row, 0);
+        updateActiveEditors();
+    }
+}
+
+void NotifyListView::setPaintedRows(bool painted)
+{
+    if (m_paintedRows == painted)
+        return;
+
+    m_paintedRows = painted;
+    m_hoverIndex = QPersistentModelIndex();
+    m_focusIndex = QPersistentModelIndex();
+    m_editorIndexes.clear();
+
+    if (model() != nullptr) {
+        for (int i = 0; i < model()->rowCount(); ++i) {
+            const QModelIndex &index = model()->index(i, 0);
+            if (painted) {
+                closePersistentEditor(index);
+            } else {
+                openPersistentEditor(index);
+            }
+        }
+    }
+    viewport()->update();
 }
 
 void NotifyListView::mousePressEvent(QMouseEvent *event)
@@ -244,7 +247,7 @@ void NotifyListView::keyPressEvent(QKeyEvent *event)
 {
     if (event->key() == Qt::Key_Return || event->key() == Qt::Key_Enter) {
         QModelIndex index = this->model()->index(m_currentIndex, 0);
-        QWidget *widget = this->indexWidget(index);
+        QWidget *widget = rowWidget(index);
 
         if (qobject_cast<DIconButton *> (m_prevElement) != nullptr) {
             DIconButton *itemCloseBtn = qobject_cast<DIconButton *> (m_prevElement);
@@ -292,7 +295,8 @@ bool NotifyListView::eventFilter(QObject *object, QEvent *event)
 
 void NotifyListView::showEvent(QShowEvent *event)
 {
-    m_refreshTimer->start();
+    RelativeTimeScheduler::ref().setSuspended(false);
+    setInputFilterEnabled(true);
 
     return QListView::showEvent(event);
 }
@@ -303,11 +307,46 @@ void NotifyListView::hideEvent(QHideEvent *event)
     m_currentElement = nullptr;
     m_prevElement = nullptr;
     verticalScrollBar()->setValue(0);
-    m_refreshTimer->stop();
+    RelativeTimeScheduler::ref().setSuspended(true);
+    setInputFilterEnabled(false);
+    m_hoverIndex = QPersistentModelIndex();
+    m_focusIndex = QPersistentModelIndex();
+    updateActiveEditors();
 
     return QListView::hideEvent(event);
 }
 
+void NotifyListView::setInputFilterEnabled(bool enabled)
+{
+    if (enabled) {
+        installEventFilter(this);
+        viewport()->installEventFilter(this);
+        connect(qApp, &QApplication::focusChanged, this, &NotifyListView::onFocusChanged, Qt::UniqueConnection);
+        onFocusChanged(nullptr, QApplication::focusWidget());
+    } else {
+        disconnect(qApp, &QApplication::focusChanged, this, &NotifyListView::onFocusChanged);
+        onFocusChanged(nullptr, nullptr);
+        viewport()->removeEventFilter(this);
+        removeEventFilter(this);
+    }
+}
+
+void NotifyListView::onFocusChanged(QWidget *old, QWidget *now)
+{
+    Q_UNUSED(old)
+    // 焦点在通知中心窗口之外时不需要过滤,列表和 viewport 上的过滤器一直保留到隐藏
+    if (now == this || now == viewport() || (now != nullptr && now != window() && !window()->isAncestorOf(now)))
+        now = nullptr;
+    if (m_focusFilterWidget == now)
+        return;
+
+    if (!m_focusFilterWidget.isNull())
+        m_focusFilterWidget->removeEventFilter(this);
+    m_focusFilterWidget = now;
+    if (now != nullptr)
+        now->installEventFilter(this);
+}
+
 bool NotifyListView::tabKeyEvent(QObject *object, QKeyEvent *event)
 {
     Q_UNUSED(object)
@@ -318,7 +357,7 @@ bool NotifyListView::tabKeyEvent(QObject *object, QKeyEvent *event)
         return true;
     }
     QModelIndex index = this->model()->index(m_currentIndex, 0);
-    QWidget *widget = this->indexWidget(index);
+    QWidget *widget = rowWidget(index);
     scrollTo(index);
     if (widget == nullptr)
         return true;
@@ -328,7 +367,7 @@ bool NotifyListView::tabKeyEvent(QObject *object, QKeyEvent *event)
     if (qobject_cast<BubbleTitleWidget *> (widget) != nullptr) {
         m_currentIndex ++;
         index = this->model()->index(m_currentIndex, 0);
-        widget = this->indexWidget(index);
+        widget = rowWidget(index);
     }
     setCurrentIndex(index);
     m_prevElement = nullptr;
@@ -377,9 +416,20 @@ void NotifyListView::wheelEvent(QWheelEvent *event)
     return QWidget::wheelEvent(event);
 }
 
+void NotifyListView::leaveEvent(QEvent *event)
+{
+    setHoverIndex(QModelIndex());
+    return DListView::leaveEvent(event);
+}
+
 bool NotifyListView::canShow(EntityPtr ptr)
 {
-    QDateTime t = QDateTime::fromMSecsSinceEpoch(ptr->ctime().toLongLong());
+    return canShow(ptr->record());
+}
+
+bool NotifyListView::canShow(const NotificationRecord &record)
+{
+    QDateTime t = QDateTime::fromMSecsSinceEpoch(record.ctime());
     return t.secsTo(QDateTime::currentDateTime()) < OVERLAPTIMEOUT_4_HOUR;
 }
 
@@ -402,3 +452,45 @@ void NotifyListView::handleScrollFinished()
     QPoint pos = mapFromGlobal(QCursor::pos());
     emit entered(indexAt(pos));
 }
+
+QWidget *NotifyListView::rowWidget(const QModelIndex &index)
+{
+    if (m_paintedRows && index.isValid()) {
+        m_focusIndex = index;
+        updateActiveEditors();
+    }
+    return indexWidget(index);
+}
+
+void NotifyListView::setHoverIndex(const QModelIndex &index)
+{
+    if (!m_paintedRows || m_hoverIndex == index)
+        return;
+
+    m_hoverIndex = index;
+    updateActiveEditors();
+}
+
+void NotifyListView::updateActiveEditors()
+{
+    // 动画过程中持有编辑控件的指针,不能关闭,动画结束后随下一次悬停变化更新
+    if (!m_paintedRows || m_aniState || model() == nullptr)
+        return;
+
+    QList<QPersistentModelIndex> activeIndexes;
+    for (const QPersistentModelIndex &index : {m_hoverIndex, m_focusIndex}) {
+        if (index.isValid() && !activeIndexes.contains(index))
+            activeIndexes << index;
+    }
+
+    // 行被删除后 QPersistentModelIndex 会失效,对应的编辑控件已经被视图销毁
+    for (const QPersistentModelIndex &index : m_editorIndexes) {
+        if (index.isValid() && !activeIndexes.contains(index))
+            closePersistentEditor(index);
+    }
+    for (const QPersistentModelIndex &index : activeIndexes) {
+        if (!m_editorIndexes.contains(index) || indexWidget(index) == nullptr)
+            openPersistentEditor(index);
+    }
+    m_editorIndexes = activeIndexes;
+}
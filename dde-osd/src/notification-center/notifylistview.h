@@ -16,6 +16,7 @@ class QPropertyAnimation;
 class QScrollBar;
 class QTimer;
 class BubbleItem;
+class SnapshotAnimator;
 
 DWIDGET_USE_NAMESPACE
 
@@ -30,8 +31,21 @@ public:
     void createAddedAnimation(EntityPtr entity, const ListItem appItem);
     void createRemoveAnimation(BubbleItem *item);
     void createExpandAnimation(int idx, const ListItem appItem);
+    /*!
+     * \~chinese \name finishAnimation
+     * \~chinese \brief 立即结束正在进行的动画,结束时的回调会修改模型的行,
+     * \~chinese 所以要在计算新动画的行号和分组数据之前调用
+     */
+    void finishAnimation();
     bool aniState() { return m_aniState; }
     void setCurrentRow(int row);
+    /*!
+     * \~chinese \name setPaintedRows
+     * \~chinese \brief 设置绘制模式,绘制模式下行由 ItemDelegate::paint 直接绘制,
+     * \~chinese 只有鼠标悬停的行和键盘焦点所在的行会创建编辑控件,控件数量不随通知数量增长
+     */
+    void setPaintedRows(bool painted);
+    bool paintedRows() const { return m_paintedRows; }
 
 protected:
     void mousePressEvent(QMouseEvent *event) override;
@@ -41,17 +55,28 @@ protected:
     void hideEvent(QHideEvent *event) override;
     bool tabKeyEvent(QObject *object, QKeyEvent *event);   //处理键盘TAB键按下的事件,QListView过滤了TAB按键事件
     void wheelEvent(QWheelEvent *event) override;
+    void leaveEvent(QEvent *event) override;
 
 private:
     bool canShow(EntityPtr ptr); // 判断消息是否应该层叠[即超过4小时]
+    bool canShow(const NotificationRecord &record);
     void handleScrollValueChanged();
     void handleScrollFinished();
+    QWidget *rowWidget(const QModelIndex &index);           // 获取行的编辑控件,绘制模式下会先为这一行创建控件
+    void setHoverIndex(const QModelIndex &index);
+    void updateActiveEditors();                             // 绘制模式下只保留悬停行和焦点行的编辑控件
+    /*!
+     * \~chinese \name setInputFilterEnabled
+     * \~chinese \brief 显示时在列表、viewport 和窗口中的焦点控件上安装事件过滤器,隐藏时全部移除,
+     * \~chinese 进程中其他窗口的事件不经过列表的过滤
+     */
+    void setInputFilterEnabled(bool enabled);
+    void onFocusChanged(QWidget *old, QWidget *now);        // 事件过滤器跟随窗口中的焦点控件移动
 
 signals:
     void removeAniFinished(EntityPtr ptr);
     void expandAniFinished(QString appName);
     void addedAniFinished(EntityPtr entity);
-    void refreshItemTime();
     void focusOnButton();
 
 private:
@@ -59,9 +84,14 @@ private:
     int m_currentIndex = 0;
     double m_speedTime = 2.0;
     QPropertyAnimation *m_scrollAni;
+    SnapshotAnimator *m_snapshotAnimator;                   // 插入、删除和展开的截图动画
     QPointer<QWidget> m_prevElement = nullptr;
     QPointer<QWidget> m_currentElement = nullptr;
-    QTimer *m_refreshTimer = nullptr;
+    bool m_paintedRows = false;
+    QPersistentModelIndex m_hoverIndex;
+    QPersistentModelIndex m_focusIndex;
+    QList<QPersistentModelIndex> m_editorIndexes;           // 绘制模式下已经打开编辑控件的行
+    QPointer<QWidget> m_focusFilterWidget;                  // 当前安装了事件过滤器的焦点控件
 };
 
 #endif // NOTIFYLISTVIEW_H
@@ -5,16 +5,28 @@
 #include "notifymodel.h"
 #include "../notification/persistence.h"
 #include "notifylistview.h"
+#include "expiryscheduler.h"
+#include "../notification/notificationentity.h"
 
 #include <QDebug>
 #include <QDateTime>
 #include <QTimer>
+#include <QSet>
+
+#include <algorithm>
+#include <functional>
+
+static uint qHash(const NotifyRow &row, uint seed = 0)
+{
+    return qHash(row.appName, seed) ^ qHash(row.entity.get(), seed) ^ uint(row.hideCount);
+}
 
 NotifyModel::NotifyModel(QObject *parent, AbstractPersistence *database, NotifyListView *view)
     : QAbstractListModel(parent)
     , m_view(view)
     , m_database(static_cast<Persistence *>(database))
     , m_freeTimer(new QTimer(this))
+    , m_expiry(new ExpiryScheduler(qint64(OVERLAPTIMEOUT_7_DAY) * 1000, this))
 {
     m_freeTimer->setInterval(AnimationTime + 100);
     initData();
@@ -24,22 +36,16 @@ NotifyModel::NotifyModel(QObject *parent, AbstractPersistence *database, NotifyL
 ListItem NotifyModel::getAppData(QString appName) const
 {
 
-    foreach (auto item, m_notifications) {
-        if (item.appName == appName)
-            return item;
-    }
+    const auto it = m_groupOrders.constFind(appName);
+    if (it != m_groupOrders.constEnd())
+        return m_notifications.value(it.value());
     Q_UNREACHABLE();
 }
 
 int NotifyModel::rowCount(const QModelIndex &parent) const
 {
     Q_UNUSED(parent)
-    int count = 0;
-    foreach (auto item, m_notifications) {
-        count += item.showList.size();
-    }
-    count += m_notifications.size();
-    return count;
+    return m_rows.size();
 }
 
 QVariant NotifyModel::data(const QModelIndex &index, int role) const
@@ -62,17 +68,41 @@ QVariant NotifyModel::data(const QModelIndex &index, int role) const
 Qt::ItemFlags NotifyModel::flags(const QModelIndex &index) const
 {
     if (index.isValid()) {
-        if (m_view != nullptr) m_view->openPersistentEditor(index);
+        // 绘制模式下编辑控件由视图按悬停和焦点按需创建
+        if (m_view != nullptr && !m_view->paintedRows()) m_view->openPersistentEditor(index);
         return QAbstractListModel::flags(index) | Qt::ItemIsEditable;
     }
     return QAbstractListModel::flags(index);
 }
 
+bool NotifyModel::canFetchMore(const QModelIndex &parent) const
+{
+    if (parent.isValid() || m_notifications.isEmpty())
+        return false;
+
+    // 只有最后一组的末尾是列表的末尾,滚动到底部时继续显示这一组更早的通知
+    const ListItem &item = m_notifications.last();
+    return item.expanded && !item.hideList.isEmpty();
+}
+
+void NotifyModel::fetchMore(const QModelIndex &parent)
+{
+    if (!canFetchMore(parent))
+        return;
+
+    ListItem &item = m_notifications.last();
+    const QString appName = item.appName;
+    expandPage(item);
+    evictPages(appName);
+    updateRows();
+}
+
 void NotifyModel::addNotify(EntityPtr entity)
 {
-    beginResetModel();
     addAppData(entity);
-    endResetModel();
+    if (ListItem *group = findGroup(entity->appName()))
+        group->storedCount++;
+    updateRows();
 }
 
 void NotifyModel::removeNotify(EntityPtr entity)
@@ -80,34 +110,34 @@ void NotifyModel::removeNotify(EntityPtr entity)
     if (m_notifications.isEmpty())
         return;
 
-    beginResetModel();
-    for (int i = 0; i < m_notifications.size(); i++) {
-        ListItem &AppGroup = m_notifications[i];
-        if (AppGroup.appName == entity->appName()
-                && AppGroup.showList.contains(entity)) {
-            AppGroup.showList.removeOne(entity);
-
-            if (AppGroup.showList.isEmpty() || (!AppGroup.hideList.isEmpty()
-                    && !checkTimeOut(AppGroup.hideList.first(), OVERLAPTIMEOUT_4_HOUR))) {
-                if (!AppGroup.showList.isEmpty()){
-                    AppGroup.showList.last()->setHideCount(0);
-                }
-                if (!AppGroup.hideList.isEmpty()) {
-                    AppGroup.showList.push_back(AppGroup.hideList.first());
-                    AppGroup.hideList.pop_front();
-                }
-                if (!AppGroup.showList.isEmpty()) {
-                    AppGroup.showList.last()->setHideCount(AppGroup.hideList.size() > 2 ? 2 : AppGroup.hideList.size());
-                }
+    ListItem *group = findGroup(entity->appName());
+    if (group != nullptr && group->showList.contains(entity)) {
+        ListItem &AppGroup = *group;
+        // 隐藏列表用完时先加载下一页,删除之后可能已经没有可以作为游标的通知
+        if (AppGroup.hideList.isEmpty() && loadedCount(AppGroup) < AppGroup.storedCount)
+            loadPage(AppGroup);
+        AppGroup.showList.removeOne(entity);
+        AppGroup.storedCount--;
+
+        if (AppGroup.showList.isEmpty() || (!AppGroup.hideList.isEmpty()
+                && !checkTimeOut(AppGroup.hideList.first(), OVERLAPTIMEOUT_4_HOUR))) {
+            if (!AppGroup.showList.isEmpty()){
+                AppGroup.showList.last()->setHideCount(0);
             }
-            if (AppGroup.showList.isEmpty()) {
-                m_notifications.removeAt(i);
-                break;
+            if (!AppGroup.hideList.isEmpty()) {
+                AppGroup.showList.push_back(std::make_shared<NotificationEntity>(AppGroup.hideList.first()));
+                AppGroup.hideList.pop_front();
+            }
+            if (!AppGroup.showList.isEmpty()) {
+                AppGroup.showList.last()->setHideCount(AppGroup.hideList.size() > 2 ? 2 : AppGroup.hideList.size());
             }
         }
-
+        if (AppGroup.showList.isEmpty()) {
+            removeGroup(entity->appName());
+        }
     }
-    endResetModel();
+    updateRows();
+    m_expiry->remove(entity->id());
 
     if (m_database != nullptr) {
         m_database->removeOne(QString::number(entity->id()));
@@ -115,107 +145,96 @@ void NotifyModel::removeNotify(EntityPtr entity)
     Q_EMIT removedNotif();
 }
 
+void NotifyModel::updateNotify(EntityPtr entity)
+{
+    const uint id = entity->storageId().toUInt();
+    ListItem *group = findGroup(entity->appName());
+    if (group == nullptr || id == 0)
+        return;
+
+    ListItem &AppGroup = *group;
+    NotificationRecord record;
+    bool found = false;
+    for (int i = 0; i < AppGroup.showList.size() && !found; ++i) {
+        if (AppGroup.showList.at(i)->id() == id) {
+            record = AppGroup.showList.takeAt(i)->record();
+            found = true;
+        }
+    }
+    for (int i = 0; i < AppGroup.hideList.size() && !found; ++i) {
+        if (AppGroup.hideList.at(i).id() == id) {
+            record = AppGroup.hideList.takeAt(i);
+            found = true;
+        }
+    }
+    // 还没有加载的分页在加载时会读到更新后的数据
+    if (!found)
+        return;
+
+    // 作为新的一行显示在分组最前面,编辑控件和绘制缓存都会重新创建
+    EntityPtr updated = std::make_shared<NotificationEntity>(record);
+    updated->setRepeatCount(entity->repeatCount());
+    updated->setTime(entity->ctime());
+    AppGroup.showList.push_front(updated);
+    if (!AppGroup.expanded && AppGroup.showList.size() > 3)
+        AppGroup.hideList.push_front(AppGroup.showList.takeLast()->record());
+    for (EntityPtr item : AppGroup.showList)
+        item->setHideCount(0);
+    if (!AppGroup.expanded)
+        AppGroup.showList.last()->setHideCount(qMin(AppGroup.hideList.size(), 2));
+    AppGroup.lastTimeStamp = qMax(AppGroup.lastTimeStamp, updated->record().ctime());
+    m_expiry->add(id, updated->record().ctime());
+
+    touchGroup(entity->appName());
+    updateRows();
+}
+
 void NotifyModel::removeAppGroup(QString appName)
 {
-    beginResetModel();
     if (m_notifications.isEmpty())
         return;
-    for (int i = 0; i < m_notifications.size(); i++) {
-        if (m_notifications[i].appName == appName) {
-            m_notifications.removeAt(i);
-        }
+    if (ListItem *group = findGroup(appName)) {
+        for (const EntityPtr &entity : group->showList)
+            m_expiry->remove(entity->id());
+        for (const NotificationRecord &record : group->hideList)
+            m_expiry->remove(record.id());
+        removeGroup(appName);
     }
-    endResetModel();
+    updateRows();
     m_database->removeApp(appName);
 }
 
 void NotifyModel::removeAllData()
 {
-    beginResetModel();
     m_notifications.clear();
-    endResetModel();
+    m_groupOrders.clear();
+    m_expiry->clear();
+    updateRows();
     m_database->removeAll();
 }
 
 void NotifyModel::expandData(QString appName)
 {
-    beginResetModel();
-    for (int i = 0; i < m_notifications.size(); i++) {
-        ListItem &AppGroup = m_notifications[i];
-        if (AppGroup.appName == appName) {
-            AppGroup.showList.last()->setHideCount(0);
-            AppGroup.showList.append(AppGroup.hideList);
-            AppGroup.hideList.clear();
-        }
-    }
-    endResetModel();
+    ListItem *group = findGroup(appName);
+    if (group == nullptr)
+        return;
+
+    expandPage(*group);
+    evictPages(appName);
+    updateRows();
 }
 
 void NotifyModel::collapseData()
 {
-    beginResetModel();
-    for (int i = 0; i < m_notifications.size(); i++) {
-        ListItem &AppGroup = m_notifications[i];
-        int collapseRow;
-        for(collapseRow = 0; collapseRow < AppGroup.showList.size(); collapseRow ++) {
-            if (checkTimeOut(AppGroup.showList[collapseRow], OVERLAPTIMEOUT_4_HOUR) || collapseRow >= 3) {
-                break;
-            }
-        }
-        if (collapseRow == 0) {
-            collapseRow = 1;
-        }
-
-        if (AppGroup.showList.size() == collapseRow) {
-            continue;
-        }
-        QList<EntityPtr> showList = AppGroup.showList.mid(0, collapseRow);
-        QList<EntityPtr> hideList = AppGroup.showList.mid(collapseRow,  AppGroup.showList.size() - collapseRow);
-        AppGroup.showList = showList;
-        AppGroup.hideList = hideList;
+    for (ListItem &item : m_notifications) {
+        collapseGroup(item);
     }
-    endResetModel();
+    updateRows();
 }
 
 void NotifyModel::removeTimeOutNotify()
 {
-    for (int i = 0; i < m_notifications.size(); i++) {
-        ListItem &AppGroup = m_notifications[i];
-        QList<EntityPtr> notifyList;
-        if (checkTimeOut(AppGroup.showList.last(), OVERLAPTIMEOUT_7_DAY)) {
-            beginResetModel();
-            for (int j = 0; j < AppGroup.hideList.size(); j++) {
-                m_database->removeOne(QString::number(AppGroup.hideList[j]->id()));
-            }
-            for (int j = 0; j < AppGroup.showList.size(); j++) {
-                if(checkTimeOut(AppGroup.showList[j], OVERLAPTIMEOUT_7_DAY)) {
-                    m_database->removeOne(QString::number(AppGroup.showList[j]->id()));
-                } else {
-                    notifyList.append(AppGroup.showList[j]);
-                }
-            }
-            AppGroup.hideList = notifyList;
-            if (notifyList.isEmpty()) {
-                m_notifications.removeAt(i);
-            }
-            endResetModel();
-            return;
-        } else {
-            for (int j = 0; j < AppGroup.hideList.size(); j++) {
-                if(checkTimeOut(AppGroup.hideList[j], OVERLAPTIMEOUT_7_DAY)) {
-                    m_database->removeOne(QString::number(AppGroup.hideList[j]->id()));
-                } else {
-                    notifyList.append(AppGroup.hideList[j]);
-                }
-            }
-
-            if (AppGroup.hideList.size() != notifyList.size()) {
-                beginResetModel();
-                AppGroup.hideList = notifyList;
-                endResetModel();
-            }
-        }
-    }
+    removeExpired(m_expiry->takeExpired(QDateTime::currentMSecsSinceEpoch()));
 }
 
 void NotifyModel::cacheData(EntityPtr entity)
@@ -232,7 +251,10 @@ void NotifyModel::cacheData(EntityPtr entity)
 
 void NotifyModel::freeData()
 {
-    if (!m_notifications.isEmpty() && m_notifications.first().appName == m_cacheList.first()->appName()) {
+    // 上一个动画结束时会修改分组,之后再判断和获取分组数据
+    m_view->finishAnimation();
+    // 添加动画依赖每一行的编辑控件,绘制模式下直接添加
+    if (!m_view->paintedRows() && !m_notifications.isEmpty() && m_notifications.first().appName == m_cacheList.first()->appName()) {
         m_view->createAddedAnimation(m_cacheList.first(), getAppData(m_cacheList.first()->appName()));
     } else {
         addNotify(m_cacheList.first());
@@ -246,103 +268,428 @@ void NotifyModel::freeData()
 void NotifyModel::initData()
 {
     if (m_database == nullptr)  return;
-    QList<EntityPtr> notifications = m_database->getAllNotify();
 
-    std::sort(notifications.begin(), notifications.end(), [=](const EntityPtr& ptr1,const EntityPtr& ptr2) {
-        return ptr1->ctime().toLongLong() < ptr2->ctime().toLongLong();
-    });
+    // 过期的通知在数据库中一次删除,每个应用只加载最新的一页,更早的在展开或者滚动时再加载
+    m_database->removeBefore(QDateTime::currentMSecsSinceEpoch() - qint64(OVERLAPTIMEOUT_7_DAY) * 1000);
+    for (const NotifyGroupSummary &summary : m_database->getGroupSummaries()) {
+        const QList<NotificationRecord> &records = m_database->getAppNotifyRecords(summary.appName, 0, 0, NOTIFY_PAGE_SIZE);
+        if (records.isEmpty())
+            continue;
 
-    foreach (auto notify, notifications) {
-        if(!checkTimeOut(notify, OVERLAPTIMEOUT_7_DAY)) {
-            addAppData(notify);
-        } else {
-            m_database->removeOne(QString::number(notify->id()));
+        // 按时间从旧到新添加,分组和层叠的规则与新通知到达时一致
+        for (auto it = records.crbegin(); it != records.crend(); ++it) {
+            addAppData(std::make_shared<NotificationEntity>(*it));
         }
+        if (ListItem *group = findGroup(summary.appName))
+            group->storedCount = qMax(summary.count, loadedCount(*group));
     }
-
+    m_rows = buildRows();
+    updateRowIndexes();
 }
 
 void NotifyModel::initConnect()
 {
     connect(m_database, &Persistence::RecordAdded, this, &NotifyModel::cacheData);
+    connect(m_database, &Persistence::RecordUpdated, this, &NotifyModel::updateNotify);
     connect(m_freeTimer, &QTimer::timeout, this, &NotifyModel::freeData);
     connect(m_view, &NotifyListView::addedAniFinished, this, &NotifyModel::addNotify);
     connect(m_view, &NotifyListView::removeAniFinished, this, &NotifyModel::removeNotify);
     connect(m_view, &NotifyListView::expandAniFinished, this, &NotifyModel::expandData);
-    connect(m_view, &NotifyListView::refreshItemTime, this, &NotifyModel::removeTimeOutNotify);
+    connect(m_expiry, &ExpiryScheduler::expired, this, &NotifyModel::removeExpired);
 }
 
 void NotifyModel::addAppData(EntityPtr entity)
 {
-    bool isNewApp = true;
+    m_expiry->add(entity->id(), entity->record().ctime());
+
     bool entityTimeout = checkTimeOut(entity, OVERLAPTIMEOUT_4_HOUR);
-    for (int i = 0; i < m_notifications.size(); i++) {
-        ListItem &AppGroup = m_notifications[i];
-        if (AppGroup.appName == entity->appName()) {
-            isNewApp = false;
-            if (entityTimeout) { //超时通知添加到隐藏列表
-                if (checkTimeOut(AppGroup.showList.last(), OVERLAPTIMEOUT_4_HOUR)) {
-                    AppGroup.showList.push_front(entity);
-                    AppGroup.hideList.push_front(AppGroup.showList.last());
-                    AppGroup.showList.removeLast();
-                }
-            } else if ((!entityTimeout && AppGroup.showList.size() == 3)
-                       || checkTimeOut(AppGroup.showList.first(), OVERLAPTIMEOUT_4_HOUR)) { //通知未超时，显示列表已满
-                AppGroup.showList.last()->setHideCount(0);
+    ListItem *group = findGroup(entity->appName());
+    if (group != nullptr) {
+        ListItem &AppGroup = *group;
+        if (entityTimeout) { //超时通知添加到隐藏列表
+            if (checkTimeOut(AppGroup.showList.last(), OVERLAPTIMEOUT_4_HOUR)) {
                 AppGroup.showList.push_front(entity);
-                AppGroup.hideList.push_front(AppGroup.showList.last());
-                AppGroup.showList.removeLast();
-                AppGroup.lastTimeStamp = entity->ctime();
-            } else {
-                AppGroup.showList.push_front(entity);
-                AppGroup.lastTimeStamp = entity->ctime();
+                AppGroup.hideList.push_front(AppGroup.showList.takeLast()->record());
             }
-            m_notifications.move(i, 0);
+        } else if ((!entityTimeout && AppGroup.showList.size() == 3)
+                   || checkTimeOut(AppGroup.showList.first(), OVERLAPTIMEOUT_4_HOUR)) { //通知未超时，显示列表已满
+            AppGroup.showList.last()->setHideCount(0);
+            AppGroup.showList.push_front(entity);
+            AppGroup.hideList.push_front(AppGroup.showList.takeLast()->record());
+            AppGroup.lastTimeStamp = entity->record().ctime();
+        } else {
+            AppGroup.showList.push_front(entity);
+            AppGroup.lastTimeStamp = entity->record().ctime();
         }
+        // 分组按最后活动时间重新排序,只移动这一个分组
+        touchGroup(entity->appName());
+        return;
     }
 
-    if (isNewApp) {
-        ListItem AppGroup;
-        AppGroup.appName = entity->appName();
-        AppGroup.lastTimeStamp = entity->ctime();
-        AppGroup.showList.push_front(entity);
-        m_notifications.append(AppGroup);
+    ListItem AppGroup;
+    AppGroup.appName = entity->appName();
+    AppGroup.lastTimeStamp = entity->record().ctime();
+    AppGroup.showList.push_front(entity);
+    insertGroup(AppGroup);
+}
+
+void NotifyModel::removeExpired(const QList<uint> &ids)
+{
+    if (ids.isEmpty())
+        return;
+
+    QSet<uint> expired;
+    expired.reserve(ids.size());
+    for (uint id : ids)
+        expired.insert(id);
+
+    bool changed = false;
+    QStringList emptyGroups;
+    for (ListItem &AppGroup : m_notifications) {
+        const int count = loadedCount(AppGroup);
+        AppGroup.showList.erase(std::remove_if(AppGroup.showList.begin(), AppGroup.showList.end(), [&expired](const EntityPtr &entity) {
+            return expired.contains(entity->id());
+        }), AppGroup.showList.end());
+        AppGroup.hideList.erase(std::remove_if(AppGroup.hideList.begin(), AppGroup.hideList.end(), [&expired](const NotificationRecord &record) {
+            return expired.contains(record.id());
+        }), AppGroup.hideList.end());
+        if (loadedCount(AppGroup) == count)
+            continue;
+
+        changed = true;
+        // 未加载的通知比已加载的更早,也都已经过期
+        AppGroup.storedCount = loadedCount(AppGroup);
+        if (AppGroup.showList.isEmpty() && !AppGroup.hideList.isEmpty())
+            AppGroup.showList.append(std::make_shared<NotificationEntity>(AppGroup.hideList.takeFirst()));
+        if (AppGroup.showList.isEmpty())
+            emptyGroups << AppGroup.appName;
     }
+    for (const QString &appName : emptyGroups)
+        removeGroup(appName);
+
+    if (m_database != nullptr)
+        m_database->removeBefore(QDateTime::currentMSecsSinceEpoch() - m_expiry->lifetime());
+    if (changed)
+        updateRows();
+}
+
+ListItem *NotifyModel::findGroup(const QString &appName)
+{
+    const auto it = m_groupOrders.constFind(appName);
+    if (it == m_groupOrders.constEnd())
+        return nullptr;
 
-    std::sort(m_notifications.begin(), m_notifications.end(), [=](const ListItem & item1, const ListItem & item2) {
-        return item1.lastTimeStamp.toLongLong() > item2.lastTimeStamp.toLongLong();
-    });
+    auto group = m_notifications.find(it.value());
+    return group == m_notifications.end() ? nullptr : &group.value();
+}
+
+void NotifyModel::insertGroup(const ListItem &item)
+{
+    GroupOrder order;
+    order.timeStamp = item.lastTimeStamp;
+    order.sequence = ++m_groupSequence;
+    m_groupOrders.insert(item.appName, order);
+    m_notifications.insert(order, item);
+}
+
+void NotifyModel::touchGroup(const QString &appName)
+{
+    auto it = m_groupOrders.find(appName);
+    if (it == m_groupOrders.end())
+        return;
+
+    const ListItem item = m_notifications.take(it.value());
+    it.value().timeStamp = item.lastTimeStamp;
+    it.value().sequence = ++m_groupSequence;
+    m_notifications.insert(it.value(), item);
+}
+
+void NotifyModel::removeGroup(const QString &appName)
+{
+    const GroupOrder order = m_groupOrders.take(appName);
+    m_notifications.remove(order);
+}
+
+int NotifyModel::loadedCount(const ListItem &item)
+{
+    return item.showList.size() + item.hideList.size();
+}
+
+void NotifyModel::loadPage(ListItem &item)
+{
+    if (m_database == nullptr || item.showList.isEmpty())
+        return;
+
+    // 以已加载的最早一条通知为游标
+    const NotificationRecord oldest = item.hideList.isEmpty() ? item.showList.last()->record() : item.hideList.last();
+    const QList<NotificationRecord> &records = m_database->getAppNotifyRecords(item.appName, oldest.ctime(), oldest.id(), NOTIFY_PAGE_SIZE);
+    item.hideList.append(records);
+    for (const NotificationRecord &record : records)
+        m_expiry->add(record.id(), record.ctime());
+
+    // 数据库中的数量和记录的不一致时以实际读到的为准
+    if (records.size() < NOTIFY_PAGE_SIZE)
+        item.storedCount = loadedCount(item);
+}
+
+void NotifyModel::expandPage(ListItem &item)
+{
+    if (item.showList.isEmpty())
+        return;
+
+    item.showList.last()->setHideCount(0);
+    for (const NotificationRecord &record : item.hideList) {
+        item.showList.append(std::make_shared<NotificationEntity>(record));
+    }
+    item.hideList.clear();
+    item.expanded = true;
+
+    // 还有更早的通知时预先加载一页,显示为最后一条通知下面的层叠
+    if (loadedCount(item) < item.storedCount)
+        loadPage(item);
+}
+
+void NotifyModel::collapseGroup(ListItem &item)
+{
+    item.expanded = false;
+
+    int collapseRow;
+    for(collapseRow = 0; collapseRow < item.showList.size(); collapseRow ++) {
+        if (checkTimeOut(item.showList[collapseRow], OVERLAPTIMEOUT_4_HOUR) || collapseRow >= 3) {
+            break;
+        }
+    }
+    if (collapseRow == 0) {
+        collapseRow = 1;
+    }
+
+    if (item.showList.size() != collapseRow) {
+        QList<NotificationRecord> hideList;
+        for (int j = collapseRow; j < item.showList.size(); j++) {
+            hideList.append(item.showList[j]->record());
+        }
+        item.showList = item.showList.mid(0, collapseRow);
+        item.hideList = hideList;
+    }
+
+    // 折叠后只保留一页隐藏通知,其余的在下次展开时重新加载
+    while (item.hideList.size() > NOTIFY_PAGE_SIZE)
+        m_expiry->remove(item.hideList.takeLast().id());
+}
+
+bool NotifyModel::visibleRows(int &firstRow, int &lastRow) const
+{
+    if (m_view == nullptr || !m_view->isVisible() || m_rows.isEmpty())
+        return false;
+
+    // 行从上到下依次排列,二分查找第一个底部在视口内和第一个顶部超出视口的行
+    const QRect viewRect = m_view->viewport()->rect();
+    const auto firstRowWhere = [this](const std::function<bool(const QRect &)> &pred) {
+        int low = 0, high = m_rows.size();
+        while (low < high) {
+            const int mid = (low + high) / 2;
+            if (pred(m_view->visualRect(index(mid))))
+                high = mid;
+            else
+                low = mid + 1;
+        }
+        return low;
+    };
+    firstRow = firstRowWhere([&viewRect](const QRect &rect) { return rect.bottom() >= viewRect.top(); });
+    lastRow = firstRowWhere([&viewRect](const QRect &rect) { return rect.top() > viewRect.bottom(); }) - 1;
+    return firstRow <= lastRow;
+}
+
+bool NotifyModel::groupVisible(const QString &appName, int firstRow, int lastRow) const
+{
+    const auto it = m_groupRows.constFind(appName);
+    if (it == m_groupRows.constEnd())
+        return false;
+
+    return it->first <= lastRow && it->first + it->second - 1 >= firstRow;
+}
+
+void NotifyModel::evictPages(const QString &keepApp)
+{
+    // 分组的行和视图中可见的行都只计算一次,不需要遍历每一组的所有行
+    int firstRow = 0, lastRow = -1;
+    visibleRows(firstRow, lastRow);
+
+    int total = 0;
+    for (const ListItem &item : qAsConst(m_notifications)) {
+        total += loadedCount(item);
+    }
+
+    // 从列表底部开始回收,跳过正在查看的分组
+    for (auto it = m_notifications.end(); it != m_notifications.begin() && total > NOTIFY_LOADED_BUDGET;) {
+        ListItem &item = (--it).value();
+        if (item.appName == keepApp || loadedCount(item) <= NOTIFY_PAGE_SIZE || groupVisible(item.appName, firstRow, lastRow))
+            continue;
+
+        total -= loadedCount(item);
+        collapseGroup(item);
+        total += loadedCount(item);
+    }
 }
 
 EntityPtr NotifyModel::getEntityByRow(int row) const
 {
     Q_ASSERT(row <= rowCount(QModelIndex()) - 1);
-    int index = 0;
-    for (int i = 0; i < m_notifications.size(); ++i) {
-        const auto &item = m_notifications[i];
-        item.showList.last()->setHideCount(item.hideList.size() > 2 ? 2 : item.hideList.size());
-        if (index == row) {
-            EntityPtr ptr = std::make_shared<NotificationEntity>(item.appName);
-            ptr->setTime(item.lastTimeStamp);
-            ptr->setIsTitle(true);
-            ptr->setCurrentIndex(row);
-            return ptr;
+    // 标题行和通知行的数据都在行中缓存,行号在行变化时统一更新
+    return m_rows.at(row).entity;
+}
+
+QVector<NotifyRow> NotifyModel::buildRows()
+{
+    QVector<NotifyRow> rows;
+    QHash<QString, EntityPtr> titles;
+    titles.reserve(m_notifications.size());
+
+    for (const ListItem &item : qAsConst(m_notifications)) {
+        // 每组的标题只创建一次,分组存在期间一直复用
+        EntityPtr titleEntity = m_titles.value(item.appName);
+        if (!titleEntity) {
+            NotificationRecord record;
+            record.setAppName(item.appName);
+            record.setFlag(NotificationRecord::IsTitle);
+            titleEntity = std::make_shared<NotificationEntity>(record);
         }
-        index++;
+        titleEntity->setTime(QString::number(item.lastTimeStamp));
+        titles.insert(item.appName, titleEntity);
+
+        NotifyRow title;
+        title.appName = item.appName;
+        title.entity = titleEntity;
+        title.timeStamp = item.lastTimeStamp;
+        rows.append(title);
+
         for (int j = 0; j < item.showList.size(); ++j) {
-            if (index == row) {
-                item.showList[j]->setCurrentIndex(row);
-                return item.showList.at(j);
-            }
-            index ++;
+            const EntityPtr &entity = item.showList.at(j);
+            // 只有每组的最后一条显示层叠效果
+            entity->setHideCount(j == item.showList.size() - 1 ? qMin(2, item.hideList.size()) : 0);
+
+            NotifyRow row;
+            row.appName = item.appName;
+            row.entity = entity;
+            row.hideCount = entity->hideCount();
+            rows.append(row);
+        }
+    }
+    rows.squeeze();
+    m_titles = titles;
+    return rows;
+}
+
+void NotifyModel::updateRowIndexes()
+{
+    m_groupRows.clear();
+    for (int i = 0; i < m_rows.size(); ++i) {
+        m_rows[i].entity->setCurrentIndex(i);
+        // 同一组的行是连续的,第一行是标题行
+        QPair<int, int> &range = m_groupRows[m_rows.at(i).appName];
+        if (range.second == 0)
+            range.first = i;
+        ++range.second;
+    }
+}
+
+void NotifyModel::updateRows()
+{
+    const QVector<NotifyRow> rows = buildRows();
+
+    QSet<NotifyRow> newRows;
+    newRows.reserve(rows.size());
+    for (const NotifyRow &row : rows)
+        newRows.insert(row);
+
+    // 同一条通知出现在两个位置时无法计算行的变化,直接重置
+    if (newRows.size() != rows.size()) {
+        beginResetModel();
+        m_rows = rows;
+        updateRowIndexes();
+        endResetModel();
+        return;
+    }
+
+    // 1.从后往前删除已经不存在的行,连续的行一次删除
+    for (int i = m_rows.size() - 1; i >= 0;) {
+        if (newRows.contains(m_rows.at(i))) {
+            --i;
+            continue;
+        }
+        const int last = i;
+        while (i >= 0 && !newRows.contains(m_rows.at(i)))
+            --i;
+        beginRemoveRows(QModelIndex(), i + 1, last);
+        m_rows.erase(m_rows.begin() + i + 1, m_rows.begin() + last + 1);
+        endRemoveRows();
+    }
+
+    QSet<NotifyRow> oldRows;
+    oldRows.reserve(m_rows.size());
+    for (const NotifyRow &row : m_rows)
+        oldRows.insert(row);
+
+    // 2.保留下来的行按新的顺序移动,一般是整组移动到最前面
+    QVector<NotifyRow> keptRows;
+    keptRows.reserve(m_rows.size());
+    for (const NotifyRow &row : rows) {
+        if (oldRows.contains(row))
+            keptRows.append(row);
+    }
+    for (int i = 0; i < keptRows.size();) {
+        if (m_rows.at(i) == keptRows.at(i)) {
+            ++i;
+            continue;
+        }
+        int from = i + 1;
+        while (!(m_rows.at(from) == keptRows.at(i)))
+            ++from;
+        int count = 1;
+        while (from + count < m_rows.size() && i + count < keptRows.size()
+               && m_rows.at(from + count) == keptRows.at(i + count))
+            ++count;
+        beginMoveRows(QModelIndex(), from, from + count - 1, QModelIndex(), i);
+        std::rotate(m_rows.begin() + i, m_rows.begin() + from, m_rows.begin() + from + count);
+        endMoveRows();
+        i += count;
+    }
+
+    // 3.插入新的行,连续的行一次插入
+    for (int i = 0; i < rows.size();) {
+        if (oldRows.contains(rows.at(i))) {
+            ++i;
+            continue;
+        }
+        int count = 1;
+        while (i + count < rows.size() && !oldRows.contains(rows.at(i + count)))
+            ++count;
+        beginInsertRows(QModelIndex(), i, i + count - 1);
+        for (int j = 0; j < count; ++j)
+            m_rows.insert(i + j, rows.at(i + j));
+        endInsertRows();
+        i += count;
+    }
+
+    // 4.标题行的时间变化时更新数据,同时更新编辑控件使用的行号
+    updateRowIndexes();
+    for (int i = 0; i < m_rows.size(); ++i) {
+        NotifyRow &row = m_rows[i];
+        if (row.timeStamp != rows.at(i).timeStamp) {
+            row.timeStamp = rows.at(i).timeStamp;
+            Q_EMIT QAbstractItemModel::dataChanged(index(i), index(i));
         }
     }
-    Q_UNREACHABLE();
 }
 
 bool NotifyModel::checkTimeOut(EntityPtr ptr, int sec)
 {
-    QDateTime t = QDateTime::fromMSecsSinceEpoch(ptr->ctime().toLongLong());
+    return checkTimeOut(ptr->record(), sec);
+}
+
+bool NotifyModel::checkTimeOut(const NotificationRecord &record, int sec)
+{
+    QDateTime t = QDateTime::fromMSecsSinceEpoch(record.ctime());
     return t.secsTo(QDateTime::currentDateTime()) > sec;
 }
 
@@ -6,8 +6,11 @@
 #define NotifyModel_H
 
 #include "../notification/constants.h"
+#include "../notification/notificationrecord.h"
 
 #include <QAbstractListModel>
+#include <QHash>
+#include <QMap>
 #include <QPointer>
 #include <QListView>
 
@@ -16,19 +19,48 @@
 #define OVERLAPTIMEOUT_4_HOUR       (4 * 60 * 60)
 #define OVERLAPTIMEOUT_7_DAY        (7 * 24 * 60 * 60)
 #define TIMEOUT_CHECK_TIME          1000
+#define NOTIFY_PAGE_SIZE            50          // 每个应用每次从数据库加载的通知数量
+#define NOTIFY_LOADED_BUDGET        1000        // 内存中最多保留的通知数量,超过后回收不可见的分页
 
 class QTimer;
+class ExpiryScheduler;
 class Persistence;
 class AbstractPersistence;
 class NotifyListView;
 
 typedef struct{
     QString appName;                // 应用名称
-    QString lastTimeStamp;          // 此组应用最新的时间组
+    qint64 lastTimeStamp = 0;       // 此组应用最新的时间组
     QList<EntityPtr> showList;      // 显示列表
-    QList<EntityPtr> hideList;      // 隐藏列表
+    QList<NotificationRecord> hideList;     // 隐藏列表,只保存紧凑的通知数据
+    int storedCount = 0;            // 数据库中此应用的通知数量,多于已加载的数量时还有更早的分页
+    bool expanded = false;          // 是否已经展开
 } ListItem;
 
+// 分组的排序键,按最后活动时间从新到旧排列,时间相同时后活动的分组在前
+struct GroupOrder {
+    qint64 timeStamp = 0;
+    quint64 sequence = 0;
+
+    bool operator<(const GroupOrder &other) const
+    {
+        return timeStamp != other.timeStamp ? timeStamp > other.timeStamp : sequence > other.sequence;
+    }
+};
+
+// 展开后视图中的一行,标题行的 entity 为缓存的标题数据
+struct NotifyRow {
+    QString appName;
+    EntityPtr entity;
+    int hideCount = 0;              // 层叠数量不同时需要重新创建编辑控件,属于行的标识
+    qint64 timeStamp = 0;           // 标题行使用,不属于行的标识
+
+    bool operator==(const NotifyRow &other) const
+    {
+        return appName == other.appName && entity == other.entity && hideCount == other.hideCount;
+    }
+};
+
 class NotifyModel : public QAbstractListModel
 {
     Q_OBJECT
@@ -36,20 +68,24 @@ public:
     NotifyModel(QObject *parent = nullptr, AbstractPersistence *database = nullptr, NotifyListView *view = nullptr);
     NotifyListView *view() { return m_view; }
     ListItem getAppData(QString appName) const;
+    const NotifyRow &rowAt(int row) const { return m_rows.at(row); }   // 视图中的一行,不经过 QVariant 转换
 
 public:
     int rowCount(const QModelIndex &parent) const override;
     QVariant data(const QModelIndex &index, int role) const override;
     Qt::ItemFlags flags(const QModelIndex &index) const override;
+    bool canFetchMore(const QModelIndex &parent) const override;   // 最后一组展开且还有更早的通知时可以继续加载
+    void fetchMore(const QModelIndex &parent) override;
 
 public slots:
     void addNotify(EntityPtr entity);                   // 添加一条通知，并更新视图
     void removeNotify(EntityPtr entity);                // 删除一条通知，并更新视图
+    void updateNotify(EntityPtr entity);                // 重复的通知合并后更新次数和时间,并移动到最前面
     void removeAppGroup(QString appName);               // 移除一组通知
     void removeAllData();                               // 清除所有通知
     void expandData(QString appName);                   // 展开通知
     void collapseData();                                // 折叠通知
-    void removeTimeOutNotify();                         // 移除超过7天的通知
+    void removeTimeOutNotify();                         // 立即移除已经超过7天的通知
     void cacheData(EntityPtr entity);                   // 缓存暂未处理的通知
     void freeData();                                    // 将暂未处理的通知顺序添加到通知中心
 
@@ -61,15 +97,51 @@ private:
     void initData();                                    // 初始化数据
     void initConnect();                                 // 初始化信号
     void addAppData(EntityPtr entity);                  // 添加一条数据
+    /*!
+     * \~chinese \name removeExpired
+     * \~chinese \brief 移除保留期限已到的通知,分组中未加载的通知比已加载的更早,同时从数据库中删除
+     */
+    void removeExpired(const QList<uint> &ids);
+    ListItem *findGroup(const QString &appName);        // 按应用名称查找分组,不存在时返回nullptr,分组增删后失效
+    void insertGroup(const ListItem &item);             // 按最后活动时间插入新的分组
+    void touchGroup(const QString &appName);            // 分组有新的活动,按 lastTimeStamp 重新排序
+    void removeGroup(const QString &appName);
+    static int loadedCount(const ListItem &item);       // 分组中已经加载的通知数量
+    void loadPage(ListItem &item);                      // 从数据库加载分组中下一页更早的通知到隐藏列表
+    void expandPage(ListItem &item);                    // 显示已加载的隐藏通知,并预先加载下一页
+    void collapseGroup(ListItem &item);                 // 折叠分组,只保留一页隐藏通知
+    bool visibleRows(int &firstRow, int &lastRow) const;   // 视图中可见的行范围,没有可见的行时返回false
+    bool groupVisible(const QString &appName, int firstRow, int lastRow) const;    // 分组的行是否在可见的行范围内
+    /*!
+     * \~chinese \name evictPages
+     * \~chinese \brief 已加载的通知超过 NOTIFY_LOADED_BUDGET 时,折叠不可见的分组并释放多余的分页,
+     * \~chinese 释放的通知在再次展开时按游标重新从数据库加载
+     */
+    void evictPages(const QString &keepApp);
     EntityPtr getEntityByRow(int row) const;            // 根据row获取数据
+    QVector<NotifyRow> buildRows();                     // 根据分组数据计算展开后的行
+    void updateRowIndexes();                            // 更新每行数据中保存的行号
+    /*!
+     * \~chinese \name updateRows
+     * \~chinese \brief 比较分组数据修改前后展开的行,依次发出删除、移动、插入和数据变化的信号,
+     * \~chinese 视图只更新受影响的行,其它行的编辑控件、滚动位置和焦点都保持不变
+     */
+    void updateRows();
     bool checkTimeOut(EntityPtr ptr, int sec);          // 检查通知是否超时
+    bool checkTimeOut(const NotificationRecord &record, int sec);
 
 private:
     NotifyListView *m_view = nullptr;
     Persistence *m_database = nullptr;
-    QList<ListItem> m_notifications;                    //外层为app,内层为此app的消息
+    QMap<GroupOrder, ListItem> m_notifications;         //外层为app,内层为此app的消息,按最后活动时间排列
+    QHash<QString, GroupOrder> m_groupOrders;           //应用名称到分组排序键的索引
+    quint64 m_groupSequence = 0;
+    QVector<NotifyRow> m_rows;                          //视图当前看到的行
+    QHash<QString, QPair<int, int>> m_groupRows;        //每组在 m_rows 中的起始行和行数,与行号一起更新
+    QHash<QString, EntityPtr> m_titles;                 //每组标题行的数据
     QList<EntityPtr> m_cacheList;
     QTimer *m_freeTimer;
+    ExpiryScheduler *m_expiry;                          //已加载通知的保留期限
 };
 
 #endif // NotifyModel_H
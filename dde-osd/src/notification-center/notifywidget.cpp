@@ -10,6 +10,7 @@
 #include <QScrollBar>
 #include <QScroller>
 #include <QLabel>
+#include <QGSettings>
 
 #include "itemdelegate.h"
 #include "notifymodel.h"
@@ -56,6 +57,18 @@ void NotifyWidget::initView(AbstractPersistence *database)
     m_mainList->setPalette(pa);
 
     connect(m_mainList, &NotifyListView::focusOnButton, this, &NotifyWidget::focusOnButton);
+
+    // 可选的绘制模式,通知很多时只为悬停和焦点所在的行创建控件
+    if (QGSettings::isSchemaInstalled("com.deepin.dde.osd")) {
+        QGSettings *settings = new QGSettings("com.deepin.dde.osd", "/com/deepin/dde/osd/", this);
+        if (settings->keys().contains("notifyCenterPaintedRows")) {
+            m_mainList->setPaintedRows(settings->get("notify-center-painted-rows").toBool());
+            connect(settings, &QGSettings::changed, this, [ this, settings ](const QString &key) {
+                if (key == "notifyCenterPaintedRows")
+                    m_mainList->setPaintedRows(settings->get("notify-center-painted-rows").toBool());
+            });
+        }
+    }
 }
 
 void NotifyWidget::showEvent(QShowEvent *event)
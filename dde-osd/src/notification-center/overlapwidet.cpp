@@ -7,10 +7,11 @@
 #include "../notification/constants.h"
 #include "notifylistview.h"
 #include "notifymodel.h"
+#include "cardbackgroundcache.h"
 
 #include <QTimer>
 #include <QKeyEvent>
-#include <QPainterPath>
+#include <QPainter>
 
 HalfRoundedRectWidget::HalfRoundedRectWidget(QWidget *parent)
     : AlphaWidget(parent)
@@ -26,33 +27,14 @@ void HalfRoundedRectWidget::paintEvent(QPaintEvent *event)
 {
     Q_UNUSED(event)
     QPainter painter(this);
-    painter.setRenderHint(QPainter::Antialiasing);//消除锯齿
 
     QPalette pe = this->palette();//得到此类的调色板
     QColor brushColor(pe.color(QPalette::Base));
     brushColor.setAlpha(m_hasFocus ? m_hoverAlpha : m_unHoverAlpha);
-    painter.setBrush(brushColor);
 
-    int radius = 6;
-
-    QPen borderPen;
-    borderPen.setColor(Qt::transparent);
-    painter.setPen(borderPen);
-
-    QRect rect = this->rect();
-    rect.setWidth(rect.width());
-    rect.setHeight(rect.height());
-
-    QPainterPath path;
-    path.moveTo(rect.bottomRight() - QPointF(0, radius));
-    path.lineTo(rect.topRight().x(), rect.topRight().y() / 2);
-    path.lineTo(rect.topLeft().x(), rect.topLeft().y() / 2);
-    path.lineTo(rect.bottomLeft() - QPointF(0, radius));
-    path.arcTo(QRectF(QPointF(rect.bottomLeft() - QPointF(0, radius * 2)), QSize(radius * 2, radius * 2)), 180, 90);
-    path.lineTo(rect.bottomRight() + QPointF(radius, 0));
-    path.arcTo(QRectF(QPointF(rect.bottomRight() - QPointF(radius * 2, radius * 2)), QSize(radius * 2, radius * 2)), 270, 90);
-
-    painter.drawPath(path);
+    // 只有下边两个角是圆角
+    const int radius = 6;
+    CardBackgroundCache::ref().draw(&painter, rect(), 0, radius, brushColor, devicePixelRatioF());
 }
 
 OverLapWidet::OverLapWidet(NotifyModel *model, EntityPtr ptr, QWidget *parent)
@@ -76,6 +58,8 @@ QList<QPointer<QWidget> > OverLapWidet::bubbleElements()
 
 void OverLapWidet::expandAppGroup()
 {
+    // 先结束上一个动画,行号和分组数据按结束后的模型计算
+    m_view->finishAnimation();
     hideOverlapBubble();
     ListItem appItem = m_model->getAppData(m_entify->appName());
     m_view->createExpandAnimation(m_entify->currentIndex(), appItem);
@@ -0,0 +1,155 @@
+// SPDX-FileCopyrightText: 2024 UnionTech Software Technology Co., Ltd.
+//
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+#include "relativetimescheduler.h"
+
+#include <QTimer>
+#include <QDateTime>
+
+// 单次等待的上限,系统休眠或者修改时间之后最晚在这个时间内纠正
+static const qint64 MaxWakeupInterval = 60 * 60 * 1000;
+
+static const qint64 MinuteMs = 60 * 1000;
+static const qint64 HourMs = 60 * MinuteMs;
+
+RelativeTimeScheduler::RelativeTimeScheduler(QObject *parent)
+    : QObject(parent)
+    , m_wheel(QDateTime::currentMSecsSinceEpoch())
+    , m_timer(new QTimer(this))
+{
+    m_timer->setSingleShot(true);
+    connect(m_timer, &QTimer::timeout, this, &RelativeTimeScheduler::onTimeout);
+}
+
+quint64 RelativeTimeScheduler::add(qint64 ctime, QObject *context, Callback callback)
+{
+    const qint64 now = QDateTime::currentMSecsSinceEpoch();
+    const qint64 next = nextTransition(ctime, now);
+    if (next < 0)
+        return 0;
+
+    // 时间轮为空时从当前时间重新开始,避免从很久之前的时间推进
+    if (m_wheel.isEmpty())
+        m_wheel = TimerWheel(now);
+
+    const quint64 handle = m_nextHandle++;
+    m_watches.insert(handle, {ctime, context, callback});
+    m_wheel.add(handle, next);
+    if (!m_contexts.contains(context)) {
+        m_contexts.insert(context);
+        connect(context, &QObject::destroyed, this, &RelativeTimeScheduler::removeContext);
+    }
+
+    arm();
+    return handle;
+}
+
+void RelativeTimeScheduler::remove(quint64 handle)
+{
+    if (m_watches.remove(handle) == 0)
+        return;
+
+    m_wheel.remove(handle);
+    if (m_wheel.isEmpty())
+        m_timer->stop();
+}
+
+void RelativeTimeScheduler::removeContext(QObject *context)
+{
+    m_contexts.remove(context);
+
+    for (auto it = m_watches.begin(); it != m_watches.end();) {
+        if (it.value().context == context) {
+            m_wheel.remove(it.key());
+            it = m_watches.erase(it);
+        } else {
+            ++it;
+        }
+    }
+    if (m_wheel.isEmpty())
+        m_timer->stop();
+}
+
+bool RelativeTimeScheduler::isActive() const
+{
+    return m_timer->isActive();
+}
+
+void RelativeTimeScheduler::setSuspended(bool suspended)
+{
+    if (m_suspended == suspended)
+        return;
+
+    m_suspended = suspended;
+    if (m_suspended) {
+        m_timer->stop();
+    } else {
+        onTimeout();
+    }
+}
+
+qint64 RelativeTimeScheduler::nextTransition(qint64 ctime, qint64 now)
+{
+    // 和 BubbleItem::timeText 的规则保持一致
+    if (now < ctime)
+        return ctime;
+
+    const QDateTime created = QDateTime::fromMSecsSinceEpoch(ctime);
+    const QDateTime current = QDateTime::fromMSecsSinceEpoch(now);
+    const qint64 elapsedDay = created.daysTo(current);
+    auto midnightAfter = [ &created ](int days) {
+        return QDateTime(created.date().addDays(days), QTime(0, 0)).toMSecsSinceEpoch();
+    };
+
+    if (elapsedDay == 0) {
+        const qint64 minute = (now - ctime) / MinuteMs;
+        const qint64 next = minute < 60 ? ctime + (minute + 1) * MinuteMs
+                                        : ctime + (minute / 60 + 1) * HourMs;
+        return qMin(next, midnightAfter(1));
+    }
+    if (elapsedDay == 1)
+        return midnightAfter(2);
+    if (elapsedDay < 7)
+        return midnightAfter(7);
+
+    return -1;
+}
+
+void RelativeTimeScheduler::onTimeout()
+{
+    if (m_suspended)
+        return;
+
+    const qint64 now = QDateTime::currentMSecsSinceEpoch();
+    for (quint64 handle : m_wheel.advance(now)) {
+        auto it = m_watches.find(handle);
+        if (it == m_watches.end())
+            continue;
+
+        // 先安排下一次变化,回调中可能会移除自己
+        const Watch watch = it.value();
+        const qint64 next = nextTransition(watch.ctime, now);
+        if (next < 0) {
+            m_watches.erase(it);
+        } else {
+            m_wheel.add(handle, next);
+        }
+
+        watch.callback();
+    }
+
+    arm();
+}
+
+void RelativeTimeScheduler::arm()
+{
+    const qint64 wakeup = m_wheel.nextWakeup();
+    if (m_suspended || wakeup < 0) {
+        m_timer->stop();
+        return;
+    }
+
+    const qint64 interval = qBound<qint64>(0, wakeup - QDateTime::currentMSecsSinceEpoch(), MaxWakeupInterval);
+    m_timer->start(int(interval));
+}
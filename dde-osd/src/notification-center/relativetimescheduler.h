@@ -0,0 +1,78 @@
+// SPDX-FileCopyrightText: 2024 UnionTech Software Technology Co., Ltd.
+//
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+#ifndef RELATIVETIMESCHEDULER_H
+#define RELATIVETIMESCHEDULER_H
+
+#include "timerwheel.h"
+
+#include <QObject>
+#include <QHash>
+#include <QSet>
+
+#include <DSingleton>
+
+#include <functional>
+
+class QTimer;
+
+/*!
+ * \~chinese \class RelativeTimeScheduler
+ * \~chinese \brief 通知中心相对时间文本(“刚刚”、“5分钟前”等)的刷新调度.
+ * \~chinese 每条通知按照 BubbleItem::timeText 的规则计算文本下一次变化的时间,放入时间轮,
+ * \~chinese 所有条目共用一个单次定时器,只在最早的变化时间唤醒;没有需要变化的文本时定时器停止.
+ */
+class RelativeTimeScheduler : public QObject, public Dtk::Core::DSingleton<RelativeTimeScheduler>
+{
+    Q_OBJECT
+    friend class Dtk::Core::DSingleton<RelativeTimeScheduler>;
+
+public:
+    using Callback = std::function<void()>;
+
+    /*!
+     * \~chinese \name add
+     * \~chinese \brief 在 ctime 对应的时间文本每次变化时调用 callback,context 销毁后自动移除
+     * \~chinese \return 用于 remove 的句柄,文本不会再变化时返回0
+     */
+    quint64 add(qint64 ctime, QObject *context, Callback callback);
+    void remove(quint64 handle);
+    int count() const { return m_watches.size(); }
+    bool isActive() const;
+
+    /*!
+     * \~chinese \name setSuspended
+     * \~chinese \brief 通知中心隐藏时暂停唤醒,恢复时立即刷新暂停期间到期的文本
+     */
+    void setSuspended(bool suspended);
+
+    /*!
+     * \~chinese \name nextTransition
+     * \~chinese \brief 计算 ctime 对应的时间文本在 now 之后下一次变化的时间(毫秒),不会再变化时返回-1
+     */
+    static qint64 nextTransition(qint64 ctime, qint64 now);
+
+private:
+    explicit RelativeTimeScheduler(QObject *parent = nullptr);
+
+    void onTimeout();
+    void arm();                             // 按时间轮中最早的唤醒时间启动定时器
+    void removeContext(QObject *context);   // 移除已经销毁的对象的所有条目
+
+private:
+    struct Watch {
+        qint64 ctime;
+        QObject *context;               // 对象销毁时它的条目都会被移除
+        Callback callback;
+    };
+
+    TimerWheel m_wheel;
+    QHash<quint64, Watch> m_watches;
+    QSet<QObject *> m_contexts;
+    quint64 m_nextHandle = 1;
+    bool m_suspended = false;
+    QTimer *m_timer;
+};
+
+#endif // RELATIVETIMESCHEDULER_H
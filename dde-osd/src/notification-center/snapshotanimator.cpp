@@ -0,0 +1,126 @@
+// SPDX-FileCopyrightText: 2024 UnionTech Software Technology Co., Ltd.
+//
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+#include "snapshotanimator.h"
+
+#include <QLayout>
+#include <QPainter>
+#include <QVariantAnimation>
+
+SnapshotAnimator::SnapshotAnimator(QWidget *parent)
+    : QWidget(parent)
+    , m_animation(new QVariantAnimation(this))
+{
+    setAttribute(Qt::WA_TransparentForMouseEvents);
+    setAttribute(Qt::WA_NoSystemBackground);
+    setFocusPolicy(Qt::NoFocus);
+    hide();
+
+    m_animation->setStartValue(0);
+    connect(m_animation, &QVariantAnimation::valueChanged, this, [ this ](const QVariant &value) {
+        m_elapsed = value.toInt();
+        update();
+    });
+    connect(m_animation, &QVariantAnimation::finished, this, &SnapshotAnimator::finish);
+}
+
+void SnapshotAnimator::addWidget(QWidget *widget, const QRect &to, int duration, int delay)
+{
+    if (widget == nullptr)
+        return;
+
+    const QRect &from = widgetRect(widget);
+    addPixmap(widget->grab(), from, to, duration, delay);
+    widget->hide();
+    m_hiddenWidgets << widget;
+}
+
+void SnapshotAnimator::addPixmap(const QPixmap &pixmap, const QRect &from, const QRect &to, int duration, int delay)
+{
+    m_sprites.append({pixmap, from, to, duration, delay});
+}
+
+QRect SnapshotAnimator::widgetRect(QWidget *widget) const
+{
+    return QRect(widget->mapTo(parentWidget(), QPoint(0, 0)), widget->size());
+}
+
+QPixmap SnapshotAnimator::snapshot(QWidget *widget, const QSize &size)
+{
+    widget->resize(size);
+    if (widget->layout() != nullptr)
+        widget->layout()->activate();
+    return widget->grab();
+}
+
+void SnapshotAnimator::start(std::function<void()> finished)
+{
+    int total = 0;
+    for (const Sprite &sprite : m_sprites) {
+        total = qMax(total, sprite.delay + sprite.duration);
+    }
+
+    m_finished = finished;
+    m_running = true;
+    m_elapsed = 0;
+    if (total == 0) {
+        finish();
+        return;
+    }
+
+    setGeometry(parentWidget()->rect());
+    raise();
+    show();
+    m_animation->setEndValue(total);
+    m_animation->setDuration(total);
+    m_animation->start();
+}
+
+void SnapshotAnimator::finish()
+{
+    if (!m_running)
+        return;
+
+    m_running = false;
+    m_animation->stop();
+    hide();
+    m_sprites.clear();
+
+    // 先恢复控件,回调中删除的行由视图再次隐藏
+    for (const QPointer<QWidget> &widget : m_hiddenWidgets) {
+        if (!widget.isNull())
+            widget->show();
+    }
+    m_hiddenWidgets.clear();
+
+    std::function<void()> finished;
+    std::swap(finished, m_finished);
+    if (finished)
+        finished();
+}
+
+void SnapshotAnimator::paintEvent(QPaintEvent *event)
+{
+    Q_UNUSED(event)
+    QPainter painter(this);
+
+    for (const Sprite &sprite : m_sprites) {
+        if (m_elapsed < sprite.delay)
+            continue;
+
+        const qreal progress = sprite.duration <= 0 ? 1.0 : qMin(1.0, qreal(m_elapsed - sprite.delay) / sprite.duration);
+        const QRectF rect(sprite.from.x() + (sprite.to.x() - sprite.from.x()) * progress,
+                          sprite.from.y() + (sprite.to.y() - sprite.from.y()) * progress,
+                          sprite.from.width() + (sprite.to.width() - sprite.from.width()) * progress,
+                          sprite.from.height() + (sprite.to.height() - sprite.from.height()) * progress);
+        if (rect.isEmpty())
+            continue;
+
+        // 区域变小时只显示截图的上部
+        const qreal ratio = sprite.pixmap.devicePixelRatioF();
+        const QRectF source(0, 0, qMin(rect.width() * ratio, qreal(sprite.pixmap.width())),
+                            qMin(rect.height() * ratio, qreal(sprite.pixmap.height())));
+        painter.drawPixmap(QRectF(rect.topLeft(), source.size() / ratio), sprite.pixmap, source);
+    }
+}
@@ -0,0 +1,72 @@
+// SPDX-FileCopyrightText: 2024 UnionTech Software Technology Co., Ltd.
+//
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+#ifndef SNAPSHOTANIMATOR_H
+#define SNAPSHOTANIMATOR_H
+
+#include <QWidget>
+#include <QPointer>
+#include <QPixmap>
+
+#include <functional>
+
+class QVariantAnimation;
+
+/*!
+ * \~chinese \class SnapshotAnimator
+ * \~chinese \brief 基于截图的动画,覆盖在列表的 viewport 上.
+ * \~chinese 参与动画的控件在开始前截图一次并隐藏,每一帧只在一次绘制中移动和裁剪这些截图,
+ * \~chinese 不再对真实的控件树重新布局和绘制;动画结束后恢复隐藏的控件
+ */
+class SnapshotAnimator : public QWidget
+{
+    Q_OBJECT
+public:
+    explicit SnapshotAnimator(QWidget *parent);
+
+    /*!
+     * \~chinese \name addWidget
+     * \~chinese \brief 截图控件并在动画期间隐藏,截图从控件当前的位置变化到 to
+     * \~chinese \param to: 在本控件坐标系中的目标区域,尺寸变小时裁剪截图的下方
+     */
+    void addWidget(QWidget *widget, const QRect &to, int duration, int delay = 0);
+    /*!
+     * \~chinese \name addPixmap
+     * \~chinese \brief 添加一张截图,delay 之前不显示
+     */
+    void addPixmap(const QPixmap &pixmap, const QRect &from, const QRect &to, int duration, int delay = 0);
+
+    QRect widgetRect(QWidget *widget) const;        // 控件在本控件坐标系中的区域
+    static QPixmap snapshot(QWidget *widget, const QSize &size);   // 为还没有显示的控件截图
+
+    /*!
+     * \~chinese \name start
+     * \~chinese \brief 开始动画,结束时先恢复隐藏的控件再调用 finished
+     */
+    void start(std::function<void()> finished);
+    void finish();                                  // 立即结束动画,添加新的截图之前调用以结束上一个动画
+    bool isRunning() const { return m_running; }
+    int spriteCount() const { return m_sprites.size(); }
+
+protected:
+    void paintEvent(QPaintEvent *event) override;
+
+private:
+    struct Sprite {
+        QPixmap pixmap;
+        QRect from;
+        QRect to;
+        int duration;
+        int delay;
+    };
+
+    QVector<Sprite> m_sprites;
+    QList<QPointer<QWidget>> m_hiddenWidgets;
+    std::function<void()> m_finished;
+    QVariantAnimation *m_animation;
+    int m_elapsed = 0;
+    bool m_running = false;
+};
+
+#endif // SNAPSHOTANIMATOR_H
@@ -0,0 +1,132 @@
+// SPDX-FileCopyrightText: 2024 UnionTech Software Technology Co., Ltd.
+//
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+#include "timerwheel.h"
+
+static const int WheelBits = 6;
+static const int WheelSize = 1 << WheelBits;
+static const int WheelMask = WheelSize - 1;
+static const int WheelLevels = 4;
+static const qint64 TickMs = 1000;
+static const qint64 MaxTicks = (qint64(1) << (WheelBits * WheelLevels)) - 1;
+
+TimerWheel::TimerWheel(qint64 nowMs)
+    : m_tick(nowMs / TickMs)
+    , m_slots(WheelSize * WheelLevels)
+{
+}
+
+void TimerWheel::add(quint64 id, qint64 deadlineMs)
+{
+    // 向上取整到秒,不会提前到期
+    qint64 tick = (deadlineMs + TickMs - 1) / TickMs;
+    tick = qBound(m_tick + 1, tick, m_tick + MaxTicks);
+
+    m_deadlines.insert(id, tick);
+    insert({id, tick});
+}
+
+void TimerWheel::remove(quint64 id)
+{
+    m_deadlines.remove(id);
+
+    // 没有有效的条目时丢掉槽中遗留的旧条目,避免无用的唤醒
+    if (m_deadlines.isEmpty()) {
+        for (QVector<Entry> &slot : m_slots)
+            slot.clear();
+    }
+}
+
+QList<quint64> TimerWheel::advance(qint64 nowMs)
+{
+    QList<quint64> expired;
+    const qint64 nowTick = nowMs / TickMs;
+
+    // 跳过没有条目到期也没有槽需要下沉的时间,长时间休眠之后也不用逐秒前进
+    while (m_tick < nowTick) {
+        const qint64 next = nextEventTick();
+        if (next < 0 || next > nowTick) {
+            m_tick = nowTick;
+            break;
+        }
+        m_tick = next - 1;
+        step(expired);
+    }
+
+    if (m_deadlines.isEmpty()) {
+        for (QVector<Entry> &slot : m_slots)
+            slot.clear();
+    }
+    return expired;
+}
+
+qint64 TimerWheel::nextWakeup() const
+{
+    if (m_deadlines.isEmpty())
+        return -1;
+
+    const qint64 tick = nextEventTick();
+    return tick < 0 ? -1 : tick * TickMs;
+}
+
+void TimerWheel::insert(const Entry &entry)
+{
+    const qint64 delta = entry.tick - m_tick;
+    int level = 0;
+    while (level < WheelLevels - 1 && delta >= (qint64(1) << (WheelBits * (level + 1))))
+        ++level;
+
+    const int slot = int((entry.tick >> (WheelBits * level)) & WheelMask);
+    m_slots[level * WheelSize + slot].append(entry);
+}
+
+void TimerWheel::step(QList<quint64> &expired)
+{
+    ++m_tick;
+
+    // 到达某一层的时间段边界时,把这一层对应槽中的条目重新放到更低的层
+    for (int level = WheelLevels - 1; level > 0; --level) {
+        const int shift = WheelBits * level;
+        if (m_tick & ((qint64(1) << shift) - 1))
+            continue;
+
+        QVector<Entry> entries;
+        entries.swap(m_slots[level * WheelSize + int((m_tick >> shift) & WheelMask)]);
+        for (const Entry &entry : entries) {
+            if (m_deadlines.value(entry.id, -1) == entry.tick)
+                insert(entry);
+        }
+    }
+
+    QVector<Entry> entries;
+    entries.swap(m_slots[int(m_tick & WheelMask)]);
+    for (const Entry &entry : entries) {
+        if (m_deadlines.value(entry.id, -1) == entry.tick) {
+            m_deadlines.remove(entry.id);
+            expired.append(entry.id);
+        }
+    }
+}
+
+qint64 TimerWheel::nextEventTick() const
+{
+    qint64 next = -1;
+    for (int level = 0; level < WheelLevels; ++level) {
+        const int shift = WheelBits * level;
+        const qint64 block = m_tick >> shift;
+        for (int slot = 0; slot < WheelSize; ++slot) {
+            if (m_slots[level * WheelSize + slot].isEmpty())
+                continue;
+
+            // 槽在当前这一圈已经处理过时,下一次是在下一圈
+            qint64 slotBlock = (block & ~qint64(WheelMask)) | slot;
+            if (slotBlock <= block)
+                slotBlock += WheelSize;
+            const qint64 tick = slotBlock << shift;
+            if (next < 0 || tick < next)
+                next = tick;
+        }
+    }
+    return next;
+}
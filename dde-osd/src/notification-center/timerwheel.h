@@ -0,0 +1,60 @@
+// SPDX-FileCopyrightText: 2024 UnionTech Software Technology Co., Ltd.
+//
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+#ifndef TIMERWHEEL_H
+#define TIMERWHEEL_H
+
+#include <QHash>
+#include <QList>
+#include <QVector>
+
+/*!
+ * \~chinese \class TimerWheel
+ * \~chinese \brief 分层时间轮,时间以秒为单位,共4层,每层64个槽,最远可以安排约194天之后的到期.
+ * \~chinese 添加和删除是常数时间,同一秒内到期的条目在一次推进中一起返回,
+ * \~chinese 高层槽中的条目在对应的时间段开始时下沉到低层.
+ */
+class TimerWheel
+{
+public:
+    explicit TimerWheel(qint64 nowMs = 0);
+
+    /*!
+     * \~chinese \name add
+     * \~chinese \brief 添加或者重新安排一个条目,deadlineMs 不晚于当前时间时在下一秒到期
+     */
+    void add(quint64 id, qint64 deadlineMs);
+    void remove(quint64 id);
+    bool contains(quint64 id) const { return m_deadlines.contains(id); }
+    int count() const { return m_deadlines.size(); }
+    bool isEmpty() const { return m_deadlines.isEmpty(); }
+
+    /*!
+     * \~chinese \name advance
+     * \~chinese \brief 把时间推进到 nowMs,返回这段时间内到期的条目,返回的条目已经从时间轮中移除
+     */
+    QList<quint64> advance(qint64 nowMs);
+    /*!
+     * \~chinese \name nextWakeup
+     * \~chinese \brief 下一次需要调用 advance 的时间(毫秒),可能是条目到期,也可能是高层的槽需要下沉;时间轮为空时返回-1
+     */
+    qint64 nextWakeup() const;
+
+private:
+    struct Entry {
+        quint64 id;
+        qint64 tick;
+    };
+
+    void insert(const Entry &entry);
+    void step(QList<quint64> &expired); // 前进一秒,下沉高层的槽并收集到期的条目
+    qint64 nextEventTick() const;
+
+private:
+    qint64 m_tick;                      // 当前时间(秒),不晚于这个时间的条目都已经处理
+    QVector<QVector<Entry>> m_slots;    // 按层依次存放的所有槽
+    QHash<quint64, qint64> m_deadlines; // 条目当前有效的到期时间(秒),删除和重新安排时旧的条目在槽中延迟清理
+};
+
+#endif // TIMERWHEEL_H
@@ -5,15 +5,12 @@
 #include "appbody.h"
 #include "appbodylabel.h"
 #include "constants.h"
+#include "notifystyle.h"
 
 #include <QPainter>
 #include <QDebug>
 #include <QVBoxLayout>
 
-#include <DGuiApplicationHelper>
-#include <DFontSizeManager>
-
-DGUI_USE_NAMESPACE
 
 AppBody::AppBody(QWidget *parent)
     : QFrame(parent)
@@ -32,20 +29,21 @@ AppBody::AppBody(QWidget *parent)
     setLayout(layout);
     setSizePolicy(QSizePolicy::Expanding, QSizePolicy::Expanding);
 
-    connect(DGuiApplicationHelper::instance(), &DGuiApplicationHelper::themeTypeChanged, this, &AppBody::refreshTheme);
-    refreshTheme();
+    NotifyStyle::ref().subscribe(this, [this](const NotifyStylePtr &style) {
+        refreshTheme(style);
+    });
 }
 
 void AppBody::setTitle(const QString &title)
 {
-    m_titleLbl->setFont(DFontSizeManager::instance()->t6());
+    m_titleLbl->setFont(NotifyStyle::ref().current()->summaryFont);
     m_titleLbl->setText(title);
     m_titleLbl->setVisible(!title.isEmpty());
 }
 
 void AppBody::setText(const QString &text)
 {
-    m_bodyLbl->setFont(DFontSizeManager::instance()->t7());
+    m_bodyLbl->setFont(NotifyStyle::ref().current()->bodyFont);
     m_bodyLbl->setText(text);
     m_bodyLbl->setVisible(!text.isEmpty());
 }
@@ -53,14 +51,13 @@ void AppBody::setText(const QString &text)
 void AppBody::setStyle(OSD::ShowStyle style)
 {
     m_showStyle = style;
-    refreshTheme();
+    refreshTheme(NotifyStyle::ref().current());
 }
 
 int AppBody::bubbleWidgetAppBodyHeight()
 {
-    int titleLabelHeight = QFontMetrics(DFontSizeManager::instance()->t6()).height();
-    int bodyLabelHeight = QFontMetrics(DFontSizeManager::instance()->t7()).height();
-    return titleLabelHeight + bodyLabelHeight + BubbleAppBodyVerticalPadding;
+    const NotifyStylePtr &style = NotifyStyle::ref().current();
+    return style->summaryHeight + style->bodyHeight + BubbleAppBodyVerticalPadding;
 }
 
 int AppBody::bubbleWindowAppBodyHeight()
@@ -68,7 +65,7 @@ int AppBody::bubbleWindowAppBodyHeight()
     return fontMetrics().height() * 2 + BubbleAppBodyVerticalPadding;
 }
 
-void AppBody::refreshTheme()
+void AppBody::refreshTheme(const NotifyStylePtr &style)
 {
     m_titleLbl->setForegroundRole(QPalette::BrightText);
     m_bodyLbl->setForegroundRole(QPalette::BrightText);
@@ -77,8 +74,8 @@ void AppBody::refreshTheme()
         m_titleLbl->setOpacity(1.0);
         m_bodyLbl->setOpacity(Notify::BubbleOpacity);
 
-        m_titleLbl->setFont(DFontSizeManager::instance()->t6());
-        m_bodyLbl->setFont(DFontSizeManager::instance()->t7());
+        m_titleLbl->setFont(style->summaryFont);
+        m_bodyLbl->setFont(style->bodyFont);
     } else {
         m_titleLbl->setOpacity(Notify::BubbleOpacity);
         m_bodyLbl->setOpacity(1.0);
@@ -6,6 +6,7 @@
 #define APPBODY_H
 
 #include "constants.h"
+#include "notifystyle.h"
 #include <QWidget>
 #include <DLabel>
 
@@ -28,7 +29,7 @@ public:
     int bubbleWindowAppBodyHeight();
 
 private:
-    void refreshTheme();
+    void refreshTheme(const NotifyStylePtr &style);
 
 private:
     AppBodyLabel *m_titleLbl;
@@ -4,13 +4,14 @@
 
 #include "appbodylabel.h"
 #include "appbody.h"
+#include "textlayoutcache.h"
+#include "textelider.h"
 
 #include <QTextDocument>
 #include <QEvent>
 #include <QPainter>
 #include <QDebug>
 #include <QApplication>
-#include <QTextLine>
 #include <QPaintEngine>
 #include <QStyle>
 
@@ -36,64 +37,6 @@ void AppBodyLabel::setText(const QString &text)
     update();
 }
 
-// return line count
-static int drawText(QPainter *painter, const QRectF &rect, int lineHeight, QTextLayout *layout, Qt::TextElideMode mode)
-{
-    int lineCount = 0;
-    qreal height = 0;
-    QString text = layout->text();
-    QTextOption &text_option = *const_cast<QTextOption *>(&layout->textOption());
-
-    if (painter) {
-        text_option.setTextDirection(painter->layoutDirection());
-    }
-
-    layout->beginLayout();
-
-    QTextLine line = layout->createLine();
-    QPointF offset = rect.topLeft();
-
-    while (line.isValid()) {
-        ++lineCount;
-        height += lineHeight;
-
-        if (height + lineHeight > rect.height()) {
-            QString end_str = text.mid(line.textStart());
-
-            if (painter)
-                end_str = painter->fontMetrics().elidedText(end_str, mode, qRound(rect.width() - 1));
-
-            layout->endLayout();
-            layout->setText(end_str);
-
-            text_option.setWrapMode(QTextOption::NoWrap);
-            layout->beginLayout();
-            line = layout->createLine();
-            line.setLineWidth(rect.width() - 1);
-            text = end_str;
-        } else {
-            line.setLineWidth(rect.width());
-        }
-
-        line.setPosition(offset);
-
-        if (painter) {
-            line.draw(painter, QPointF(0, 0));
-        }
-
-        offset.setY(offset.y() + lineHeight);
-
-        if (height + lineHeight > rect.height())
-            break;
-
-        line = layout->createLine();
-    }
-
-    layout->endLayout();
-
-    return lineCount;
-}
-
 QSize AppBodyLabel::sizeHint() const
 {
     return QSize(width(), fontMetrics().height() * m_lineCount);
@@ -113,25 +56,8 @@ void AppBodyLabel::setAlignment(Qt::Alignment alignment)
 
 const QString AppBodyLabel::holdTextInRect(const QFontMetrics &fm, const QString &text, const QRect &rect) const
 {
-    const int textFlag = Qt::AlignTop | Qt::AlignLeft | Qt::TextWordWrap;
-
-    if (rect.contains(fm.boundingRect(rect, textFlag, text)))
-        return text;
-
-    QString str(text + "...");
-
-    while (true) {
-        if (str.size() < 4)
-            break;
-
-        QRect boundingRect = fm.boundingRect(rect, textFlag, str);
-        if (rect.contains(boundingRect))
-            break;
-
-        str.remove(str.size() - 4, 1);
-    }
-
-    return str;
+    Q_UNUSED(fm)
+    return TextElider::ref().elide(text, font(), rect.size());
 }
 
 void AppBodyLabel::resizeEvent(QResizeEvent *e)
@@ -153,15 +79,7 @@ void AppBodyLabel::paintEvent(QPaintEvent *event)
     Q_UNUSED(event)
     QPainter pa(this);
     pa.setOpacity(m_opacity);
-    QTextLayout layout(m_text, font(), this);
-    QTextOption option;
-
-    option.setWrapMode(QTextOption::WrapAtWordBoundaryOrAnywhere);
-    option.setAlignment(m_alignment);
 
-    layout.setTextOption(option);
-
-    QRect rect(this->rect());
     int lineHeight = fontMetrics().height();
     int lineCount = m_lineCount;
 
@@ -169,21 +87,14 @@ void AppBodyLabel::paintEvent(QPaintEvent *event)
         --lineCount;
     }
 
-    rect.setHeight(lineCount * lineHeight);
-    rect = QStyle::alignedRect(layoutDirection(), m_alignment, rect.size(), this->rect());
+    // 行数没有超出时和 updateLineCount 使用同一份排版
+    const TextLayoutPtr &layout = TextLayoutCache::ref().layout(m_text, font(), width(), lineCount, m_alignment, layoutDirection());
+    const QRect &rect = QStyle::alignedRect(layoutDirection(), m_alignment, QSize(width(), layout->height()), this->rect());
 
-    drawText(&pa, rect, lineHeight, &layout, Qt::ElideRight);
+    layout->draw(&pa, rect.topLeft());
 }
 
 void AppBodyLabel::updateLineCount()
 {
-    QTextLayout layout(m_text, font());
-    QTextOption option;
-
-    option.setWrapMode(QTextOption::WrapAtWordBoundaryOrAnywhere);
-    option.setAlignment(m_alignment);
-
-    layout.setTextOption(option);
-
-    m_lineCount = drawText(nullptr, QRectF(QPointF(0, 0), QSizeF(width(), INT_MAX)), fontMetrics().height(), &layout, Qt::ElideNone);
+    m_lineCount = TextLayoutCache::ref().layout(m_text, font(), width(), 0, m_alignment, layoutDirection())->lineCount();
 }
@@ -31,6 +31,7 @@ public:
 #endif
 
 private:
+    // 按控件的字体换行后放入 rect,超出时省略,fm 只用于兼容旧的接口
     const QString holdTextInRect(const QFontMetrics &fm, const QString &text, const QRect &rect) const;
     void resizeEvent(QResizeEvent *e) override;
     void paintEvent(QPaintEvent *event) override;
@@ -20,6 +20,7 @@
 #include <QMoveEvent>
 #include <QBoxLayout>
 #include <QParallelAnimationGroup>
+#include <QGraphicsOpacityEffect>
 #include <QTextDocument>
 #include <QWindow>
 
@@ -45,7 +46,8 @@ Bubble::Bubble(QWidget *parent, EntityPtr entity, OSD::ShowStyle style)
     m_beforeLocked =! m_userInter->locked();
     setEntity(entity);
 
-    installEventFilter(this);
+    if (!isOverlayItem())
+        installEventFilter(this);
 }
 
 EntityPtr Bubble::entity() const
@@ -110,6 +112,14 @@ void Bubble::updateGeometry()
     Q_EMIT resetGeometry();
 }
 
+QRect Bubble::bubbleGeometry() const
+{
+    if (!isOverlayItem())
+        return geometry();
+
+    return QRect(parentWidget()->mapToGlobal(pos()), size());
+}
+
 void Bubble::mousePressEvent(QMouseEvent *event)
 {
     if (!isEnabled()) {
@@ -222,14 +232,16 @@ void Bubble::initUI()
 
     setAttribute(Qt::WA_TranslucentBackground);
     setAttribute(Qt::WA_DeleteOnClose);
-    setWindowFlags(Qt::WindowStaysOnTopHint | Qt::Tool | Qt::X11BypassWindowManagerHint);
+    if (!isOverlayItem())
+        setWindowFlags(Qt::WindowStaysOnTopHint | Qt::Tool | Qt::X11BypassWindowManagerHint);
+    // 叠加模式下DTK会把同一窗口中所有气泡的模糊区域合并后设置到叠加窗口上
     setBlendMode(DBlurEffectWidget::BehindWindowBlend);
     setMaskColor(DBlurEffectWidget::AutoColor);
     setMouseTracking(true);
 
     setFixedWidth(OSD::BubbleWidth(OSD::BUBBLEWINDOW));
     resize(OSD::BubbleSize(OSD::BUBBLEWINDOW));
-    if (!qgetenv("WAYLAND_DISPLAY").isEmpty()) {
+    if (!isOverlayItem() && !qgetenv("WAYLAND_DISPLAY").isEmpty()) {
         setAttribute(Qt::WA_NativeWindow);
         windowHandle()->setProperty("_d_dwayland_window-type", "tooltip");
     }
@@ -250,8 +262,8 @@ void Bubble::initUI()
 
     setLayout(layout);
 
-    // wayland环境下，下面关于x11相关代码是多余的
-    if (qgetenv("WAYLAND_DISPLAY").isEmpty()) {
+    // wayland环境下，下面关于x11相关代码是多余的,叠加模式下由叠加窗口统一设置
+    if (!isOverlayItem() && qgetenv("WAYLAND_DISPLAY").isEmpty()) {
         QTimer::singleShot(0, this, [ = ] {
             // FIXME: 锁屏不允许显示任何通知，而通知又需要禁止窗管进行管理，
             // 为了避免二者的冲突，将气泡修改为dock，保持在其他程序置顶，又不会显示在锁屏之上。
@@ -298,7 +310,7 @@ void Bubble::onDelayQuit()
 
 void Bubble::updateContent()
 {
-    m_body->setTitle(m_entity->summary());
+    m_body->setTitle(BubbleTool::displaySummary(m_entity));
     if(m_entity->isShowPreview()) {
         m_body->setText(OSD::removeHTML(m_entity->body()));
         if (m_beforeLocked) {
@@ -317,16 +329,14 @@ void Bubble::updateContent()
 
 bool Bubble::containsMouse() const
 {
-    return geometry().contains(QCursor::pos());
+    return bubbleGeometry().contains(QCursor::pos());
 }
 
 void Bubble::startMove(const QRect &startRect, const QRect &endRect, bool needDelete)
 {
     QPointer<QParallelAnimationGroup> group = new QParallelAnimationGroup(this);
 
-    QPropertyAnimation *geometryAni = new QPropertyAnimation(this, "geometry", this);
-    geometryAni->setStartValue(startRect);
-    geometryAni->setEndValue(endRect);
+    QPropertyAnimation *geometryAni = createMoveAnimation(startRect, endRect);
     geometryAni->setEasingCurve(QEasingCurve::Linear);
 
     // 保证动画的速度恒定为 72pix/300ms
@@ -337,7 +347,16 @@ void Bubble::startMove(const QRect &startRect, const QRect &endRect, bool needDe
     group->addAnimation(geometryAni);
     // 需要删除时增加透明渐变效果
     if (needDelete) {
-        QPropertyAnimation *opacityAni = new QPropertyAnimation(this, "windowOpacity", this);
+        // 子控件没有窗口透明度,叠加模式下使用透明度效果
+        QObject *opacityTarget = this;
+        QByteArray opacityProperty = "windowOpacity";
+        if (isOverlayItem()) {
+            QGraphicsOpacityEffect *effect = new QGraphicsOpacityEffect(this);
+            setGraphicsEffect(effect);
+            opacityTarget = effect;
+            opacityProperty = "opacity";
+        }
+        QPropertyAnimation *opacityAni = new QPropertyAnimation(opacityTarget, opacityProperty, this);
         opacityAni->setStartValue(1);
         opacityAni->setEndValue(0);
         opacityAni->setDuration(animationTime + int(-BubbleStartPos * 1.0 / 72 * AnimationTime));
@@ -350,7 +369,7 @@ void Bubble::startMove(const QRect &startRect, const QRect &endRect, bool needDe
             if (!group.isNull())
                 group->stop();
             // 当接收到该信号，则表示已经geometry已经更新，直接使用即可
-            setFixedGeometry(geometry());
+            setFixedGeometry(bubbleGeometry());
         });
     }
 
@@ -371,6 +390,11 @@ void Bubble::setBubbleIndex(int index)
 }
 
 void Bubble::setFixedGeometry(QRect rect)
+{
+    setParentGeometry(mapFromScreen(rect));
+}
+
+void Bubble::setParentGeometry(QRect rect)
 {
     //只设置宽度，高度自适应即可，否则大字体的时候显示不全
     setFixedWidth(rect.width());
@@ -378,6 +402,21 @@ void Bubble::setFixedGeometry(QRect rect)
     setGeometry(rect);
 }
 
+QRect Bubble::mapFromScreen(QRect rect) const
+{
+    if (isOverlayItem())
+        rect.moveTopLeft(parentWidget()->mapFromGlobal(rect.topLeft()));
+    return rect;
+}
+
+QPropertyAnimation *Bubble::createMoveAnimation(const QRect &startRect, const QRect &endRect)
+{
+    QPropertyAnimation *animation = new QPropertyAnimation(this, "parentGeometry", this);
+    animation->setStartValue(mapFromScreen(startRect));
+    animation->setEndValue(mapFromScreen(endRect));
+    return animation;
+}
+
 void Bubble::onOpacityChanged(double value)
 {
     setMaskAlpha(value * 255);
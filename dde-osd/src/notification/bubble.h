@@ -14,6 +14,8 @@
 
 #include "constants.h"
 
+class QPropertyAnimation;
+
 using UserInter = org::deepin::dde::SessionManager1;
 
 DWIDGET_USE_NAMESPACE
@@ -29,7 +31,8 @@ class ActionButton;
 class Bubble : public DBlurEffectWidget
 {
     Q_OBJECT
-    Q_PROPERTY(QRect geometry READ geometry WRITE setFixedGeometry)
+    // 动画使用父窗口中的坐标,屏幕坐标通过 createMoveAnimation 转换
+    Q_PROPERTY(QRect parentGeometry READ geometry WRITE setParentGeometry)
 public:
     Bubble(QWidget *parent = nullptr, EntityPtr entity = nullptr,
            OSD::ShowStyle style = OSD::ShowStyle::BUBBLEWINDOW);
@@ -45,6 +48,14 @@ public:
                    bool needDelete = false);            // 负责位置的移动
     void setBubbleIndex(int index);                     // 设置通知的索引,在屏幕分辨率或主屏发生变化用于更新通知位置
     void updateGeometry();                              // 更新通知的位置,分辨率被修改时使用
+    QRect bubbleGeometry() const;                       // 气泡在屏幕上的位置,叠加模式下由父窗口的坐标转换得到
+    bool isOverlayItem() const { return parentWidget(); } // 是否作为叠加窗口的子控件显示
+    QRect mapFromScreen(QRect rect) const;              // 屏幕坐标转换为父窗口中的坐标,独立窗口时不变
+    /*!
+     * \~chinese \name createMoveAnimation
+     * \~chinese \brief 创建从屏幕坐标 startRect 移动到 endRect 的动画,叠加模式下起止位置转换为叠加窗口中的坐标
+     */
+    QPropertyAnimation *createMoveAnimation(const QRect &startRect, const QRect &endRect);
 
 Q_SIGNALS:
     void expired(Bubble *);                             // 超时消失时发出,动画执行完成后自动删除
@@ -73,6 +84,7 @@ private Q_SLOTS:
     void onOutTimerTimeout();
 
 private:
+    void setParentGeometry(QRect rect);                 // 按父窗口中的坐标设置位置,只设置宽度
     void initUI();
     void initConnections();
     void initTimers();
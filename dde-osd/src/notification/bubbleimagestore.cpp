@@ -0,0 +1,152 @@
+// SPDX-FileCopyrightText: 2024 UnionTech Software Technology Co., Ltd.
+//
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+#include "bubbleimagestore.h"
+
+#include <QDBusArgument>
+#include <QCryptographicHash>
+#include <QDebug>
+
+#include <cerrno>
+#include <cstring>
+#include <sys/mman.h>
+#include <fcntl.h>
+#include <unistd.h>
+
+// 与 BubbleTool::decodeNotificationSpecImageHint 的检查保持一致
+static const int MaxImageSide = 2048;
+static const QStringList ImageHints {
+    "image-data",
+    "image_data",
+    "icon_data"
+};
+
+BubbleImageStore::BubbleImageStore(int capacity)
+    : m_capacity(qMax(1, capacity))
+{
+}
+
+BubbleImageStore::~BubbleImageStore()
+{
+    clear();
+}
+
+QString BubbleImageStore::takeImages(QVariantMap &hints)
+{
+    QString handle;
+
+    // 信号里只发布一个句柄,所以只保存按优先级第一张有效的图片,其余的图片数据直接丢弃
+    for (const QString &hint : ImageHints) {
+        const QVariant &source = hints.value(hint);
+        if (!source.canConvert<QDBusArgument>())
+            continue;
+
+        if (handle.isEmpty())
+            handle = insert(source.value<QDBusArgument>());
+        hints.remove(hint);
+    }
+
+    return handle;
+}
+
+QString BubbleImageStore::insert(const QDBusArgument &argument)
+{
+    int width, height, rowStride, bitsPerSample, channels;
+    bool hasAlpha;
+    QByteArray pixels;
+
+    argument.beginStructure();
+    argument >> width >> height >> rowStride >> hasAlpha >> bitsPerSample >> channels >> pixels;
+    argument.endStructure();
+
+    if (width <= 0 || width >= MaxImageSide || height <= 0 || height >= MaxImageSide
+            || rowStride <= 0 || pixels.isEmpty()) {
+        qWarning() << "Invalid image data, width:" << width << "height:" << height << "rowStride:" << rowStride;
+        return QString();
+    }
+
+    QCryptographicHash hash(QCryptographicHash::Sha1);
+    hash.addData(QString("%1x%2:%3:%4:%5:%6").arg(width).arg(height).arg(rowStride)
+                 .arg(hasAlpha).arg(bitsPerSample).arg(channels).toLatin1());
+    hash.addData(pixels);
+    const QString handle = QString::fromLatin1(hash.result().toHex());
+
+    if (m_images.contains(handle)) {
+        m_recentHandles.removeOne(handle);
+        m_recentHandles.append(handle);
+        return handle;
+    }
+
+    const int fd = createSealedFd(pixels);
+    if (fd < 0)
+        return QString();
+
+    Image image;
+    image.fd = fd;
+    image.width = width;
+    image.height = height;
+    image.rowStride = rowStride;
+    image.hasAlpha = hasAlpha;
+    image.bitsPerSample = bitsPerSample;
+    image.channels = channels;
+    image.size = pixels.size();
+
+    m_images.insert(handle, image);
+    m_recentHandles.append(handle);
+
+    while (m_recentHandles.size() > m_capacity) {
+        const Image &expired = m_images.take(m_recentHandles.takeFirst());
+        ::close(expired.fd);
+    }
+
+    return handle;
+}
+
+BubbleImageStore::Image BubbleImageStore::image(const QString &handle)
+{
+    if (!m_images.contains(handle))
+        return Image();
+
+    m_recentHandles.removeOne(handle);
+    m_recentHandles.append(handle);
+    return m_images.value(handle);
+}
+
+void BubbleImageStore::clear()
+{
+    for (const Image &image : m_images)
+        ::close(image.fd);
+
+    m_images.clear();
+    m_recentHandles.clear();
+}
+
+int BubbleImageStore::createSealedFd(const QByteArray &pixels)
+{
+    const int fd = memfd_create("dde-osd-bubble-image", MFD_CLOEXEC | MFD_ALLOW_SEALING);
+    if (fd < 0) {
+        qWarning() << "memfd_create failed:" << strerror(errno);
+        return -1;
+    }
+
+    qint64 written = 0;
+    while (written < pixels.size()) {
+        const ssize_t ret = ::write(fd, pixels.constData() + written, size_t(pixels.size() - written));
+        if (ret < 0) {
+            if (errno == EINTR)
+                continue;
+            qWarning() << "write image to memfd failed:" << strerror(errno);
+            ::close(fd);
+            return -1;
+        }
+        written += ret;
+    }
+
+    // 密封之后客户端只能只读映射,内容不会再被修改
+    if (fcntl(fd, F_ADD_SEALS, F_SEAL_SHRINK | F_SEAL_GROW | F_SEAL_WRITE | F_SEAL_SEAL) < 0) {
+        qWarning() << "seal memfd failed:" << strerror(errno);
+    }
+
+    return fd;
+}
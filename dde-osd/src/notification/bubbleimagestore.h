@@ -0,0 +1,66 @@
+// SPDX-FileCopyrightText: 2024 UnionTech Software Technology Co., Ltd.
+//
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+#ifndef BUBBLEIMAGESTORE_H
+#define BUBBLEIMAGESTORE_H
+
+#include <QString>
+#include <QVariantMap>
+#include <QStringList>
+#include <QHash>
+
+class QDBusArgument;
+
+/*!
+ * \~chinese \class BubbleImageStore
+ * \~chinese \brief 外部气泡紧凑模式下使用的图片仓库
+ * \~chinese 把通知 hints 中的 image-data 按内容摘要保存到密封的 memfd 中,信号里只携带图片句柄,
+ * \~chinese 外部气泡通过句柄获取一次文件描述符后自行映射,相同的图片只会经过总线一次
+ */
+class BubbleImageStore
+{
+public:
+    explicit BubbleImageStore(int capacity = 16);
+    ~BubbleImageStore();
+
+    struct Image {
+        int fd = -1;
+        int width = 0;
+        int height = 0;
+        int rowStride = 0;
+        bool hasAlpha = false;
+        int bitsPerSample = 0;
+        int channels = 0;
+        int size = 0;
+    };
+
+    /*!
+     * \~chinese \name takeImages
+     * \~chinese \brief 把 hints 中按 image-data、image_data、icon_data 优先级第一张有效的图片移入仓库,
+     * \~chinese 所有图片数据都从 hints 中删除
+     * \~chinese \return 图片句柄,没有图片时返回空字符串
+     */
+    QString takeImages(QVariantMap &hints);
+    /*!
+     * \~chinese \name insert
+     * \~chinese \brief 保存一张通知规范格式(iiibiiay)的图片
+     * \~chinese \return 图片句柄,数据无效时返回空字符串
+     */
+    QString insert(const QDBusArgument &argument);
+
+    bool contains(const QString &handle) const { return m_images.contains(handle); }
+    Image image(const QString &handle);
+    int count() const { return m_images.size(); }
+    void clear();
+
+private:
+    static int createSealedFd(const QByteArray &pixels);
+
+private:
+    int m_capacity;
+    QHash<QString, Image> m_images;
+    QStringList m_recentHandles;    // 最近使用的句柄在最后,超出容量时淘汰最前面的
+};
+
+#endif // BUBBLEIMAGESTORE_H
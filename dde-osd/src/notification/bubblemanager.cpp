@@ -13,6 +13,8 @@
 #include "notification-center/notifycenterwidget.h"
 #include "dbusdockinterface.h"
 #include "signalbridge.h"
+#include "bubbleimagestore.h"
+#include "bubbleoverlay.h"
 
 #include <DDesktopServices>
 
@@ -22,9 +24,12 @@
 #include <QDebug>
 #include <QScreen>
 #include <QDBusContext>
+#include <QDBusArgument>
+#include <QDBusServiceWatcher>
 #include <QDateTime>
 #include <QGSettings>
 #include <QLoggingCategory>
+#include <QCryptographicHash>
 
 #include <algorithm>
 
@@ -47,6 +52,8 @@ BubbleManager::BubbleManager(AbstractPersistence *persistence, AbstractNotifySet
     , m_notifySettings(setting)
     , m_notifyCenter(new NotifyCenterWidget(m_persistence))
     , m_trickTimer(new QTimer(this))
+    , m_compactWatcher(new QDBusServiceWatcher(this))
+    , m_imageStore(new BubbleImageStore)
 {
     if (!useBuiltinBubble()) {
         qCDebug(notifiyBubbleLog) << "Default does not use built-in bubble.";
@@ -69,6 +76,12 @@ BubbleManager::BubbleManager(AbstractPersistence *persistence, AbstractNotifySet
     m_trickTimer->setInterval(300);
     m_trickTimer->setSingleShot(true);
 
+    if (useBuiltinBubble() && QGSettings::isSchemaInstalled("com.deepin.dde.osd")) {
+        m_osdSettings = new QGSettings("com.deepin.dde.osd", "/com/deepin/dde/osd/", this);
+        if (m_osdSettings->keys().contains("bubbleOverlay"))
+            m_overlayBubble = m_osdSettings->get("bubble-overlay").toBool();
+    }
+
     initConnections();
     geometryChanged();
 
@@ -93,10 +106,14 @@ BubbleManager::BubbleManager(AbstractPersistence *persistence, AbstractNotifySet
 BubbleManager::~BubbleManager()
 {
     if (!m_bubbleList.isEmpty()) qDeleteAll(m_bubbleList);
+    qDeleteAll(m_overlays);
+    m_overlays.clear();
 
     m_oldEntities.clear();
     delete m_notifyCenter;
     m_notifyCenter = nullptr;
+    delete m_imageStore;
+    m_imageStore = nullptr;
 }
 
 void BubbleManager::CloseNotification(uint id)
@@ -118,11 +135,12 @@ void BubbleManager::CloseNotification(uint id)
         }
     }
 
-    foreach (auto notify, m_oldEntities) {
-        if (notify->replacesId() == str_id) {
-            //m_persistence->addOne(notify);
-            m_oldEntities.removeOne(notify);
+    for (auto it = m_oldEntities.begin(); it != m_oldEntities.end();) {
+        if (it->replacesId() == id) {
+            it = m_oldEntities.erase(it);
             qDebug() << "CloseNotification : id" << str_id;
+        } else {
+            ++it;
         }
     }
 }
@@ -216,6 +234,13 @@ uint BubbleManager::Notify(const QString &appName, uint replacesId,
     notification->setShowPreview(enablePreview);
     notification->setShowInNotifyCenter(showInNotifyCenter);
 
+    if (replacesId == 0) {
+        const bool showBubble = systemNotification || ((!lockscree || lockscreeshow) && !dndmode);
+        if (EntityPtr previous = mergeDuplicate(notification, showBubble)) {
+            return previous->id();
+        }
+    }
+
     if (playsound && !dndmode) {
         QString action;
         //接收蓝牙文件时，只在发送完成后才有提示音,"cancel"表示正在发送文件
@@ -248,7 +273,7 @@ uint BubbleManager::Notify(const QString &appName, uint replacesId,
                 pushBubble(notification);
             } else {
                 qCDebug(notifiyBubbleLog) << "Publish ShowBubble, id:" << notification->id();
-                Q_EMIT ShowBubble(appName, replacesId, appIcon, summary, body, actions, hints, expireTimeout, params);
+                publishBubble(appName, replacesId, appIcon, summary, body, actions, hints, expireTimeout, params);
             }
         } else if (lockscree && !lockscreeshow) { // 锁屏不显示通知
             if (showInNotifyCenter) { // 开启在通知中心显示才加入通知中心
@@ -264,7 +289,7 @@ uint BubbleManager::Notify(const QString &appName, uint replacesId,
                     pushBubble(notification);
                 } else {
                     qCDebug(notifiyBubbleLog) << "Publish ShowBubble, id:" << notification->id();
-                    Q_EMIT ShowBubble(appName, replacesId, appIcon, summary, body, actions, hints, expireTimeout, params);
+                    publishBubble(appName, replacesId, appIcon, summary, body, actions, hints, expireTimeout, params);
                 }
             } else if (showInNotifyCenter) {
                 m_persistence->addOne(notification);
@@ -281,7 +306,7 @@ uint BubbleManager::Notify(const QString &appName, uint replacesId,
                 params["storageId"] = notification->storageId();
             }
             qCDebug(notifiyBubbleLog) << "Publish ShowBubble, replaceId:" << notification->replacesId();
-            Q_EMIT ShowBubble(appName, replacesId, appIcon, summary, body, actions, hints, expireTimeout, params);
+            publishBubble(appName, replacesId, appIcon, summary, body, actions, hints, expireTimeout, params);
         }
     }
 
@@ -299,7 +324,7 @@ void BubbleManager::pushBubble(EntityPtr notify)
         return;
 
     if (m_bubbleList.size() == BubbleEntities + BubbleOverLap) {
-        m_oldEntities.push_front(m_bubbleList.last()->entity());
+        m_oldEntities.push_front(m_bubbleList.last()->entity()->record());
         m_bubbleList.last()->setVisible(false);
         m_bubbleList.last()->deleteLater();
         m_bubbleList.removeLast();
@@ -332,6 +357,26 @@ void BubbleManager::popAllBubblesImmediately()
     m_bubbleList.clear();
 }
 
+void BubbleManager::publishBubble(const QString &appName, uint replacesId, const QString &appIcon,
+                                  const QString &summary, const QString &body, const QStringList &actions,
+                                  QVariantMap hints, int expireTimeout, QVariantMap bubbleParams)
+{
+    if (m_compactListeners.isEmpty()) {
+        Q_EMIT ShowBubble(appName, replacesId, appIcon, summary, body, actions, hints, expireTimeout, bubbleParams);
+        return;
+    }
+
+    // 有调用者使用紧凑格式时两个信号都不携带图片数据,只保留句柄,外部气泡通过 GetBubbleImage 获取
+    const QString &imageHandle = m_imageStore->takeImages(hints);
+    if (!imageHandle.isEmpty()) {
+        bubbleParams["imageHandle"] = imageHandle;
+    }
+
+    qCDebug(notifiyBubbleLog) << "Publish ShowCompactBubble, id:" << bubbleParams["id"] << ", image:" << imageHandle;
+    Q_EMIT ShowBubble(appName, replacesId, appIcon, summary, body, actions, hints, expireTimeout, bubbleParams);
+    Q_EMIT ShowCompactBubble(appName, replacesId, appIcon, summary, body, actions, hints, expireTimeout, bubbleParams);
+}
+
 bool BubbleManager::useBuiltinBubble() const
 {
     static bool isTreeLand = qEnvironmentVariable("DDE_CURRENT_COMPOSITER") == QString("TreeLand");
@@ -345,7 +390,7 @@ bool BubbleManager::useBuiltinBubble() const
 void BubbleManager::refreshBubble()
 {
     if (m_bubbleList.size() < BubbleEntities + BubbleOverLap + 1 && !m_oldEntities.isEmpty()) {
-        auto notify = m_oldEntities.takeFirst();
+        auto notify = std::make_shared<NotificationEntity>(m_oldEntities.takeFirst());
         Bubble *bubble = createBubble(notify, BubbleEntities + BubbleOverLap - 1);
         if (bubble)
             m_bubbleList.push_back(bubble);
@@ -363,8 +408,8 @@ void BubbleManager::pushAnimation(Bubble *bubble)
         QRect startRect = getLastStableRect(index - 1);
         QRect endRect = getBubbleGeometry(index);
         QPointer<Bubble> item = m_bubbleList.at(index);
-        if (item->geometry() != endRect) { //动画中
-            startRect = item->geometry();
+        if (item->bubbleGeometry() != endRect) { //动画中
+            startRect = item->bubbleGeometry();
         }
         if (bubble != nullptr) {
             item->setBubbleIndex(index);
@@ -393,8 +438,8 @@ void BubbleManager::popAnimation(Bubble *bubble)
         if (index == BubbleEntities + BubbleOverLap) {
             item->show();
         }
-        if (item->geometry() != endRect) { //动画中
-            startRect = item->geometry();
+        if (item->bubbleGeometry() != endRect) { //动画中
+            startRect = item->bubbleGeometry();
         }
         if (bubble != nullptr) {
             item->setBubbleIndex(index);
@@ -455,7 +500,7 @@ QRect BubbleManager::getLastStableRect(int index)
 {
     QRect rect = getBubbleGeometry(0);
     for (int i = index - 1; i > 0; --i) {
-        if (i >= m_bubbleList.size() || m_bubbleList.at(i)->geometry() != getBubbleGeometry(i)) {
+        if (i >= m_bubbleList.size() || m_bubbleList.at(i)->bubbleGeometry() != getBubbleGeometry(i)) {
             continue;
         }
         rect = getBubbleGeometry(i);
@@ -536,6 +581,7 @@ QString BubbleManager::GetRecordsFromId(int rowCount, const QString &offsetId)
 void BubbleManager::RemoveRecord(const QString &id)
 {
     m_persistence->removeOne(id);
+    removeRecentNotify(id);
 
     QFile file(CachePath + id + ".png");
     file.remove();
@@ -544,6 +590,7 @@ void BubbleManager::RemoveRecord(const QString &id)
 void BubbleManager::ClearRecords()
 {
     m_persistence->removeAll();
+    m_recentNotifies.clear();
 
     QDir dir(CachePath);
     dir.removeRecursively();
@@ -572,6 +619,57 @@ void BubbleManager::ReplaceBubble(bool replace)
     }
 }
 
+void BubbleManager::SetCompactBubble(bool compact)
+{
+    const QString service = calledFromDBus() ? message().service() : QString();
+    if (!compact) {
+        removeCompactListener(service);
+        return;
+    }
+
+    if (m_compactListeners.contains(service))
+        return;
+
+    m_compactListeners.insert(service);
+    if (!service.isEmpty())
+        m_compactWatcher->addWatchedService(service);
+    qCDebug(notifiyBubbleLog) << "Compact bubble listener added:" << service;
+}
+
+void BubbleManager::removeCompactListener(const QString &service)
+{
+    if (!m_compactListeners.remove(service))
+        return;
+
+    if (!service.isEmpty())
+        m_compactWatcher->removeWatchedService(service);
+    qCDebug(notifiyBubbleLog) << "Compact bubble listener removed:" << service;
+
+    if (m_compactListeners.isEmpty()) {
+        m_imageStore->clear();
+    }
+}
+
+QDBusUnixFileDescriptor BubbleManager::GetBubbleImage(const QString &handle, QVariantMap &info)
+{
+    const BubbleImageStore::Image &image = m_imageStore->image(handle);
+    if (image.fd < 0) {
+        sendErrorReply(QDBusError::InvalidArgs, QString("GetBubbleImage() failed, the image: [%1] does not exist.").arg(handle));
+        return QDBusUnixFileDescriptor();
+    }
+
+    info["width"] = image.width;
+    info["height"] = image.height;
+    info["rowStride"] = image.rowStride;
+    info["hasAlpha"] = image.hasAlpha;
+    info["bitsPerSample"] = image.bitsPerSample;
+    info["channels"] = image.channels;
+    info["size"] = image.size;
+
+    // QDBusUnixFileDescriptor 会复制一份描述符,仓库中的描述符仍然有效
+    return QDBusUnixFileDescriptor(image.fd);
+}
+
 void BubbleManager::HandleBubbleEnd(uint type, uint id, const QVariantMap bubbleParams, const QVariantMap selectedHints)
 {
     qCDebug(notifiyBubbleLog) << "HandleBubbleEnd, type:" << type << ", bubbleId:" << id
@@ -615,6 +713,7 @@ void BubbleManager::HandleBubbleEnd(uint type, uint id, const QVariantMap bubble
             return;
         }
         m_persistence->removeOne(storageId);
+        removeRecentNotify(storageId);
     }
     }
 }
@@ -682,6 +781,26 @@ void BubbleManager::SetAppInfo(const QString &id, const uint item, const QDBusVa
     m_notifySettings->setAppSetting(id, static_cast<NotifySettings::AppConfigurationItem>(item), var.variant());
 }
 
+QVariantMap BubbleManager::GetAppInfos(const QStringList &ids)
+{
+    return m_notifySettings->getAppSettings(ids);
+}
+
+void BubbleManager::SetAppInfos(const QVariantMap &infos)
+{
+    // DBus 传入的嵌套字典是 QDBusArgument,需要先转换为 QVariantMap
+    QVariantMap settings;
+    for (auto it = infos.cbegin(); it != infos.cend(); ++it) {
+        const QVariant &value = it.value();
+        if (value.userType() == qMetaTypeId<QDBusArgument>()) {
+            settings.insert(it.key(), qdbus_cast<QVariantMap>(value.value<QDBusArgument>()));
+        } else {
+            settings.insert(it.key(), value.toMap());
+        }
+    }
+    m_notifySettings->setAppSettings(settings);
+}
+
 void BubbleManager::SetSystemInfo(uint item, const QDBusVariant var)
 {
     m_notifySettings->setSystemSetting(static_cast<NotifySettings::SystemConfigurationItem>(item), var.variant());
@@ -784,7 +903,12 @@ void BubbleManager::updateGeometry()
     for (int index = 0; index < m_bubbleList.count(); index++) {
         auto item = m_bubbleList[index];
         if (!item.isNull()) {
-            item->setGeometry(getBubbleGeometry(index));
+            if (item->isOverlayItem()) {
+                moveToOverlay(item, bubbleOverlay());
+                item->setFixedGeometry(getBubbleGeometry(index));
+            } else {
+                item->setGeometry(getBubbleGeometry(index));
+            }
             item->updateGeometry();
         }
     }
@@ -807,11 +931,43 @@ void BubbleManager::initConnections()
         connect(qApp->primaryScreen(), &QScreen::geometryChanged, this, [ = ] {
             updateGeometry();
         });
+
+        // 屏幕移除时把上面的气泡移动到主屏的叠加窗口
+        connect(qApp, &QGuiApplication::screenRemoved, this, [ this ](QScreen *screen) {
+            BubbleOverlay *overlay = m_overlays.take(screen);
+            if (!overlay)
+                return;
+
+            if (screen != qApp->primaryScreen()) {
+                for (const QPointer<Bubble> &bubble : m_bubbleList) {
+                    if (bubble && bubble->parentWidget() == overlay)
+                        moveToOverlay(bubble, bubbleOverlay());
+                }
+            }
+            overlay->deleteLater();
+        });
+
+        if (m_osdSettings) {
+            connect(m_osdSettings, &QGSettings::changed, this, [ this ](const QString &key) {
+                if (key != "bubbleOverlay")
+                    return;
+
+                // 只影响之后创建的气泡,正在显示的气泡保持原来的方式直到消失
+                m_overlayBubble = m_osdSettings->get("bubble-overlay").toBool();
+                qCDebug(notifiyBubbleLog) << "Bubble overlay mode:" << m_overlayBubble;
+            });
+        }
     }
 
+    // 使用紧凑格式的调用者退出总线时不再为它发送紧凑信号
+    m_compactWatcher->setConnection(QDBusConnection::sessionBus());
+    m_compactWatcher->setWatchMode(QDBusServiceWatcher::WatchForUnregistration);
+    connect(m_compactWatcher, &QDBusServiceWatcher::serviceUnregistered, this, &BubbleManager::removeCompactListener);
+
     connect(m_notifySettings, &NotifySettings::appSettingChanged, this, [ = ] (const QString &id, const uint &item, QVariant var) {
         Q_EMIT AppInfoChanged(id, item, QDBusVariant(var));
     });
+    connect(m_notifySettings, &NotifySettings::appSettingsChanged, this, &BubbleManager::AppInfosChanged);
     connect(m_notifySettings, &NotifySettings::systemSettingChanged, this, [ = ] (const uint &item, QVariant var) {
         Q_EMIT SystemInfoChanged(item, QDBusVariant(var));
     });
@@ -884,9 +1040,10 @@ bool BubbleManager::calcReplaceId(EntityPtr notify)
             }
         }
 
-        for (int i = 0; i < m_oldEntities.size(); ++i) {
-            if (m_oldEntities.at(i)->replacesId() == notify->replacesId()
-                    && m_oldEntities.at(i)->appName() == notify->appName()) {
+        const uint replacesId = notify->record().replacesId();
+        for (int i = m_oldEntities.size() - 1; i >= 0; --i) {
+            if (m_oldEntities.at(i).replacesId() == replacesId
+                    && m_oldEntities.at(i).appName() == notify->appName()) {
                 m_oldEntities.removeAt(i);
             }
         }
@@ -895,9 +1052,121 @@ bool BubbleManager::calcReplaceId(EntityPtr notify)
     return find;
 }
 
+EntityPtr BubbleManager::mergeDuplicate(EntityPtr notify, bool showBubble)
+{
+    const qint64 now = QDateTime::currentMSecsSinceEpoch();
+    for (auto it = m_recentNotifies.begin(); it != m_recentNotifies.end();) {
+        if (now - it->lastSeen > DuplicateNotifyWindow) {
+            it = m_recentNotifies.erase(it);
+        } else {
+            ++it;
+        }
+    }
+
+    const QByteArray &key = fingerprint(notify);
+    auto it = m_recentNotifies.find(key);
+    if (it == m_recentNotifies.end()) {
+        m_recentNotifies.insert(key, RecentNotify{now, notify});
+        return EntityPtr();
+    }
+
+    it->lastSeen = now;
+    EntityPtr previous = it->entity;
+    const int repeatCount = previous->repeatCount();
+    const QString ctime = previous->ctime();
+    previous->setRepeatCount(repeatCount + 1);
+    previous->setTime(notify->ctime());
+    if (!m_persistence->updateOne(previous)) {
+        // 已有的记录已经被删除,不能再合并,按新通知处理
+        previous->setRepeatCount(repeatCount);
+        previous->setTime(ctime);
+        it->entity = notify;
+        return EntityPtr();
+    }
+    qCDebug(notifiyBubbleLog) << "Merge duplicate notification, id:" << previous->id() << ", count:" << previous->repeatCount();
+
+    if (!showBubble)
+        return previous;
+
+    if (!useBuiltinBubble()) {
+        QVariantMap params;
+        params["id"] = previous->id();
+        params["isShowPreview"] = previous->isShowPreview();
+        params["isShowInNotifyCenter"] = previous->isShowInNotifyCenter();
+        if (!previous->storageId().isEmpty())
+            params["storageId"] = previous->storageId();
+        publishBubble(previous->appName(), previous->id(), previous->appIcon(), previous->summary(), previous->body(),
+                      previous->actions(), previous->hints(), previous->timeout().toInt(), params);
+        return previous;
+    }
+
+    // 气泡还在显示时刷新内容并重新计时,已经消失的重新弹出
+    for (const QPointer<Bubble> &bubble : m_bubbleList) {
+        if (bubble && bubble->entity()->id() == previous->id()) {
+            bubble->setEntity(previous);
+            return previous;
+        }
+    }
+    for (NotificationRecord &record : m_oldEntities) {
+        if (record.id() == previous->id()) {
+            record = previous->record();
+            return previous;
+        }
+    }
+    pushBubble(previous);
+
+    return previous;
+}
+
+void BubbleManager::removeRecentNotify(const QString &storageId)
+{
+    if (storageId.isEmpty())
+        return;
+
+    for (auto it = m_recentNotifies.begin(); it != m_recentNotifies.end();) {
+        if (it->entity->storageId() == storageId) {
+            it = m_recentNotifies.erase(it);
+        } else {
+            ++it;
+        }
+    }
+}
+
+QByteArray BubbleManager::fingerprint(EntityPtr notify)
+{
+    QCryptographicHash hash(QCryptographicHash::Md5);
+    auto addField = [&hash](const QString &field) {
+        hash.addData(field.simplified().toUtf8());
+        hash.addData("\0", 1);
+    };
+
+    addField(notify->appName());
+    addField(notify->appIcon());
+    addField(notify->summary());
+    addField(notify->body());
+
+    // 动作不同的通知点击后执行的操作不同,不能合并
+    const QStringList &actions = notify->actions();
+    addField(QString::number(actions.size()));
+    for (const QString &action : actions)
+        addField(action);
+
+    const QVariantMap &hints = notify->hints();
+    for (auto it = hints.constBegin(); it != hints.constEnd(); ++it) {
+        if (!it.key().startsWith("x-deepin-action-"))
+            continue;
+        addField(it.key());
+        addField(it.value().toString());
+    }
+
+    hash.addData(BubbleTool::imageDigest(hints));
+
+    return hash.result();
+}
+
 Bubble *BubbleManager::createBubble(EntityPtr notify, int index)
 {
-    Bubble *bubble = new Bubble(nullptr, notify);
+    Bubble *bubble = new Bubble(m_overlayBubble ? bubbleOverlay() : nullptr, notify);
     bubble->setMaskAlpha(static_cast<quint8>(m_appearance->opacity() * 255));
     connect(m_appearance, &Appearance::OpacityChanged, bubble, &Bubble::onOpacityChanged);
     connect(bubble, &Bubble::expired, this, &BubbleManager::bubbleExpired);
@@ -905,6 +1174,7 @@ Bubble *BubbleManager::createBubble(EntityPtr notify, int index)
     connect(bubble, &Bubble::actionInvoked, this, &BubbleManager::bubbleActionInvoked);
     connect(bubble, &Bubble::processed, this, [this](EntityPtr ptr){
         m_persistence->removeOne(ptr->storageId());
+        removeRecentNotify(ptr->storageId());
     });
     connect(bubble, &Bubble::notProcessedYet, this, [ this ](EntityPtr ptr) {
         if (!ptr->isShowInNotifyCenter()) {
@@ -923,12 +1193,9 @@ Bubble *BubbleManager::createBubble(EntityPtr notify, int index)
         QRect startRect = endRect;
         startRect.setHeight(1);
 
-        bubble->setProperty("geometry",0);
         bubble->show();
 
-        QPropertyAnimation *ani = new QPropertyAnimation(bubble, "geometry", this);
-        ani->setStartValue(startRect);
-        ani->setEndValue(endRect);
+        QPropertyAnimation *ani = bubble->createMoveAnimation(startRect, endRect);
 
         int animationTime = int(endRect.height() * 1.0 / 72 * AnimationTime);
         ani->setDuration(animationTime);
@@ -939,3 +1206,30 @@ Bubble *BubbleManager::createBubble(EntityPtr notify, int index)
 
     return bubble;
 }
+
+BubbleOverlay *BubbleManager::bubbleOverlay()
+{
+    QScreen *screen = QGuiApplication::screenAt(m_currentDisplayRect.center());
+    if (!screen)
+        screen = qApp->primaryScreen();
+
+    BubbleOverlay *&overlay = m_overlays[screen];
+    if (!overlay) {
+        overlay = new BubbleOverlay(screen);
+        overlay->setAccessibleName("BubbleOverlay");
+    }
+
+    return overlay;
+}
+
+void BubbleManager::moveToOverlay(Bubble *bubble, BubbleOverlay *overlay)
+{
+    if (!bubble || !overlay || bubble->parentWidget() == overlay)
+        return;
+
+    const QRect rect = bubble->bubbleGeometry();
+    const bool visible = bubble->isVisibleTo(bubble->parentWidget());
+    bubble->setParent(overlay);
+    bubble->setFixedGeometry(rect);
+    bubble->setVisible(visible);
+}
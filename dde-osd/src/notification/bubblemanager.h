@@ -9,10 +9,12 @@
 #include <QStringList>
 #include <QVariantMap>
 #include <QQueue>
+#include <QSet>
 #include <QDesktopWidget>
 #include <QApplication>
 #include <QGuiApplication>
 #include <QTimer>
+#include <QDBusUnixFileDescriptor>
 
 #include "org_deepin_dde_sessionmanager1.h"
 #include "org_deepin_dde_soundeffect1.h"
@@ -24,6 +26,7 @@
 
 #include "bubble.h"
 #include "constants.h"
+#include "notificationrecord.h"
 
 using Appearance = org::deepin::dde::Appearance1;
 using UserInter = org::deepin::dde::SessionManager1;
@@ -59,6 +62,10 @@ class NotifySettings;
 class AbstractNotifySetting;
 
 class DBusDockInterface;
+class BubbleImageStore;
+class BubbleOverlay;
+class QGSettings;
+class QDBusServiceWatcher;
 
 class BubbleManager : public QObject, public QDBusContext
 {
@@ -95,11 +102,14 @@ Q_SIGNALS:
     void RecordAdded(const QString &);
     void AppInfoChanged(const QString &id, uint item, QDBusVariant var);
     void SystemInfoChanged(uint item, QDBusVariant var);
+    void AppInfosChanged(const QVariantMap &infos);
     void AppAddedSignal(const QString &id);
     void AppRemovedSignal(const QString &id);
 
-    // Using external bubbles
+    // Using external bubbles, image data is replaced by bubbleParams["imageHandle"] while any caller uses compact payloads
     void ShowBubble(const QString &, uint replacesId, const QString &, const QString &, const QString &, const QStringList &, const QVariantMap, int, const QVariantMap bubbleParams);
+    // Using external bubbles with compact payloads, image data is replaced by bubbleParams["imageHandle"]
+    void ShowCompactBubble(const QString &, uint replacesId, const QString &, const QString &, const QString &, const QStringList &, const QVariantMap, int, const QVariantMap bubbleParams);
 
     // 旧接口之后废弃
     void appAdded(QString appName);
@@ -167,6 +177,18 @@ public Q_SLOTS:
     /*!
      */
     void ReplaceBubble(bool replace);
+    /*!
+     * \~chinese \name SetCompactBubble
+     * \~chinese \brief 调用者是否使用紧凑格式的外部气泡,有调用者开启时在 ShowBubble 之外再发送 ShowCompactBubble 信号,
+     * \~chinese 两个信号 hints 中的图片数据都替换为图片句柄;调用者退出总线或者关闭后不再为它保存图片
+     */
+    void SetCompactBubble(bool compact);
+    /*!
+     * \~chinese \name GetBubbleImage
+     * \~chinese \brief 根据图片句柄获取图片,返回只读的 memfd 文件描述符
+     * \~chinese \param handle:图片句柄 info:图片的宽、高、行字节数、通道数等信息
+     */
+    QDBusUnixFileDescriptor GetBubbleImage(const QString &handle, QVariantMap &info);
     /*!
      * \brief HandleBubbleEnd
      * 响应bubble结束
@@ -181,6 +203,17 @@ public Q_SLOTS:
     QDBusVariant GetSystemInfo(uint item);
     void SetAppInfo(const QString &id, uint item, const QDBusVariant var);
     void SetSystemInfo(uint item, const QDBusVariant var);
+    /*!
+     * \~chinese \name GetAppInfos
+     * \~chinese \brief 一次获取多个应用的全部设置,返回 应用id -> (设置项编号 -> 值)
+     */
+    QVariantMap GetAppInfos(const QStringList &ids);
+    /*!
+     * \~chinese \name SetAppInfos
+     * \~chinese \brief 一次修改多个应用的设置,参数格式和 GetAppInfos 的返回值相同,
+     * \~chinese 有变化的设置项通过 AppInfosChanged 一次通知
+     */
+    void SetAppInfos(const QVariantMap &infos);
 
     // 旧接口之后废弃
     QString getAllSetting();
@@ -234,6 +267,16 @@ private:
      * \~chinese \return 有相同的ReplaceId返回true,没有返回false
      */
     bool calcReplaceId(EntityPtr notify);
+    /*!
+     * \~chinese \name mergeDuplicate
+     * \~chinese \brief 短时间内收到应用、标题、内容和图片都相同的通知时,只增加已有通知的重复次数,
+     * \~chinese 刷新已有的气泡和通知记录,不再创建新的气泡和数据库记录
+     * \~chinese \param notify:新收到的通知 showBubble:当前是否需要显示气泡
+     * \~chinese \return 合并到已有通知时返回已有的通知,否则返回空
+     */
+    EntityPtr mergeDuplicate(EntityPtr notify, bool showBubble);
+    void removeRecentNotify(const QString &storageId);
+    static QByteArray fingerprint(EntityPtr notify);
 
     bool checkControlCenterExistence();
 
@@ -263,6 +306,16 @@ private:
     void popAllBubblesImmediately();
 
     bool useBuiltinBubble() const;
+    /*!
+     * \~chinese \name bubbleOverlay
+     * \~chinese \brief 叠加模式下返回当前显示气泡的屏幕对应的叠加窗口,没有时创建
+     */
+    BubbleOverlay *bubbleOverlay();
+    void moveToOverlay(Bubble *bubble, BubbleOverlay *overlay);   // 把叠加模式的气泡移动到另一个叠加窗口
+    void publishBubble(const QString &appName, uint replacesId, const QString &appIcon,
+                       const QString &summary, const QString &body, const QStringList &actions,
+                       QVariantMap hints, int expireTimeout, QVariantMap bubbleParams);
+    void removeCompactListener(const QString &service);        // 调用者不再使用紧凑格式,没有调用者时清空图片仓库
 private:
     int m_replaceCount = 0;
     QString m_configFile;
@@ -271,9 +324,16 @@ private:
     OSD::DockPosition m_dockPos;
     int m_dockMode;
 
-    QList<EntityPtr> m_oldEntities;
+    QList<NotificationRecord> m_oldEntities;    // 超出显示数量被隐藏的通知
     QList<QPointer<Bubble>> m_bubbleList;
 
+    struct RecentNotify {
+        qint64 lastSeen;
+        EntityPtr entity;
+    };
+    // 最近收到的通知的指纹,用于合并短时间内重复的通知
+    QHash<QByteArray, RecentNotify> m_recentNotifies;
+
     AbstractPersistence *m_persistence;
     Login1ManagerInterface *m_login1ManagerInterface;
     DisplayInter *m_displayInter;
@@ -290,6 +350,13 @@ private:
     DBusDockInterface *m_dockInter;
     QTimer* m_trickTimer; // 防止300ms内重复按键
     bool m_useBuiltinBubble = true;
+    QSet<QString> m_compactListeners;    // 使用紧凑格式的调用者的总线名称
+    QDBusServiceWatcher *m_compactWatcher;
+    BubbleImageStore *m_imageStore;
+    // 叠加模式下所有气泡作为每个屏幕上一个透明窗口的子控件显示,否则每个气泡是单独的窗口
+    bool m_overlayBubble = false;
+    QGSettings *m_osdSettings = nullptr;
+    QHash<QScreen *, BubbleOverlay *> m_overlays;
 };
 
 #endif // BUBBLEMANAGER_H
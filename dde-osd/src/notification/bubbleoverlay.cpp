@@ -0,0 +1,100 @@
+// SPDX-FileCopyrightText: 2024 UnionTech Software Technology Co., Ltd.
+//
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+#include "bubbleoverlay.h"
+#include "bubbletool.h"
+
+#include <QChildEvent>
+#include <QScreen>
+#include <QTimer>
+#include <QWindow>
+
+BubbleOverlay::BubbleOverlay(QScreen *screen, QWidget *parent)
+    : QWidget(parent)
+    , m_screen(screen)
+    , m_maskTimer(new QTimer(this))
+{
+    setAttribute(Qt::WA_TranslucentBackground);
+    setWindowFlags(Qt::WindowStaysOnTopHint | Qt::Tool | Qt::X11BypassWindowManagerHint);
+    setMouseTracking(true);
+
+    if (!qgetenv("WAYLAND_DISPLAY").isEmpty()) {
+        setAttribute(Qt::WA_NativeWindow);
+        windowHandle()->setProperty("_d_dwayland_window-type", "tooltip");
+    } else {
+        // 与单独的气泡窗口一样设置为dock类型,只需要设置一次
+        QTimer::singleShot(0, this, [ = ] {
+            BubbleTool::register_wm_state(winId());
+        });
+    }
+
+    // 动画过程中同一帧内多个气泡移动,合并为一次输入区域的更新
+    m_maskTimer->setSingleShot(true);
+    m_maskTimer->setInterval(0);
+    connect(m_maskTimer, &QTimer::timeout, this, &BubbleOverlay::updateMask);
+
+    if (m_screen) {
+        connect(m_screen, &QScreen::geometryChanged, this, &BubbleOverlay::updateScreenGeometry);
+    }
+    updateScreenGeometry();
+}
+
+void BubbleOverlay::updateMask()
+{
+    m_maskTimer->stop();
+
+    QRegion region;
+    for (QObject *child : children()) {
+        QWidget *widget = qobject_cast<QWidget *>(child);
+        if (widget && !widget->isWindow() && widget->isVisibleTo(this))
+            region += widget->geometry();
+    }
+
+    if (region.isEmpty()) {
+        hide();
+        return;
+    }
+
+    setMask(region);
+    if (!isVisible())
+        show();
+}
+
+void BubbleOverlay::childEvent(QChildEvent *event)
+{
+    if (event->child()->isWidgetType()) {
+        if (event->added()) {
+            event->child()->installEventFilter(this);
+        } else if (event->removed()) {
+            event->child()->removeEventFilter(this);
+        }
+        m_maskTimer->start();
+    }
+
+    QWidget::childEvent(event);
+}
+
+bool BubbleOverlay::eventFilter(QObject *watched, QEvent *event)
+{
+    Q_UNUSED(watched)
+
+    switch (event->type()) {
+    case QEvent::Move:
+    case QEvent::Resize:
+    case QEvent::ShowToParent:
+    case QEvent::HideToParent:
+        m_maskTimer->start();
+        break;
+    default:
+        break;
+    }
+
+    return false;
+}
+
+void BubbleOverlay::updateScreenGeometry()
+{
+    if (m_screen)
+        setGeometry(m_screen->geometry());
+}
@@ -0,0 +1,40 @@
+// SPDX-FileCopyrightText: 2024 UnionTech Software Technology Co., Ltd.
+//
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+#ifndef BUBBLEOVERLAY_H
+#define BUBBLEOVERLAY_H
+
+#include <QWidget>
+#include <QPointer>
+
+class QScreen;
+class QTimer;
+/*!
+ * \~chinese \class BubbleOverlay
+ * \~chinese \brief 覆盖整个屏幕的透明窗口,叠加模式下所有通知气泡都作为它的子控件显示,
+ * \~chinese 合成器只需要处理一个窗口,模糊区域由 DTK 根据子控件合并后一次性更新,
+ * \~chinese 窗口的输入区域只包含可见的气泡,不影响点击气泡下面的其它窗口
+ */
+class BubbleOverlay : public QWidget
+{
+    Q_OBJECT
+public:
+    explicit BubbleOverlay(QScreen *screen, QWidget *parent = nullptr);
+
+    QScreen *overlayScreen() const { return m_screen; }
+    void updateMask();                                  // 根据可见的气泡立即更新窗口的输入区域
+
+protected:
+    void childEvent(QChildEvent *event) override;
+    bool eventFilter(QObject *watched, QEvent *event) override;
+
+private:
+    void updateScreenGeometry();
+
+private:
+    QPointer<QScreen> m_screen;
+    QTimer *m_maskTimer;
+};
+
+#endif // BUBBLEOVERLAY_H
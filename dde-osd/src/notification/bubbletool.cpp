@@ -6,6 +6,8 @@
 #include "actionbutton.h"
 #include "appicon.h"
 #include "notificationentity.h"
+#include "desktopentryindex.h"
+#include "iconcache.h"
 
 #include <QDebug>
 #include <QDir>
@@ -13,14 +15,11 @@
 #include <QX11Info>
 #include <QSettings>
 #include <QTextCodec>
-
-#include <DDesktopEntry>
+#include <QCryptographicHash>
 
 #include <xcb/xcb.h>
 #include <xcb/xcb_ewmh.h>
 
-DCORE_USE_NAMESPACE
-
 static const QStringList HintsOrder {
     "desktop-entry",
     "image-data",
@@ -166,6 +165,33 @@ void BubbleTool::processIconData(AppIcon *icon, EntityPtr entity)
     }
 }
 
+QPixmap BubbleTool::iconPixmap(EntityPtr entity, const QSize &size, qreal pixelRatio)
+{
+    const QVariantMap &hints = entity->hints();
+    QString imagePath;
+
+    for (const QString &hint : HintsOrder) {
+        const QVariant &source = hints.contains(hint) ? hints[hint] : QVariant();
+
+        if (source.isNull()) continue;
+        if (source.canConvert<QDBusArgument>()) {
+            // 图片已经在气泡显示时保存过,这里只解码不再重复保存
+            const QImage &img = decodeNotificationSpecImageHint(source.value<QDBusArgument>());
+            if (img.isNull())
+                break;
+            QPixmap pixmap = QPixmap::fromImage(img).scaled(size * pixelRatio,
+                                                            Qt::KeepAspectRatioByExpanding,
+                                                            Qt::SmoothTransformation);
+            pixmap.setDevicePixelRatio(pixelRatio);
+            return pixmap;
+        }
+
+        imagePath = source.toString();
+    }
+
+    return IconCache::ref().pixmap(imagePath.isEmpty() ? entity->appIcon() : imagePath, entity->appName(), size, pixelRatio);
+}
+
 void BubbleTool::register_wm_state(WId winid)
 {
     xcb_ewmh_connection_t m_ewmh_connection;
@@ -180,27 +206,51 @@ void BubbleTool::register_wm_state(WId winid)
 
 const QString BubbleTool::getDeepinAppName(const QString &name)
 {
-    QString settingFile = "/usr/share/applications/" + name + ".desktop";
-    DDesktopEntry desktop(settingFile);
-
-    // desktop文件语言配置规则不固定,通过判断 长语言名/短语言名 获取正确的系统语言对应的应用名
-    QString localKey = "default";
-    const QStringList &keys = desktop.keys();
-    QString language = QLocale::system().name();
-    QString shortLanguage = QLocale::system().bcp47Name();
-    if (!keys.filter(language).isEmpty()) {
-        localKey = language;
-    } else if (!keys.filter(shortLanguage).isEmpty()) {
-        localKey = shortLanguage;
+    const DesktopEntryInfo &info = DesktopEntryIndex::instance()->entry(name);
+    if (!info.isValid())
+        return name;
+
+    if (info.vendor == "deepin") {
+        return info.genericName.isEmpty() ? name : info.genericName;
     }
 
-    if (desktop.contains("X-Deepin-Vendor")) {
-        if (desktop.stringValue("X-Deepin-Vendor") == "deepin") {
-            return desktop.localizedValue("GenericName", localKey, "Desktop Entry", name);
+    return info.name.isEmpty() ? name : info.name;
+}
+
+QString BubbleTool::displaySummary(EntityPtr entity)
+{
+    const int count = entity->repeatCount();
+    if (count <= 1)
+        return entity->summary();
+
+    return QString("%1 (%2)").arg(entity->summary()).arg(count);
+}
+
+QByteArray BubbleTool::imageDigest(const QVariantMap &hints)
+{
+    QCryptographicHash hash(QCryptographicHash::Md5);
+
+    for (const QString &hint : HintsOrder) {
+        const QVariant &source = hints.value(hint);
+        if (source.isNull()) continue;
+
+        hash.addData(hint.toUtf8());
+        if (source.canConvert<QDBusArgument>()) {
+            const QDBusArgument argument = source.value<QDBusArgument>();
+            int width, height, rowStride, hasAlpha, bitsPerSample, channels;
+            QByteArray pixels;
+            argument.beginStructure();
+            argument >> width >> height >> rowStride >> hasAlpha >> bitsPerSample >> channels >> pixels;
+            argument.endStructure();
+
+            hash.addData(QByteArray::number(width) + 'x' + QByteArray::number(height) + '@' + QByteArray::number(channels));
+            hash.addData(pixels);
+        } else {
+            hash.addData(source.toString().toUtf8());
         }
     }
 
-    return desktop.localizedValue("Name", localKey, "Desktop Entry", name);
+    return hash.result();
 }
 
 void BubbleTool::actionInvoke(const QString &actionId, EntityPtr entity)
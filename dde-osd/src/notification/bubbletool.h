@@ -24,9 +24,21 @@ public:
     static QString processActions(ActionButton *action, QStringList action_list); //设置功能列表
     static void processIconData(AppIcon *icon, EntityPtr entity); //从entity提取出图标信息设置到icon上
     static void processIconData(EntityPtr entity); //从entity提取出图标信息设置到iconName上
+    /*!
+     * \~chinese \name iconPixmap
+     * \~chinese \brief 按照和 processIconData 相同的规则得到通知的图标,用于不创建 AppIcon 控件直接绘制的场景
+     * \~chinese \param size: 图标的逻辑尺寸; pixelRatio: 设备缩放比
+     */
+    static QPixmap iconPixmap(EntityPtr entity, const QSize &size, qreal pixelRatio);
     static void actionInvoke(const QString &actionId, EntityPtr entity);//从entity提取出命令信息,执行命令产生相应动作
     static void register_wm_state(WId winid);//保持气泡窗口置顶
     static const QString getDeepinAppName(const QString &name);//获取应用名称
+    static QString displaySummary(EntityPtr entity);//获取显示的通知标题,重复的通知带上重复次数
+    /*!
+     * \~chinese \name imageDigest
+     * \~chinese \brief 计算通知中图片相关hints的摘要,用于判断两条通知的图片是否相同
+     */
+    static QByteArray imageDigest(const QVariantMap &hints);
 
 private:
     /*!
@@ -14,6 +14,7 @@
 #include <QApplication>
 
 #include "notificationentity.h"
+#include "htmlsanitizer.h"
 
 #define MIN(a,b) ((a)>(b)?(b):(a))
 #define ABS(a) (a)>0?(a):(-(a))
@@ -47,6 +48,7 @@ static const int BubbleOverLapHeight = 12;      //通知中心层叠层高度
 static const QString NoReplaceId = "0";         //为0 返回一个计数值给程序
 static const int AnimationTime = 300;           //动画时间，单位：毫秒
 static const int ExpandAnimationTime = 100;
+static const int DuplicateNotifyWindow = 10 * 1000; // 重复通知的合并窗口(毫秒)
 static const int BubbleWindowHeight = 60;       // 窗口模式下气泡的高度
 static const int MaxBubbleButtonWidth = 180;    // 窗口模式下气泡按钮的最大宽度
 static const int BubbleStartPos = -(BubbleWindowHeight + ScreenPadding);  // 窗口模式下气泡起始Y位置
@@ -188,9 +190,8 @@ public:
 
     static QString removeHTML(const QString &source)
     {
-        QTextDocument document;
-        document.setHtml(source);
-        return document.toPlainText();
+        // 每条通知都会调用,不再为此构建 QTextDocument
+        return HtmlSanitizer::toPlainText(source);
     }
 };
 #endif // DEFINE_H
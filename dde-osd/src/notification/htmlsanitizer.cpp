@@ -0,0 +1,432 @@
+// SPDX-FileCopyrightText: 2024 UnionTech Software Technology Co., Ltd.
+//
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+#include "htmlsanitizer.h"
+
+#include <algorithm>
+#include <cstring>
+#include <iterator>
+
+// 超过这个长度的标签名不会是已知的元素
+static const int MaxTagNameLength = 10;
+// 和 QTextHtmlParser 相同,实体名最长 8 个字符
+static const int MaxEntityLength = 8;
+
+// 前后产生换行的块级元素
+static const char *const BlockTags[] = {
+    "address", "blockquote", "body", "center", "dd", "div", "dl", "dt",
+    "h1", "h2", "h3", "h4", "h5", "h6", "hr", "html", "li", "ol", "p",
+    "pre", "table", "td", "th", "tr", "ul"
+};
+
+// 内容不显示的元素
+static const char *const HiddenTags[] = {
+    "head", "script", "style", "title"
+};
+
+struct Entity {
+    const char *name;
+    ushort unicode;
+};
+
+// HTML 4 的全部命名实体和 &apos;,与 QTextHtmlParser 一致,按 strcmp 的顺序排列用于二分查找
+static const Entity Entities[] = {
+    {"AElig", 0x00c6}, {"Aacute", 0x00c1}, {"Acirc", 0x00c2}, {"Agrave", 0x00c0}, {"Alpha", 0x0391},
+    {"Aring", 0x00c5}, {"Atilde", 0x00c3}, {"Auml", 0x00c4}, {"Beta", 0x0392}, {"Ccedil", 0x00c7},
+    {"Chi", 0x03a7}, {"Dagger", 0x2021}, {"Delta", 0x0394}, {"ETH", 0x00d0}, {"Eacute", 0x00c9},
+    {"Ecirc", 0x00ca}, {"Egrave", 0x00c8}, {"Epsilon", 0x0395}, {"Eta", 0x0397}, {"Euml", 0x00cb},
+    {"Gamma", 0x0393}, {"Iacute", 0x00cd}, {"Icirc", 0x00ce}, {"Igrave", 0x00cc}, {"Iota", 0x0399},
+    {"Iuml", 0x00cf}, {"Kappa", 0x039a}, {"Lambda", 0x039b}, {"Mu", 0x039c}, {"Ntilde", 0x00d1},
+    {"Nu", 0x039d}, {"OElig", 0x0152}, {"Oacute", 0x00d3}, {"Ocirc", 0x00d4}, {"Ograve", 0x00d2},
+    {"Omega", 0x03a9}, {"Omicron", 0x039f}, {"Oslash", 0x00d8}, {"Otilde", 0x00d5}, {"Ouml", 0x00d6},
+    {"Phi", 0x03a6}, {"Pi", 0x03a0}, {"Prime", 0x2033}, {"Psi", 0x03a8}, {"Rho", 0x03a1}, {"Scaron", 0x0160},
+    {"Sigma", 0x03a3}, {"THORN", 0x00de}, {"Tau", 0x03a4}, {"Theta", 0x0398}, {"Uacute", 0x00da},
+    {"Ucirc", 0x00db}, {"Ugrave", 0x00d9}, {"Upsilon", 0x03a5}, {"Uuml", 0x00dc}, {"Xi", 0x039e},
+    {"Yacute", 0x00dd}, {"Yuml", 0x0178}, {"Zeta", 0x0396}, {"aacute", 0x00e1}, {"acirc", 0x00e2},
+    {"acute", 0x00b4}, {"aelig", 0x00e6}, {"agrave", 0x00e0}, {"alefsym", 0x2135}, {"alpha", 0x03b1},
+    {"amp", '&'}, {"and", 0x2227}, {"ang", 0x2220}, {"apos", '\''}, {"aring", 0x00e5}, {"asymp", 0x2248},
+    {"atilde", 0x00e3}, {"auml", 0x00e4}, {"bdquo", 0x201e}, {"beta", 0x03b2}, {"brvbar", 0x00a6},
+    {"bull", 0x2022}, {"cap", 0x2229}, {"ccedil", 0x00e7}, {"cedil", 0x00b8}, {"cent", 0x00a2},
+    {"chi", 0x03c7}, {"circ", 0x02c6}, {"clubs", 0x2663}, {"cong", 0x2245}, {"copy", 0x00a9},
+    {"crarr", 0x21b5}, {"cup", 0x222a}, {"curren", 0x00a4}, {"dArr", 0x21d3}, {"dagger", 0x2020},
+    {"darr", 0x2193}, {"deg", 0x00b0}, {"delta", 0x03b4}, {"diams", 0x2666}, {"divide", 0x00f7},
+    {"eacute", 0x00e9}, {"ecirc", 0x00ea}, {"egrave", 0x00e8}, {"empty", 0x2205}, {"emsp", 0x2003},
+    {"ensp", 0x2002}, {"epsilon", 0x03b5}, {"equiv", 0x2261}, {"eta", 0x03b7}, {"eth", 0x00f0},
+    {"euml", 0x00eb}, {"euro", 0x20ac}, {"exist", 0x2203}, {"fnof", 0x0192}, {"forall", 0x2200},
+    {"frac12", 0x00bd}, {"frac14", 0x00bc}, {"frac34", 0x00be}, {"frasl", 0x2044}, {"gamma", 0x03b3},
+    {"ge", 0x2265}, {"gt", '>'}, {"hArr", 0x21d4}, {"harr", 0x2194}, {"hearts", 0x2665}, {"hellip", 0x2026},
+    {"iacute", 0x00ed}, {"icirc", 0x00ee}, {"iexcl", 0x00a1}, {"igrave", 0x00ec}, {"image", 0x2111},
+    {"infin", 0x221e}, {"int", 0x222b}, {"iota", 0x03b9}, {"iquest", 0x00bf}, {"isin", 0x2208},
+    {"iuml", 0x00ef}, {"kappa", 0x03ba}, {"lArr", 0x21d0}, {"lambda", 0x03bb}, {"lang", 0x2329},
+    {"laquo", 0x00ab}, {"larr", 0x2190}, {"lceil", 0x2308}, {"ldquo", 0x201c}, {"le", 0x2264},
+    {"lfloor", 0x230a}, {"lowast", 0x2217}, {"loz", 0x25ca}, {"lrm", 0x200e}, {"lsaquo", 0x2039},
+    {"lsquo", 0x2018}, {"lt", '<'}, {"macr", 0x00af}, {"mdash", 0x2014}, {"micro", 0x00b5},
+    {"middot", 0x00b7}, {"minus", 0x2212}, {"mu", 0x03bc}, {"nabla", 0x2207}, {"nbsp", 0x00a0},
+    {"ndash", 0x2013}, {"ne", 0x2260}, {"ni", 0x220b}, {"not", 0x00ac}, {"notin", 0x2209}, {"nsub", 0x2284},
+    {"ntilde", 0x00f1}, {"nu", 0x03bd}, {"oacute", 0x00f3}, {"ocirc", 0x00f4}, {"oelig", 0x0153},
+    {"ograve", 0x00f2}, {"oline", 0x203e}, {"omega", 0x03c9}, {"omicron", 0x03bf}, {"oplus", 0x2295},
+    {"or", 0x2228}, {"ordf", 0x00aa}, {"ordm", 0x00ba}, {"oslash", 0x00f8}, {"otilde", 0x00f5},
+    {"otimes", 0x2297}, {"ouml", 0x00f6}, {"para", 0x00b6}, {"part", 0x2202}, {"permil", 0x2030},
+    {"perp", 0x22a5}, {"phi", 0x03c6}, {"pi", 0x03c0}, {"piv", 0x03d6}, {"plusmn", 0x00b1}, {"pound", 0x00a3},
+    {"prime", 0x2032}, {"prod", 0x220f}, {"prop", 0x221d}, {"psi", 0x03c8}, {"quot", '"'}, {"rArr", 0x21d2},
+    {"radic", 0x221a}, {"rang", 0x232a}, {"raquo", 0x00bb}, {"rarr", 0x2192}, {"rceil", 0x2309},
+    {"rdquo", 0x201d}, {"real", 0x211c}, {"reg", 0x00ae}, {"rfloor", 0x230b}, {"rho", 0x03c1},
+    {"rlm", 0x200f}, {"rsaquo", 0x203a}, {"rsquo", 0x2019}, {"sbquo", 0x201a}, {"scaron", 0x0161},
+    {"sdot", 0x22c5}, {"sect", 0x00a7}, {"shy", 0x00ad}, {"sigma", 0x03c3}, {"sigmaf", 0x03c2},
+    {"sim", 0x223c}, {"spades", 0x2660}, {"sub", 0x2282}, {"sube", 0x2286}, {"sum", 0x2211}, {"sup", 0x2283},
+    {"sup1", 0x00b9}, {"sup2", 0x00b2}, {"sup3", 0x00b3}, {"supe", 0x2287}, {"szlig", 0x00df},
+    {"tau", 0x03c4}, {"there4", 0x2234}, {"theta", 0x03b8}, {"thetasym", 0x03d1}, {"thinsp", 0x2009},
+    {"thorn", 0x00fe}, {"tilde", 0x02dc}, {"times", 0x00d7}, {"trade", 0x2122}, {"uArr", 0x21d1},
+    {"uacute", 0x00fa}, {"uarr", 0x2191}, {"ucirc", 0x00fb}, {"ugrave", 0x00f9}, {"uml", 0x00a8},
+    {"upsih", 0x03d2}, {"upsilon", 0x03c5}, {"uuml", 0x00fc}, {"weierp", 0x2118}, {"xi", 0x03be},
+    {"yacute", 0x00fd}, {"yen", 0x00a5}, {"yuml", 0x00ff}, {"zeta", 0x03b6}, {"zwj", 0x200d},
+    {"zwnj", 0x200c}
+};
+
+static bool operator<(const Entity &entity, const char *name)
+{
+    return std::strcmp(entity.name, name) < 0;
+}
+
+template<int N>
+static bool containsTag(const char *const (&tags)[N], const char *name)
+{
+    for (const char *tag : tags) {
+        if (std::strcmp(tag, name) == 0)
+            return true;
+    }
+    return false;
+}
+
+static bool isAsciiLetter(QChar ch)
+{
+    return (ch >= QLatin1Char('a') && ch <= QLatin1Char('z')) || (ch >= QLatin1Char('A') && ch <= QLatin1Char('Z'));
+}
+
+static bool isAsciiLetterOrDigit(QChar ch)
+{
+    return isAsciiLetter(ch) || (ch >= QLatin1Char('0') && ch <= QLatin1Char('9'));
+}
+
+// 从 pos 开始查找 pattern,返回 pattern 所在的位置,没有找到时返回 length.ignoreCase 时 pattern 需要是小写
+static int indexOf(const QChar *data, int length, int pos, const char *pattern, bool ignoreCase)
+{
+    const int patternLength = int(std::strlen(pattern));
+    for (int i = pos; i + patternLength <= length; ++i) {
+        int j = 0;
+        for (; j < patternLength; ++j) {
+            const QChar ch = ignoreCase ? data[i + j].toLower() : data[i + j];
+            if (ch != QLatin1Char(pattern[j]))
+                break;
+        }
+        if (j == patternLength)
+            return i;
+    }
+    return length;
+}
+
+static int digitValue(QChar ch)
+{
+    if (ch >= QLatin1Char('0') && ch <= QLatin1Char('9'))
+        return ch.unicode() - '0';
+    if (ch >= QLatin1Char('a') && ch <= QLatin1Char('z'))
+        return ch.unicode() - 'a' + 10;
+    if (ch >= QLatin1Char('A') && ch <= QLatin1Char('Z'))
+        return ch.unicode() - 'A' + 10;
+    return -1;
+}
+
+namespace {
+
+// 按 QTextHtmlImporter 的规则压缩空白:块的开头和换行后去掉空白,连续的空白只保留一个空格,
+// 块级元素之间只在后面还有文字时才换行
+class PlainTextWriter
+{
+public:
+    explicit PlainTextWriter(int capacity)
+    {
+        m_text.reserve(capacity);
+    }
+
+    void append(QChar ch)
+    {
+        if (m_preDepth > 0) {
+            if (ch == QLatin1Char('\r'))
+                return;
+        } else if (ch.isSpace() && ch != QChar::Nbsp) {
+            if (m_removeWhiteSpace)
+                return;
+            m_removeWhiteSpace = true;
+            ch = QLatin1Char(' ');
+        } else {
+            m_removeWhiteSpace = false;
+        }
+
+        flushBlock();
+        m_text.append(ch == QChar::Nbsp ? QChar(QLatin1Char(' ')) : ch);
+    }
+
+    void appendLineBreak()
+    {
+        flushBlock();
+        m_text.append(QLatin1Char('\n'));
+        m_removeWhiteSpace = true;
+    }
+
+    void appendBlock()
+    {
+        if (!m_text.isEmpty())
+            m_pendingBlock = true;
+        m_removeWhiteSpace = true;
+    }
+
+    void enterPre() { ++m_preDepth; }
+    void leavePre() { m_preDepth = qMax(0, m_preDepth - 1); }
+
+    const QString &text() const { return m_text; }
+
+private:
+    void flushBlock()
+    {
+        if (m_pendingBlock) {
+            m_text.append(QLatin1Char('\n'));
+            m_pendingBlock = false;
+        }
+    }
+
+private:
+    QString m_text;
+    bool m_removeWhiteSpace = true;
+    bool m_pendingBlock = false;
+    int m_preDepth = 0;
+};
+
+}
+
+// 解析 pos 处以 & 开头的实体,无法解析时按普通字符输出 &,返回之后的位置
+static int parseEntity(const QChar *data, int length, int pos, PlainTextWriter &writer)
+{
+    int end = pos + 1;
+    while (end < length && end - pos - 1 <= MaxEntityLength && data[end] != QLatin1Char(';') && !data[end].isSpace())
+        ++end;
+
+    const int nameLength = end - pos - 1;
+    if (end >= length || data[end] != QLatin1Char(';') || nameLength < 1 || nameLength > MaxEntityLength) {
+        writer.append(QLatin1Char('&'));
+        return pos + 1;
+    }
+
+    const QChar *name = data + pos + 1;
+    uint unicode = 0;
+    if (name[0] == QLatin1Char('#')) {
+        const bool hex = nameLength > 1 && (name[1] == QLatin1Char('x') || name[1] == QLatin1Char('X'));
+        const int base = hex ? 16 : 10;
+        for (int i = hex ? 2 : 1; i < nameLength; ++i) {
+            const int digit = digitValue(name[i]);
+            if (digit < 0 || digit >= base) {
+                unicode = 0;
+                break;
+            }
+            unicode = unicode * uint(base) + uint(digit);
+            if (unicode > 0x10ffff) {
+                unicode = 0;
+                break;
+            }
+        }
+    } else {
+        char buffer[MaxEntityLength + 1];
+        for (int i = 0; i < nameLength; ++i)
+            buffer[i] = name[i].unicode() < 0x80 ? char(name[i].unicode()) : '?';
+        buffer[nameLength] = '\0';
+        const Entity *entity = std::lower_bound(std::begin(Entities), std::end(Entities), static_cast<const char *>(buffer));
+        if (entity != std::end(Entities) && std::strcmp(entity->name, buffer) == 0)
+            unicode = entity->unicode;
+    }
+
+    if (unicode == 0) {
+        writer.append(QLatin1Char('&'));
+        return pos + 1;
+    }
+
+    if (QChar::requiresSurrogates(unicode)) {
+        writer.append(QChar(QChar::highSurrogate(unicode)));
+        writer.append(QChar(QChar::lowSurrogate(unicode)));
+    } else {
+        writer.append(QChar(unicode));
+    }
+    return end + 1;
+}
+
+// 输出 [pos, end) 之间的文字,解析其中的实体
+static void appendText(const QChar *data, int pos, int end, PlainTextWriter &writer)
+{
+    while (pos < end) {
+        if (data[pos] == QLatin1Char('&')) {
+            pos = parseEntity(data, end, pos, writer);
+            continue;
+        }
+        writer.append(data[pos++]);
+    }
+}
+
+// 查找标签结束的 >,跳过引号中的内容,没有找到时返回 length
+static int tagEnd(const QChar *data, int length, int pos)
+{
+    QChar quote;
+    for (; pos < length; ++pos) {
+        const QChar ch = data[pos];
+        if (!quote.isNull()) {
+            if (ch == quote)
+                quote = QChar();
+        } else if (ch == QLatin1Char('"') || ch == QLatin1Char('\'')) {
+            quote = ch;
+        } else if (ch == QLatin1Char('>')) {
+            return pos;
+        }
+    }
+    return length;
+}
+
+// 在 [pos, end) 的属性中查找 alt,输出其中的文字
+static void appendAltText(const QChar *data, int pos, int end, PlainTextWriter &writer)
+{
+    while (pos < end) {
+        while (pos < end && (data[pos].isSpace() || data[pos] == QLatin1Char('/')))
+            ++pos;
+
+        const int nameStart = pos;
+        while (pos < end && !data[pos].isSpace() && data[pos] != QLatin1Char('=') && data[pos] != QLatin1Char('/'))
+            ++pos;
+        const bool isAlt = pos - nameStart == 3 && indexOf(data, pos, nameStart, "alt", true) == nameStart;
+
+        while (pos < end && data[pos].isSpace())
+            ++pos;
+        if (pos >= end || data[pos] != QLatin1Char('='))
+            continue;
+        ++pos;
+        while (pos < end && data[pos].isSpace())
+            ++pos;
+
+        int valueStart = pos;
+        int valueEnd = pos;
+        if (pos < end && (data[pos] == QLatin1Char('"') || data[pos] == QLatin1Char('\''))) {
+            const QChar quote = data[pos];
+            valueStart = ++pos;
+            while (pos < end && data[pos] != quote)
+                ++pos;
+            valueEnd = pos;
+            if (pos < end)
+                ++pos;
+        } else {
+            while (pos < end && !data[pos].isSpace())
+                ++pos;
+            valueEnd = pos;
+        }
+
+        if (isAlt) {
+            appendText(data, valueStart, valueEnd, writer);
+            return;
+        }
+    }
+}
+
+// 解析 pos 处以 < 开头的标签、注释或声明,返回之后的位置
+static int parseMarkup(const QChar *data, int length, int pos, PlainTextWriter &writer)
+{
+    if (pos + 1 >= length) {
+        writer.append(QLatin1Char('<'));
+        return pos + 1;
+    }
+
+    const QChar next = data[pos + 1];
+    if (next == QLatin1Char('!')) {
+        if (indexOf(data, qMin(length, pos + 4), pos, "<!--", false) == pos) {
+            const int end = indexOf(data, length, pos + 4, "-->", false);
+            return qMin(length, end + 3);
+        }
+        return qMin(length, tagEnd(data, length, pos) + 1);
+    }
+    if (next == QLatin1Char('?'))
+        return qMin(length, tagEnd(data, length, pos) + 1);
+
+    // < 后面不是标签名时按普通字符处理,例如 "a < b"
+    const bool closing = next == QLatin1Char('/');
+    int i = pos + (closing ? 2 : 1);
+    if (i >= length || !isAsciiLetter(data[i])) {
+        writer.append(QLatin1Char('<'));
+        return pos + 1;
+    }
+
+    char name[MaxTagNameLength + 1];
+    int nameLength = 0;
+    for (; i < length && isAsciiLetterOrDigit(data[i]); ++i) {
+        if (nameLength < MaxTagNameLength)
+            name[nameLength] = char(data[i].toLower().unicode());
+        ++nameLength;
+    }
+    // 过长的标签名不和任何元素匹配
+    name[nameLength <= MaxTagNameLength ? nameLength : 0] = '\0';
+
+    const int attributesStart = i;
+    const int end = tagEnd(data, length, i);
+    const int after = qMin(length, end + 1);
+    const bool block = containsTag(BlockTags, name);
+
+    if (closing) {
+        if (std::strcmp(name, "pre") == 0)
+            writer.leavePre();
+        if (block)
+            writer.appendBlock();
+        return after;
+    }
+
+    if (std::strcmp(name, "br") == 0) {
+        writer.appendLineBreak();
+        return after;
+    }
+
+    if (std::strcmp(name, "img") == 0) {
+        appendAltText(data, attributesStart, end, writer);
+        return after;
+    }
+
+    if (containsTag(HiddenTags, name)) {
+        if (end < length && data[end - 1] == QLatin1Char('/'))
+            return after;
+
+        // 跳过元素的内容和结束标签
+        char closeTag[MaxTagNameLength + 3] = "</";
+        std::strcat(closeTag, name);
+        const int close = indexOf(data, length, after, closeTag, true);
+        return qMin(length, tagEnd(data, length, close) + 1);
+    }
+
+    if (block) {
+        writer.appendBlock();
+        if (std::strcmp(name, "pre") == 0)
+            writer.enterPre();
+    }
+    return after;
+}
+
+QString HtmlSanitizer::toPlainText(const QString &source)
+{
+    PlainTextWriter writer(source.size());
+    const QChar *data = source.constData();
+    const int length = source.size();
+
+    int pos = 0;
+    while (pos < length) {
+        const QChar ch = data[pos];
+        if (ch == QLatin1Char('<')) {
+            pos = parseMarkup(data, length, pos, writer);
+        } else if (ch == QLatin1Char('&')) {
+            pos = parseEntity(data, length, pos, writer);
+        } else {
+            writer.append(ch);
+            ++pos;
+        }
+    }
+    return writer.text();
+}
@@ -0,0 +1,22 @@
+// SPDX-FileCopyrightText: 2024 UnionTech Software Technology Co., Ltd.
+//
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+#ifndef HTMLSANITIZER_H
+#define HTMLSANITIZER_H
+
+#include <QString>
+
+/*!
+ * \~chinese \class HtmlSanitizer
+ * \~chinese \brief 把通知正文中的 HTML 转换为纯文本,只遍历一次正文,不构建文档.
+ * \~chinese 去掉标签、解析实体,空白和块级元素的换行按 QTextDocument::toPlainText 的规则处理;
+ * \~chinese 规范允许的标记中保留链接文字和图片的 alt 文字,注释、script、style 等的内容丢弃
+ */
+class HtmlSanitizer
+{
+public:
+    static QString toPlainText(const QString &source);
+};
+
+#endif // HTMLSANITIZER_H
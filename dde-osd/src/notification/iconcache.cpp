@@ -0,0 +1,92 @@
+// SPDX-FileCopyrightText: 2024 UnionTech Software Technology Co., Ltd.
+//
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+#include "iconcache.h"
+#include "notifystyle.h"
+
+#include <QIcon>
+#include <QUrl>
+#include <QFileInfo>
+#include <QDateTime>
+
+#include <DGuiApplicationHelper>
+#include <DPlatformTheme>
+
+DGUI_USE_NAMESPACE
+
+// 默认缓存预算 8MB, 按2倍缩放的气泡图标计算大约能缓存两百多个
+static const int DefaultIconCacheCost = 8 * 1024 * 1024;
+
+IconCache::IconCache(QObject *parent)
+    : QObject(parent)
+    , m_cache(DefaultIconCacheCost)
+{
+    // 主题类型和图标主题变化后,同名图标对应的图片会变,需要重新加载
+    connect(&NotifyStyle::ref(), &NotifyStyle::styleChanged, this, &IconCache::clear);
+    connect(DGuiApplicationHelper::instance()->systemTheme(), &DPlatformTheme::iconThemeNameChanged, this, &IconCache::clear);
+}
+
+QPixmap IconCache::pixmap(const QString &iconPath, const QString &fallback, const QSize &size, qreal pixelRatio)
+{
+    const QString &key = cacheKey(iconPath, fallback, size, pixelRatio);
+    if (QPixmap *cached = m_cache.object(key))
+        return *cached;
+
+    const QPixmap &pixmap = loadPixmap(iconPath, fallback, size, pixelRatio);
+    if (!pixmap.isNull()) {
+        const int cost = pixmap.width() * pixmap.height() * qMax(pixmap.depth(), 8) / 8;
+        m_cache.insert(key, new QPixmap(pixmap), cost);
+    }
+
+    return pixmap;
+}
+
+void IconCache::clear()
+{
+    m_cache.clear();
+}
+
+QString IconCache::cacheKey(const QString &iconPath, const QString &fallback, const QSize &size, qreal pixelRatio)
+{
+    QString key = QString("%1x%2@%3|%4|%5").arg(size.width()).arg(size.height()).arg(pixelRatio).arg(fallback, iconPath);
+
+    // 本地图片可能被应用用同一个路径覆盖写入,把修改时间也作为键的一部分
+    if (!iconPath.startsWith("data:image/")) {
+        const QUrl url(iconPath);
+        const QFileInfo info(url.isLocalFile() ? url.toLocalFile() : iconPath);
+        if (info.isAbsolute() && info.exists())
+            key += QString("|%1").arg(info.lastModified().toMSecsSinceEpoch());
+    }
+
+    return key;
+}
+
+QPixmap IconCache::loadPixmap(const QString &iconPath, const QString &fallback, const QSize &size, qreal pixelRatio)
+{
+    QPixmap pixmap;
+
+    if (iconPath.startsWith("data:image/")) {
+        // iconPath is a string representing an inline image.
+        QStringList strs = iconPath.split("base64,");
+        if (strs.length() == 2) {
+            QByteArray data = QByteArray::fromBase64(strs.at(1).toLatin1());
+            pixmap.loadFromData(data);
+        }
+    }
+
+    if (pixmap.isNull()) {
+        const QIcon &icon = QIcon::fromTheme(iconPath, QIcon::fromTheme(fallback, QIcon::fromTheme("application-x-desktop")));
+        pixmap = icon.pixmap(size.width() * pixelRatio, size.height() * pixelRatio);
+    }
+
+    if (!pixmap.isNull()) {
+        pixmap = pixmap.scaled(size.width() * pixelRatio, size.height() * pixelRatio,
+                               Qt::KeepAspectRatioByExpanding,
+                               Qt::SmoothTransformation);
+
+        pixmap.setDevicePixelRatio(pixelRatio);
+    }
+
+    return pixmap;
+}
@@ -0,0 +1,47 @@
+// SPDX-FileCopyrightText: 2024 UnionTech Software Technology Co., Ltd.
+//
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+#ifndef ICONCACHE_H
+#define ICONCACHE_H
+
+#include <QObject>
+#include <QCache>
+#include <QPixmap>
+#include <DSingleton>
+
+/*!
+ * \~chinese \class IconCache
+ * \~chinese \brief 进程内共享的图标缓存,通知气泡和通知中心共用,避免同一个应用的图标被反复查找和解码
+ * \~chinese 以(图标, 备用图标, 尺寸, 缩放比)为键,按像素字节数做LRU淘汰,图标主题变化时清空
+ */
+class IconCache : public QObject, public Dtk::Core::DSingleton<IconCache>
+{
+    Q_OBJECT
+    friend class Dtk::Core::DSingleton<IconCache>;
+
+public:
+    /*!
+     * \~chinese \name pixmap
+     * \~chinese \brief 获取已经缩放到目标尺寸并设置好缩放比的图标
+     * \~chinese \param iconPath: 图标名称、文件路径或者 data:image base64 数据; fallback: 备用图标名称
+     * \~chinese \param size: 控件的逻辑尺寸; pixelRatio: 设备缩放比
+     */
+    QPixmap pixmap(const QString &iconPath, const QString &fallback, const QSize &size, qreal pixelRatio);
+
+    void clear();
+    int maxCost() const { return m_cache.maxCost(); }
+    void setMaxCost(int bytes) { m_cache.setMaxCost(bytes); }
+    int count() const { return m_cache.count(); }
+
+private:
+    explicit IconCache(QObject *parent = nullptr);
+
+    static QString cacheKey(const QString &iconPath, const QString &fallback, const QSize &size, qreal pixelRatio);
+    static QPixmap loadPixmap(const QString &iconPath, const QString &fallback, const QSize &size, qreal pixelRatio);
+
+private:
+    QCache<QString, QPixmap> m_cache;
+};
+
+#endif // ICONCACHE_H
@@ -6,168 +6,186 @@
 
 #include <QDateTime>
 
+static const QString RepeatCountHint = "x-deepin-repeat-count";
+
 NotificationEntity::NotificationEntity(const QString &appName, const QString &id,
                                        const QString &appIcon, const QString &summary,
                                        const QString &body, const QStringList &actions,
                                        const QVariantMap hints, const QString &ctime,
-                                       const QString &replacesId, const QString &timeout,
-                                       QObject *parent) :
-    QObject(parent),
-    m_appName(appName),
-    m_id(id.toUInt()),
-    m_appIcon(appIcon),
-    m_summary(summary),
-    m_body(body),
-    m_actions(actions),
-    m_hints(hints),
-    m_ctime(ctime),
-    m_replacesId(replacesId),
-    m_timeout(timeout),
-    m_isTitle(false),
-    m_hideCount(0),
-    m_showPreview(true),
-    m_index(0),
-    m_showInNotifyCenter(true)
+                                       const QString &replacesId, const QString &timeout)
 {
-
+    m_record.setAppName(appName);
+    m_record.setId(id.toUInt());
+    m_record.setAppIcon(appIcon);
+    m_record.setSummary(summary);
+    m_record.setBody(body);
+    m_record.setActions(actions);
+    m_record.setHints(hints);
+    m_record.setCTime(ctime.toLongLong());
+    m_record.setReplacesId(replacesId.toUInt());
+    m_record.setTimeout(timeout.toInt());
 }
 
-NotificationEntity::NotificationEntity(const NotificationEntity &notify) :
-    NotificationEntity(notify.appName(), QString::number(notify.id()), notify.appIcon(), notify.summary(),
-                       notify.body(), notify.actions(), notify.hints(), notify.ctime(),
-                       notify.replacesId(), notify.timeout())
+NotificationEntity::NotificationEntity(const NotificationRecord &record)
+    : m_record(record)
 {
 
 }
 
+NotificationEntity::NotificationEntity(const NotificationEntity &notify)
+    : m_record(notify.m_record)
+{
+    // 与原来的行为保持一致,拷贝时不带上显示相关的状态
+    m_record.setStorageId(0);
+    m_record.setHideCount(0);
+    m_record.setCurrentIndex(0);
+    m_record.setFlag(NotificationRecord::IsTitle, false);
+    m_record.setFlag(NotificationRecord::ShowPreview, true);
+    m_record.setFlag(NotificationRecord::ShowInNotifyCenter, true);
+}
+
 QString NotificationEntity::appName() const
 {
-    return m_appName;
+    return m_record.appName();
 }
 
 void NotificationEntity::setAppName(const QString &appName)
 {
-    m_appName = appName;
+    m_record.setAppName(appName);
 }
 
 uint NotificationEntity::id() const
 {
-    return m_id;
+    return m_record.id();
 }
 
 // id is guarrented to be uint by ourselves.
 void NotificationEntity::setId(const QString &id)
 {
-    m_id = id.toUInt();
+    m_record.setId(id.toUInt());
 }
 
 QString NotificationEntity::storageId() const
 {
-    return m_storageId;
+    return m_record.storageId() > 0 ? QString::number(m_record.storageId()) : QString();
 }
 
 void NotificationEntity::setStorageId(const QString &id)
 {
-    m_storageId = id;
+    m_record.setStorageId(id.toLongLong());
 }
 
 QString NotificationEntity::appIcon() const
 {
-    return m_appIcon;
+    return m_record.appIcon();
 }
 
 void NotificationEntity::setAppIcon(const QString &appIcon)
 {
-    m_appIcon = appIcon;
+    m_record.setAppIcon(appIcon);
 }
 QString NotificationEntity::summary() const
 {
-    return m_summary;
+    return m_record.summary();
 }
 
 void NotificationEntity::setSummary(const QString &summary)
 {
-    m_summary = summary;
+    m_record.setSummary(summary);
 }
 QString NotificationEntity::body() const
 {
-    return m_body;
+    return m_record.body();
 }
 
 void NotificationEntity::setBody(const QString &body)
 {
-    m_body = body;
+    m_record.setBody(body);
 }
 QStringList NotificationEntity::actions() const
 {
-    return m_actions;
+    return m_record.actions();
 }
 
 void NotificationEntity::setActions(const QStringList &actions)
 {
-    m_actions = actions;
+    m_record.setActions(actions);
 }
 QVariantMap NotificationEntity::hints() const
 {
-    return m_hints;
+    return m_record.hints();
 }
 
 void NotificationEntity::setHints(const QVariantMap &hints)
 {
-    m_hints = hints;
+    m_record.setHints(hints);
 }
 
 QString NotificationEntity::ctime() const
 {
-    return m_ctime;
+    return QString::number(m_record.ctime());
 }
 
 void NotificationEntity::setTime(const QString &time)
 {
-    m_ctime = time;
+    m_record.setCTime(time.toLongLong());
 }
 
 QString NotificationEntity::replacesId() const
 {
-    return m_replacesId;
+    return QString::number(m_record.replacesId());
 }
 
 void NotificationEntity::setReplacesId(const QString &replacesId)
 {
-    m_replacesId = replacesId;
+    m_record.setReplacesId(replacesId.toUInt());
 }
 
 QString NotificationEntity::timeout() const
 {
-    return m_timeout;
+    return QString::number(m_record.timeout());
 }
 
 void NotificationEntity::setTimeout(const QString &timeout)
 {
-    m_timeout = timeout;
+    m_record.setTimeout(timeout.toInt());
 }
 
 void NotificationEntity::setIsTitle(bool is)
 {
-    m_isTitle = is;
+    m_record.setFlag(NotificationRecord::IsTitle, is);
 }
 
 void NotificationEntity::setHideCount(int count)
 {
-    m_hideCount = count;
+    m_record.setHideCount(count);
 }
 
 void NotificationEntity::setShowPreview(bool show)
 {
-    m_showPreview = show;
+    m_record.setFlag(NotificationRecord::ShowPreview, show);
 }
 
 void NotificationEntity::setCurrentIndex(int idx)
 {
-    m_index = idx;
+    m_record.setCurrentIndex(idx);
 }
 
 void NotificationEntity::setShowInNotifyCenter(bool isShow)
 {
-    m_showInNotifyCenter = isShow;
+    m_record.setFlag(NotificationRecord::ShowInNotifyCenter, isShow);
+}
+
+int NotificationEntity::repeatCount() const
+{
+    return qMax(1, m_record.hint(RepeatCountHint, 1).toInt());
+}
+
+void NotificationEntity::setRepeatCount(int count)
+{
+    if (count > 1) {
+        m_record.setHint(RepeatCountHint, count);
+    } else {
+        m_record.removeHint(RepeatCountHint);
+    }
 }
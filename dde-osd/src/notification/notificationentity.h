@@ -5,28 +5,33 @@
 #ifndef NOTIFICATIONENTITY_H
 #define NOTIFICATIONENTITY_H
 
-#include <QObject>
+#include "notificationrecord.h"
+
+#include <QMetaType>
 #include <QStringList>
 #include <QVariantMap>
 #include <memory>
 #include <QDateTime>
 /*!
  * \~chinese \class 通知的数据结构类
- * \~chinese \brief 设置或者返回通知的信息
+ * \~chinese \brief 设置或者返回通知的信息,数据保存在 NotificationRecord 中,
+ * \~chinese 字符串形式的接口只是为了兼容原有的调用方
  */
-class NotificationEntity : public QObject
+class NotificationEntity
 {
-    Q_OBJECT
 public:
     NotificationEntity(const QString &appName = QString(), const QString &id = QString(),
                        const QString &appIcon = QString(), const QString &summary = QString(),
                        const QString &body = QString(), const QStringList &actions = QStringList(),
                        const QVariantMap hints = QVariantMap(), const QString &ctime = QString::number(QDateTime::currentMSecsSinceEpoch()),
-                       const QString &replacesId = QString(), const QString &timeout = QString(),
-                       QObject *parent = nullptr);
+                       const QString &replacesId = QString(), const QString &timeout = QString());
+    explicit NotificationEntity(const NotificationRecord &record);
 
     NotificationEntity(const NotificationEntity &notify);
 
+    const NotificationRecord &record() const { return m_record; }
+    void setRecord(const NotificationRecord &record) { m_record = record; }
+
     QString appName() const;
     void setAppName(const QString &appName);
 
@@ -60,37 +65,26 @@ public:
     QString timeout() const;
     void setTimeout(const QString &timeout);
 
-    bool isTitle(){ return m_isTitle;}
+    // 短时间内重复收到的次数,保存在hints中
+    int repeatCount() const;
+    void setRepeatCount(int count);
+
+    bool isTitle(){ return m_record.testFlag(NotificationRecord::IsTitle);}
     void setIsTitle(bool is);
 
     void setHideCount(int count);
-    int hideCount(){return m_hideCount;}
+    int hideCount(){return m_record.hideCount();}
 
     void setShowInNotifyCenter(bool isShow);
-    bool isShowInNotifyCenter(){return m_showInNotifyCenter;}
+    bool isShowInNotifyCenter(){return m_record.testFlag(NotificationRecord::ShowInNotifyCenter);}
 
     void setShowPreview(bool show);
-    bool isShowPreview() { return m_showPreview; }
+    bool isShowPreview() { return m_record.testFlag(NotificationRecord::ShowPreview); }
 
     void setCurrentIndex(int idx);
-    int currentIndex() { return m_index; }
+    int currentIndex() { return m_record.currentIndex(); }
 private:
-    QString m_appName;
-    uint m_id;
-    QString m_appIcon;
-    QString m_summary;
-    QString m_body;
-    QStringList m_actions;
-    QVariantMap m_hints;
-    QString m_ctime;
-    QString m_replacesId;
-    QString m_timeout;
-    bool m_isTitle;     //是否是标题
-    int m_hideCount;    //此条消息下面被层叠的消息数量
-    bool m_showPreview;
-    int m_index;
-    bool m_showInNotifyCenter;
-    QString m_storageId;
+    NotificationRecord m_record;
 };
 
 Q_DECLARE_METATYPE(std::shared_ptr<NotificationEntity>);
@@ -0,0 +1,103 @@
+// SPDX-FileCopyrightText: 2024 UnionTech Software Technology Co., Ltd.
+//
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+#include "notificationrecord.h"
+
+#include <QSet>
+
+#include <algorithm>
+
+Q_GLOBAL_STATIC(QSet<QString>, globalStringPool)
+
+QString StringPool::intern(const QString &str)
+{
+    if (str.isEmpty())
+        return QString();
+
+    return *globalStringPool->insert(str);
+}
+
+int StringPool::size()
+{
+    return globalStringPool->size();
+}
+
+NotificationRecord::NotificationRecord()
+    : m_ctime(0)
+    , m_storageId(0)
+    , m_id(0)
+    , m_replacesId(0)
+    , m_timeout(0)
+    , m_index(0)
+    , m_hideCount(0)
+    , m_flags(ShowPreview | ShowInNotifyCenter)
+{
+}
+
+void NotificationRecord::setActions(const QStringList &actions)
+{
+    // 动作按(键, 显示文字)成对排列,只驻留取值有限的键
+    m_actions = actions;
+    for (int i = 0; i < m_actions.size(); i += 2)
+        m_actions[i] = StringPool::intern(m_actions.at(i));
+}
+
+QVariantMap NotificationRecord::hints() const
+{
+    QVariantMap map;
+    for (const Hint &hint : m_hints)
+        map.insert(hint.first, hint.second);
+
+    return map;
+}
+
+void NotificationRecord::setHints(const QVariantMap &hints)
+{
+    // QVariantMap 已经按键排序,直接按顺序保存即可保持有序
+    m_hints.clear();
+    m_hints.reserve(hints.size());
+    for (auto it = hints.constBegin(); it != hints.constEnd(); ++it)
+        m_hints.append(Hint(StringPool::intern(it.key()), it.value()));
+    m_hints.squeeze();
+}
+
+QVariant NotificationRecord::hint(const QString &key, const QVariant &defaultValue) const
+{
+    auto it = findHint(key);
+    return (it != m_hints.constEnd() && it->first == key) ? it->second : defaultValue;
+}
+
+void NotificationRecord::setHint(const QString &key, const QVariant &value)
+{
+    auto it = findHint(key);
+    const int pos = int(it - m_hints.constBegin());
+    if (it != m_hints.constEnd() && it->first == key) {
+        m_hints[pos].second = value;
+    } else {
+        m_hints.insert(pos, Hint(StringPool::intern(key), value));
+    }
+}
+
+void NotificationRecord::removeHint(const QString &key)
+{
+    auto it = findHint(key);
+    if (it != m_hints.constEnd() && it->first == key)
+        m_hints.remove(int(it - m_hints.constBegin()));
+}
+
+void NotificationRecord::setFlag(Flag flag, bool on)
+{
+    if (on) {
+        m_flags |= flag;
+    } else {
+        m_flags &= ~flag;
+    }
+}
+
+QVector<NotificationRecord::Hint>::const_iterator NotificationRecord::findHint(const QString &key) const
+{
+    return std::lower_bound(m_hints.constBegin(), m_hints.constEnd(), key, [](const Hint &hint, const QString &key) {
+        return hint.first < key;
+    });
+}
@@ -0,0 +1,108 @@
+// SPDX-FileCopyrightText: 2024 UnionTech Software Technology Co., Ltd.
+//
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+#ifndef NOTIFICATIONRECORD_H
+#define NOTIFICATIONRECORD_H
+
+#include <QString>
+#include <QStringList>
+#include <QVariantMap>
+#include <QVector>
+#include <QPair>
+
+/*!
+ * \~chinese \class StringPool
+ * \~chinese \brief 字符串驻留表,相同内容的应用名、动作键和 hints 键共享同一份数据,只在主线程中使用.
+ * \~chinese 表中的字符串不会释放,只能放入取值有限的字段
+ */
+class StringPool
+{
+public:
+    static QString intern(const QString &str);
+    static int size();
+};
+
+/*!
+ * \~chinese \class NotificationRecord
+ * \~chinese \brief 通知的紧凑值类型,时间和各种ID都保存为整数,应用名和动作键驻留在字符串表中,
+ * \~chinese hints 保存为按键排序的数组,历史记录和层叠隐藏的通知都以这种形式保存
+ */
+class NotificationRecord
+{
+public:
+    enum Flag : quint8 {
+        IsTitle = 0x01,
+        ShowPreview = 0x02,
+        ShowInNotifyCenter = 0x04,
+    };
+
+    NotificationRecord();
+
+    QString appName() const { return m_appName; }
+    void setAppName(const QString &appName) { m_appName = StringPool::intern(appName); }
+
+    QString appIcon() const { return m_appIcon; }
+    void setAppIcon(const QString &appIcon) { m_appIcon = appIcon; }   // 可能是 data URI 或临时路径,不驻留
+
+    QString summary() const { return m_summary; }
+    void setSummary(const QString &summary) { m_summary = summary; }
+
+    QString body() const { return m_body; }
+    void setBody(const QString &body) { m_body = body; }
+
+    QStringList actions() const { return m_actions; }
+    void setActions(const QStringList &actions);
+
+    QVariantMap hints() const;
+    void setHints(const QVariantMap &hints);
+    QVariant hint(const QString &key, const QVariant &defaultValue = QVariant()) const;
+    void setHint(const QString &key, const QVariant &value);
+    void removeHint(const QString &key);
+
+    qint64 ctime() const { return m_ctime; }        // 毫秒时间戳
+    void setCTime(qint64 ctime) { m_ctime = ctime; }
+
+    uint id() const { return m_id; }
+    void setId(uint id) { m_id = id; }
+
+    uint replacesId() const { return m_replacesId; }
+    void setReplacesId(uint replacesId) { m_replacesId = replacesId; }
+
+    int timeout() const { return m_timeout; }
+    void setTimeout(int timeout) { m_timeout = timeout; }
+
+    qint64 storageId() const { return m_storageId; }    // 数据库中的ID, 0表示没有保存
+    void setStorageId(qint64 storageId) { m_storageId = storageId; }
+
+    int hideCount() const { return m_hideCount; }
+    void setHideCount(int count) { m_hideCount = qint16(count); }
+
+    int currentIndex() const { return m_index; }
+    void setCurrentIndex(int index) { m_index = index; }
+
+    bool testFlag(Flag flag) const { return m_flags & flag; }
+    void setFlag(Flag flag, bool on = true);
+
+private:
+    typedef QPair<QString, QVariant> Hint;
+    QVector<Hint>::const_iterator findHint(const QString &key) const;
+
+private:
+    qint64 m_ctime;
+    qint64 m_storageId;
+    uint m_id;
+    uint m_replacesId;
+    int m_timeout;
+    int m_index;
+    qint16 m_hideCount;
+    quint8 m_flags;
+    QString m_appName;
+    QString m_appIcon;
+    QString m_summary;
+    QString m_body;
+    QStringList m_actions;
+    QVector<Hint> m_hints;
+};
+
+#endif // NOTIFICATIONRECORD_H
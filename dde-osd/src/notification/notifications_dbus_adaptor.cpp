@@ -128,6 +128,14 @@ QDBusVariant DDENotifyDBus::GetAppInfo(const QString &in0, uint in1)
     return out0;
 }
 
+QVariantMap DDENotifyDBus::GetAppInfos(const QStringList &in0)
+{
+    // handle method call org.deepin.dde.Notification1.GetAppInfos
+    QVariantMap out0;
+    QMetaObject::invokeMethod(parent(), "GetAppInfos", Q_RETURN_ARG(QVariantMap, out0), Q_ARG(QStringList, in0));
+    return out0;
+}
+
 QStringList DDENotifyDBus::GetAppList()
 {
     // handle method call org.deepin.dde.Notification1.GetAppList
@@ -194,6 +202,12 @@ void DDENotifyDBus::SetAppInfo(const QString &in0, uint in1, const QDBusVariant
     QMetaObject::invokeMethod(parent(), "SetAppInfo", Q_ARG(QString, in0), Q_ARG(uint, in1), Q_ARG(QDBusVariant, in2));
 }
 
+void DDENotifyDBus::SetAppInfos(const QVariantMap &in0)
+{
+    // handle method call org.deepin.dde.Notification1.SetAppInfos
+    QMetaObject::invokeMethod(parent(), "SetAppInfos", Q_ARG(QVariantMap, in0));
+}
+
 void DDENotifyDBus::SetSystemInfo(uint in0, const QDBusVariant &in1)
 {
     // handle method call org.deepin.dde.Notification1.SetSystemInfo
@@ -252,3 +266,15 @@ void DDENotifyDBus::ReplaceBubble(bool in0)
     QMetaObject::invokeMethod(parent(), "ReplaceBubble", Q_ARG(bool, in0));
 }
 
+void DDENotifyDBus::SetCompactBubble(bool in0)
+{
+    // handle method call org.deepin.dde.Notification1.SetCompactBubble
+    QMetaObject::invokeMethod(parent(), "SetCompactBubble", Q_ARG(bool, in0));
+}
+
+QDBusUnixFileDescriptor DDENotifyDBus::GetBubbleImage(const QString &in0, QVariantMap &out1)
+{
+    // handle method call org.deepin.dde.Notification1.GetBubbleImage
+    return static_cast<BubbleManager *>(parent())->GetBubbleImage(in0, out1);
+}
+
@@ -130,9 +130,27 @@ class DDENotifyDBus: public QDBusAbstractAdaptor
 "      <arg direction=\"in\" type=\"u\"/>\n"
 "      <arg direction=\"in\" type=\"v\"/>\n"
 "    </method>\n"
+"    <method name=\"GetAppInfos\">\n"
+"      <arg direction=\"in\" type=\"as\"/>\n"
+"      <arg direction=\"out\" type=\"a{sv}\"/>\n"
+"      <annotation value=\"QVariantMap\" name=\"org.qtproject.QtDBus.QtTypeName.Out0\"/>\n"
+"    </method>\n"
+"    <method name=\"SetAppInfos\">\n"
+"      <arg direction=\"in\" type=\"a{sv}\"/>\n"
+"      <annotation value=\"QVariantMap\" name=\"org.qtproject.QtDBus.QtTypeName.In0\"/>\n"
+"    </method>\n"
 "    <method name=\"ReplaceBubble\">\n"
 "      <arg direction=\"in\" type=\"b\"/>\n"
 "    </method>\n"
+"    <method name=\"SetCompactBubble\">\n"
+"      <arg direction=\"in\" type=\"b\"/>\n"
+"    </method>\n"
+"    <method name=\"GetBubbleImage\">\n"
+"      <arg direction=\"in\" type=\"s\"/>\n"
+"      <arg direction=\"out\" type=\"h\"/>\n"
+"      <arg direction=\"out\" type=\"a{sv}\"/>\n"
+"      <annotation value=\"QVariantMap\" name=\"org.qtproject.QtDBus.QtTypeName.Out1\"/>\n"
+"    </method>\n"
 "    <method name=\"HandleBubbleEnd\">\n"
 "      <arg direction=\"in\" type=\"u\"/>\n"
 "      <arg direction=\"in\" type=\"u\"/>\n"
@@ -148,6 +166,8 @@ class DDENotifyDBus: public QDBusAbstractAdaptor
 "    <method name=\"setAppSetting\">\n"
 "      <arg direction=\"in\" type=\"s\"/>\n"
 "    </method>\n"
+"    <!-- While any caller has enabled SetCompactBubble, image-data, image_data and icon_data are removed\n"
+"         from the hints and the image handle is passed as imageHandle in the last argument, see GetBubbleImage -->\n"
 "    <signal name=\"ShowBubble\">\n"
 "      <arg type=\"s\"/>\n"
 "      <arg type=\"u\"/>\n"
@@ -161,6 +181,19 @@ class DDENotifyDBus: public QDBusAbstractAdaptor
 "      <arg type=\"a{sv}\"/>\n"
 "      <annotation value=\"QVariantMap\" name=\"org.qtproject.QtDBus.QtTypeName.In8\"/>\n"
 "    </signal>\n"
+"    <signal name=\"ShowCompactBubble\">\n"
+"      <arg type=\"s\"/>\n"
+"      <arg type=\"u\"/>\n"
+"      <arg type=\"s\"/>\n"
+"      <arg type=\"s\"/>\n"
+"      <arg type=\"s\"/>\n"
+"      <arg type=\"as\"/>\n"
+"      <arg type=\"a{sv}\"/>\n"
+"      <annotation value=\"QVariantMap\" name=\"org.qtproject.QtDBus.QtTypeName.In6\"/>\n"
+"      <arg type=\"i\"/>\n"
+"      <arg type=\"a{sv}\"/>\n"
+"      <annotation value=\"QVariantMap\" name=\"org.qtproject.QtDBus.QtTypeName.In8\"/>\n"
+"    </signal>\n"
 "    <signal name=\"NotificationClosed\">\n"
 "      <arg type=\"u\"/>\n"
 "      <arg type=\"u\"/>\n"
@@ -177,6 +210,10 @@ class DDENotifyDBus: public QDBusAbstractAdaptor
 "      <arg type=\"u\"/>\n"
 "      <arg type=\"v\"/>\n"
 "    </signal>\n"
+"    <signal name=\"AppInfosChanged\">\n"
+"      <arg type=\"a{sv}\"/>\n"
+"      <annotation value=\"QVariantMap\" name=\"org.qtproject.QtDBus.QtTypeName.Out0\"/>\n"
+"    </signal>\n"
 "    <signal name=\"SystemInfoChanged\">\n"
 "      <arg type=\"u\"/>\n"
 "      <arg type=\"v\"/>\n"
@@ -221,6 +258,7 @@ public Q_SLOTS: // METHODS
     void CloseNotification(uint in0);
     QString GetAllRecords();
     QDBusVariant GetAppInfo(const QString &in0, uint in1);
+    QVariantMap GetAppInfos(const QStringList &in0);
     QStringList GetAppList();
     QStringList GetCapbilities();
     QString GetRecordById(const QString &in0);
@@ -230,6 +268,7 @@ public Q_SLOTS: // METHODS
     uint Notify(const QString &in0, uint in1, const QString &in2, const QString &in3, const QString &in4, const QStringList &in5, const QVariantMap &in6, int in7);
     void RemoveRecord(const QString &in0);
     void SetAppInfo(const QString &in0, uint in1, const QDBusVariant &in2);
+    void SetAppInfos(const QVariantMap &in0);
     void SetSystemInfo(uint in0, const QDBusVariant &in1);
     void Toggle();
     void Show();
@@ -239,11 +278,14 @@ public Q_SLOTS: // METHODS
     void setAppSetting(const QString &in0);
     void HandleBubbleEnd(uint in0, uint in1, const QVariantMap &in2, const QVariantMap &in3);
     void ReplaceBubble(bool in0);
+    void SetCompactBubble(bool in0);
+    QDBusUnixFileDescriptor GetBubbleImage(const QString &in0, QVariantMap &out1);
 Q_SIGNALS: // SIGNALS
     void ActionInvoked(uint in0, const QString &in1);
     void AppAddedSignal(const QString &in0);
     void AppRemovedSignal(const QString &in0);
     void AppInfoChanged(const QString &in0, uint in1, const QDBusVariant &in2);
+    void AppInfosChanged(const QVariantMap &in0);
     void NotificationClosed(uint in0, uint in1);
     void RecordAdded(const QString &in0);
     void SystemInfoChanged(uint in0, const QDBusVariant &in2);
@@ -252,6 +294,7 @@ Q_SIGNALS: // SIGNALS
     void appSettingChanged(const QString &in0);
     void systemSettingChanged(const QString &in0);
     void ShowBubble(const QString &in0, uint in1, const QString &in2, const QString &in3, const QString &in4, const QStringList &in5, const QVariantMap &in6, int in7, const QVariantMap &in8);
+    void ShowCompactBubble(const QString &in0, uint in1, const QString &in2, const QString &in3, const QString &in4, const QStringList &in5, const QVariantMap &in6, int in7, const QVariantMap &in8);
 };
 
 #endif
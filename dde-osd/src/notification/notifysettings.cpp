@@ -4,6 +4,8 @@
 
 #include "notifysettings.h"
 #include "constants.h"
+#include "desktopentryindex.h"
+#include "settingstransaction.h"
 
 #include <QGSettings>
 #include <QTimer>
@@ -11,11 +13,11 @@
 #include <QJsonObject>
 #include <QJsonDocument>
 #include <QByteArray>
-#include <DDesktopEntry>
 #include <QtConcurrent>
 #include <QStringList>
-
-DCORE_USE_NAMESPACE
+#include <QSet>
+#include <QScopedPointer>
+#include <QDebug>
 
 const QString schemaKey = "com.deepin.dde.notifications";
 const QString schemaPath = "/com/deepin/dde/notifications/";
@@ -35,6 +37,8 @@ NotifySettings::NotifySettings(QObject *parent)
     if (!QGSettings::isSchemaInstalled("com.deepin.dde.notification")) {
         qDebug()<<"System configuration fetch failed!";
     }
+    // 提前在后台构建desktop文件索引,供应用列表和通知中心显示应用名使用
+    DesktopEntryIndex::instance()->load();
     m_initTimer->start(1000);
     m_initTimer->setSingleShot(true);
     m_systemSetting = new QGSettings(schemaKey.toLocal8Bit(), schemaPath.toLocal8Bit(), this);
@@ -52,6 +56,15 @@ NotifySettings::NotifySettings(QObject *parent)
 
 void NotifySettings::initAllSettings()
 {
+    // desktop文件索引在后台线程中构建,构建完成后再同步应用列表
+    DesktopEntryIndex *desktopIndex = DesktopEntryIndex::instance();
+    if (!desktopIndex->isReady()) {
+        connect(desktopIndex, &DesktopEntryIndex::updated, this, &NotifySettings::initAllSettings, Qt::UniqueConnection);
+        desktopIndex->load();
+        return;
+    }
+    disconnect(desktopIndex, &DesktopEntryIndex::updated, this, &NotifySettings::initAllSettings);
+
     QDBusPendingCallWatcher *watcher = new QDBusPendingCallWatcher(m_launcherInter->GetAllItemInfos());
     QObject::connect(watcher, &QDBusPendingCallWatcher::finished,
                      this, [this](QDBusPendingCallWatcher *call) {
@@ -61,32 +74,52 @@ void NotifySettings::initAllSettings()
         } else {
             LauncherItemInfoList itemInfoList = reply.value();
 
-            QStringList appList = m_systemSetting->get("app-list").toStringList();
-            QStringList launcherList;
+            const QStringList oldAppList = m_systemSetting->get("app-list").toStringList();
+            QStringList appList = oldAppList;
+            QSet<QString> knownApps;
+            for (const QString &app : appList)
+                knownApps.insert(app);
+            QSet<QString> launcherApps;
+            QStringList addedApps;
+            // 所有修改在一个事务中提交,每个 schema 只写一次,app-list 不再随每个应用重写
+            SettingsTransaction transaction;
 
             foreach(const LauncherItemInfo &item, itemInfoList) {
-                launcherList << item.id;
-                DDesktopEntry desktopInfo(item.path);
-                if (IgnoreList.contains(item.id) || desktopInfo.rawValue("X-Created-By") == "Deepin WINE Team") {
+                launcherApps.insert(item.id);
+                if (IgnoreList.contains(item.id) || DesktopEntryIndex::instance()->entryByPath(item.path).createdBy == "Deepin WINE Team") {
                     continue;
                 }
 
-                if (appList.contains(item.id)) {
+                if (knownApps.contains(item.id)) {
                     // 修改系统语言后需要更新翻译
-                    QGSettings itemSetting(appSchemaKey.toLocal8Bit(), appSchemaPath.arg(item.id).toLocal8Bit(), this);
-                    itemSetting.set("app-name", item.name);
+                    transaction.set(appSchemaKey.toLocal8Bit(), appSchemaPath.arg(item.id).toLocal8Bit(), "app-name", item.name);
                     continue;
                 }
+                knownApps.insert(item.id);
                 appList.append(item.id);
-                m_systemSetting->set("app-list", appList);
-                appAdded(item);
+                addAppSettings(transaction, item);
+                addedApps.append(item.id);
             }
 
+            QStringList removedApps;
             for (const QString &app : appList) {
-                if (!launcherList.contains(app)) {
-                    appRemoved(app);
-                }
+                if (!launcherApps.contains(app))
+                    removedApps.append(app);
+            }
+            for (const QString &app : removedApps) {
+                appList.removeOne(app);
+                resetAppSettings(transaction, app);
             }
+
+            if (appList != oldAppList)
+                transaction.set(schemaKey.toLocal8Bit(), schemaPath.toLocal8Bit(), "app-list", appList);
+            transaction.commit();
+            syncAppSettingsCache();
+
+            for (const QString &app : addedApps)
+                Q_EMIT appAddedSignal(app);
+            for (const QString &app : removedApps)
+                Q_EMIT appRemovedSignal(app);
         }
 
         call->deleteLater();
@@ -130,6 +163,7 @@ void NotifySettings::setAppSetting(const QString &id, const NotifySettings::AppC
         return;
     }
 
+    updateAppSettingsCache(id);
     Q_EMIT appSettingChanged(id, item, var);
 }
 
@@ -170,6 +204,79 @@ QVariant NotifySettings::getAppSetting(const QString &id, const NotifySettings::
     return results;
 }
 
+QVariantMap NotifySettings::getAppSettings(const QStringList &ids)
+{
+    QVariantMap results;
+    for (const QString &id : ids) {
+        if (id.isEmpty() || results.contains(id))
+            continue;
+
+        // 缓存中的应用直接使用已有的 QGSettings,其他应用每个只构造一次
+        QGSettings *itemSetting = m_appSettings.value(id);
+        if (itemSetting != nullptr) {
+            results.insert(id, appSettingsMap(*itemSetting));
+            continue;
+        }
+        QGSettings tmpSetting(appSchemaKey.toLocal8Bit(), appSchemaPath.arg(id).toLocal8Bit(), this);
+        results.insert(id, appSettingsMap(tmpSetting));
+    }
+    return results;
+}
+
+void NotifySettings::setAppSettings(const QVariantMap &settings)
+{
+    const QByteArray &schema = appSchemaKey.toLocal8Bit();
+    SettingsTransaction transaction;
+    QVariantMap changes;
+
+    for (auto it = settings.cbegin(); it != settings.cend(); ++it) {
+        const QString &id = it.key();
+        if (id.isEmpty())
+            continue;
+
+        QScopedPointer<QGSettings> tmpSetting;
+        QGSettings *itemSetting = m_appSettings.value(id);
+        if (itemSetting == nullptr) {
+            tmpSetting.reset(new QGSettings(schema, appSchemaPath.arg(id).toLocal8Bit(), this));
+            itemSetting = tmpSetting.data();
+        }
+
+        // 和当前的值比较,只写入有变化的设置项
+        const QVariantMap &current = appSettingsMap(*itemSetting);
+        const QVariantMap &values = it.value().toMap();
+        QVariantMap appChanges;
+        for (auto valueIt = values.cbegin(); valueIt != values.cend(); ++valueIt) {
+            const QVariant &oldValue = current.value(valueIt.key());
+            if (!oldValue.isValid()) {
+                qWarning() << "unsupported app setting:" << id << valueIt.key();
+                continue;
+            }
+
+            QVariant newValue = valueIt.value();
+            if (!newValue.convert(oldValue.userType()) || newValue == oldValue)
+                continue;
+
+            const QString &key = appSettingsKey(static_cast<AppConfigurationItem>(valueIt.key().toInt()));
+            transaction.set(schema, appSchemaPath.arg(id).toLocal8Bit(), key, newValue);
+            appChanges.insert(valueIt.key(), newValue);
+        }
+        if (!appChanges.isEmpty())
+            changes.insert(id, appChanges);
+    }
+
+    if (changes.isEmpty())
+        return;
+
+    transaction.commit();
+    for (auto it = changes.cbegin(); it != changes.cend(); ++it) {
+        updateAppSettingsCache(it.key());
+        const QVariantMap &appChanges = it.value().toMap();
+        for (auto valueIt = appChanges.cbegin(); valueIt != appChanges.cend(); ++valueIt)
+            Q_EMIT appSettingChanged(it.key(), valueIt.key().toUInt(), valueIt.value());
+    }
+    Q_EMIT appSettingsChanged(changes);
+}
+
 void NotifySettings::setSystemSetting(const NotifySettings::SystemConfigurationItem &item, const QVariant &var)
 {
     switch (item) {
@@ -195,6 +302,7 @@ void NotifySettings::setSystemSetting(const NotifySettings::SystemConfigurationI
         return;
     }
 
+    updateSystemSettingsCache(QString());
     Q_EMIT systemSettingChanged(item, var);
 }
 
@@ -231,73 +339,88 @@ QStringList NotifySettings::getAppLists()
 
 void NotifySettings::appAdded(const LauncherItemInfo &info)
 {
+    SettingsTransaction transaction;
     QStringList appList = m_systemSetting->get("app-list").toStringList();
     if (!appList.contains(info.id)) {
         appList.append(info.id);
-        m_systemSetting->set("app-list", appList);
+        transaction.set(schemaKey.toLocal8Bit(), schemaPath.toLocal8Bit(), "app-list", appList);
     }
-
-    QGSettings itemSetting(appSchemaKey.toLocal8Bit(), appSchemaPath.arg(info.id).toLocal8Bit(), this);
-
-    itemSetting.set("app-name", info.name);
-    itemSetting.set("app-icon", info.icon);
-    itemSetting.set("enable-notification", DEFAULT_ALLOW_NOTIFY);
-    itemSetting.set("enable-preview", DEFAULT_SHOW_NOTIFY_PREVIEW);
-    itemSetting.set("enable-sound", DEFAULT_NOTIFY_SOUND);
-    itemSetting.set("show-in-notification-center", DEFAULT_ONLY_IN_NOTIFY);
-    itemSetting.set("lockscreen-show-notification", DEFAULT_LOCK_SHOW_NOTIFY);
+    addAppSettings(transaction, info);
+    transaction.commit();
+    syncAppSettingsCache();
 
     Q_EMIT appAddedSignal(info.id);
 }
 
 void NotifySettings::appRemoved(const QString &id)
 {
+    SettingsTransaction transaction;
     QStringList appList = m_systemSetting->get("app-list").toStringList();
     if (appList.contains(id)) {
         appList.removeOne(id);
-        m_systemSetting->set("app-list", appList);
+        transaction.set(schemaKey.toLocal8Bit(), schemaPath.toLocal8Bit(), "app-list", appList);
     }
-
-    QGSettings itemSetting(appSchemaKey.toLocal8Bit(), appSchemaPath.arg(id).toLocal8Bit(), this);
-    itemSetting.reset("app-name");
-    itemSetting.reset("app-icon");
-    itemSetting.reset("enable-notification");
-    itemSetting.reset("enable-preview");
-    itemSetting.reset("enable-sound");
-    itemSetting.reset("show-in-notification-center");
-    itemSetting.reset("lockscreen-show-notification");
+    resetAppSettings(transaction, id);
+    transaction.commit();
+    syncAppSettingsCache();
 
     Q_EMIT appRemovedSignal(id);
 }
 
+void NotifySettings::addAppSettings(SettingsTransaction &transaction, const LauncherItemInfo &info)
+{
+    const QByteArray &path = appSchemaPath.arg(info.id).toLocal8Bit();
+    const QByteArray &schema = appSchemaKey.toLocal8Bit();
+    transaction.set(schema, path, "app-name", info.name);
+    transaction.set(schema, path, "app-icon", info.icon);
+    transaction.set(schema, path, "enable-notification", DEFAULT_ALLOW_NOTIFY);
+    transaction.set(schema, path, "enable-preview", DEFAULT_SHOW_NOTIFY_PREVIEW);
+    transaction.set(schema, path, "enable-sound", DEFAULT_NOTIFY_SOUND);
+    transaction.set(schema, path, "show-in-notification-center", DEFAULT_ONLY_IN_NOTIFY);
+    transaction.set(schema, path, "lockscreen-show-notification", DEFAULT_LOCK_SHOW_NOTIFY);
+}
+
+void NotifySettings::resetAppSettings(SettingsTransaction &transaction, const QString &id)
+{
+    const QByteArray &path = appSchemaPath.arg(id).toLocal8Bit();
+    const QByteArray &schema = appSchemaKey.toLocal8Bit();
+    transaction.reset(schema, path, "app-name");
+    transaction.reset(schema, path, "app-icon");
+    transaction.reset(schema, path, "enable-notification");
+    transaction.reset(schema, path, "enable-preview");
+    transaction.reset(schema, path, "enable-sound");
+    transaction.reset(schema, path, "show-in-notification-center");
+    transaction.reset(schema, path, "lockscreen-show-notification");
+}
+
 void NotifySettings::setAppSetting_v1(QString settings)
 {
     QJsonObject jsonObj = QJsonDocument::fromJson(settings.toLocal8Bit()).object();
     QString id = jsonObj.begin().key();
     jsonObj = jsonObj.begin().value().toObject();
-    QGSettings itemSetting(appSchemaKey.toLocal8Bit(), appSchemaPath.arg(id).toLocal8Bit(), this);
-    itemSetting.set("enable-notification", jsonObj[AllowNotifyStr].toBool());
-    itemSetting.set("show-in-notification-center", jsonObj[ShowInNotifyCenterStr].toBool());
-    itemSetting.set("lockscreen-show-notification", jsonObj[LockShowNotifyStr].toBool());
-    itemSetting.set("enable-preview", jsonObj[ShowNotifyPreviewStr].toBool());
-    itemSetting.set("enable-sound", jsonObj[NotificationSoundStr].toBool());
-    itemSetting.set("app-icon", jsonObj[AppIconStr].toString());
-    itemSetting.set("app-name", jsonObj[AppNameStr].toString());
+    const QByteArray &path = appSchemaPath.arg(id).toLocal8Bit();
+    const QByteArray &schema = appSchemaKey.toLocal8Bit();
+    SettingsTransaction transaction;
+    transaction.set(schema, path, "enable-notification", jsonObj[AllowNotifyStr].toBool());
+    transaction.set(schema, path, "show-in-notification-center", jsonObj[ShowInNotifyCenterStr].toBool());
+    transaction.set(schema, path, "lockscreen-show-notification", jsonObj[LockShowNotifyStr].toBool());
+    transaction.set(schema, path, "enable-preview", jsonObj[ShowNotifyPreviewStr].toBool());
+    transaction.set(schema, path, "enable-sound", jsonObj[NotificationSoundStr].toBool());
+    transaction.set(schema, path, "app-icon", jsonObj[AppIconStr].toString());
+    transaction.set(schema, path, "app-name", jsonObj[AppNameStr].toString());
+    transaction.commit();
+    updateAppSettingsCache(id);
 }
 
 QString NotifySettings::getAppSettings_v1(const QString &id)
 {
-    QGSettings itemSetting(appSchemaKey.toLocal8Bit(), appSchemaPath.arg(id).toLocal8Bit(), this);
-    QJsonObject jsonObj;
-    jsonObj.insert(AllowNotifyStr, itemSetting.get("enable-notification").toJsonValue());
-    jsonObj.insert(ShowInNotifyCenterStr, itemSetting.get("show-in-notification-center").toJsonValue());
-    jsonObj.insert(LockShowNotifyStr, itemSetting.get("lockscreen-show-notification").toJsonValue());
-    jsonObj.insert(ShowNotifyPreviewStr, itemSetting.get("enable-preview").toJsonValue());
-    jsonObj.insert(NotificationSoundStr, itemSetting.get("enable-sound").toJsonValue());
-    jsonObj.insert(AppIconStr, itemSetting.get("app-icon").toJsonValue());
-    jsonObj.insert(AppNameStr, itemSetting.get("app-name").toJsonValue());
     QJsonObject appSetingObj;
-    appSetingObj[id] = jsonObj;
+    if (m_appSettings.contains(id)) {
+        appSetingObj[id] = m_allSettings.value(id);
+    } else {
+        QGSettings itemSetting(appSchemaKey.toLocal8Bit(), appSchemaPath.arg(id).toLocal8Bit(), this);
+        appSetingObj[id] = appSettingsObject(itemSetting);
+    }
     return QString(QJsonDocument(appSetingObj).toJson());
 }
 
@@ -305,39 +428,43 @@ void NotifySettings::setSystemSetting_v1(QString settings)
 {
     QJsonObject jsonObj = QJsonDocument::fromJson(settings.toUtf8()).object();
     jsonObj = jsonObj.begin().value().toObject();
+    const QByteArray &path = schemaPath.toLocal8Bit();
+    const QByteArray &schema = schemaKey.toLocal8Bit();
+    SettingsTransaction transaction;
     if (jsonObj.contains(DoNotDisturbStr)) {
-        m_systemSetting->set("dndmode", jsonObj[DoNotDisturbStr].toBool());
-        Q_EMIT systemSettingChanged(DNDMODE, jsonObj[DoNotDisturbStr].toBool());
+        transaction.set(schema, path, "dndmode", jsonObj[DoNotDisturbStr].toBool());
     }
     if (jsonObj.contains(ScreenLockedStr)) {
-        m_systemSetting->set("lockscreen-open-dndmode", jsonObj[ScreenLockedStr].toBool());
+        transaction.set(schema, path, "lockscreen-open-dndmode", jsonObj[ScreenLockedStr].toBool());
     }
     if (jsonObj.contains(TimeSlotStr)) {
-        m_systemSetting->set("open-by-time-interval", jsonObj[TimeSlotStr].toBool());
+        transaction.set(schema, path, "open-by-time-interval", jsonObj[TimeSlotStr].toBool());
     }
     if (jsonObj.contains(StartTimeStr)) {
-        m_systemSetting->set("start-time", jsonObj[StartTimeStr].toString());
+        transaction.set(schema, path, "start-time", jsonObj[StartTimeStr].toString());
     }
     if (jsonObj.contains(EndTimeStr)) {
-        m_systemSetting->set("end-time", jsonObj[EndTimeStr].toString());
+        transaction.set(schema, path, "end-time", jsonObj[EndTimeStr].toString());
+    }
+    if (jsonObj.contains(ShowIconOnDockStr)) {
+        transaction.set(schema, path, "show-icon", jsonObj[ShowIconOnDockStr].toBool());
+    }
+    transaction.commit();
+    updateSystemSettingsCache(QString());
+
+    if (jsonObj.contains(DoNotDisturbStr)) {
+        Q_EMIT systemSettingChanged(DNDMODE, jsonObj[DoNotDisturbStr].toBool());
     }
     if (jsonObj.contains(ShowIconOnDockStr)) {
-        m_systemSetting->set("show-icon", jsonObj[ShowIconOnDockStr].toBool());
         Q_EMIT systemSettingChanged(SHOWICON, jsonObj[ShowIconOnDockStr].toBool());
     }
 }
 
 QString NotifySettings::getSystemSetings_v1()
 {
-    QJsonObject jsonObj;
-    jsonObj.insert(DoNotDisturbStr, m_systemSetting->get("dndmode").toJsonValue());
-    jsonObj.insert(ScreenLockedStr, m_systemSetting->get("lockscreen-open-dndmode").toJsonValue());
-    jsonObj.insert(TimeSlotStr, m_systemSetting->get("open-by-time-interval").toJsonValue());
-    jsonObj.insert(StartTimeStr, m_systemSetting->get("start-time").toJsonValue());
-    jsonObj.insert(EndTimeStr, m_systemSetting->get("end-time").toJsonValue());
-    jsonObj.insert(ShowIconOnDockStr, m_systemSetting->get("show-icon").toJsonValue());
     QJsonObject SystemSetingObj;
-    SystemSetingObj[SystemNotifySettingStr] = jsonObj;
+    SystemSetingObj[SystemNotifySettingStr] = m_settingsCacheReady ? m_allSettings.value(SystemNotifySettingStr).toObject()
+                                                                  : systemSettingsObject();
     return QString(QJsonDocument(SystemSetingObj).toJson());
 }
 
@@ -349,31 +476,143 @@ void NotifySettings::setAllSetting_v1(QString settings)
 
 QString NotifySettings::getAllSetings_v1()
 {
-    QStringList appList = m_systemSetting->get("app-list").toStringList();
+    // 控制中心打开通知页面时调用,直接返回缓存的结果,不再逐个读取所有应用的设置
+    ensureSettingsCache();
+    if (m_allSettingsJson.isEmpty())
+        m_allSettingsJson = QString(QJsonDocument(m_allSettings).toJson());
+    return m_allSettingsJson;
+}
+
+QVariantMap NotifySettings::appSettingsMap(const QGSettings &settings)
+{
+    QVariantMap values;
+    for (int item = APPNAME; item <= SHOWONTOP; ++item) {
+        const QString &key = appSettingsKey(static_cast<AppConfigurationItem>(item));
+        // 旧版本的 schema 中没有 show-on-top
+        if (item == SHOWONTOP && !containsAppSettings(settings, key))
+            continue;
+        values.insert(QString::number(item), settings.get(key));
+    }
+    return values;
+}
 
+QString NotifySettings::appSettingsKey(AppConfigurationItem item)
+{
+    switch (item) {
+    case APPNAME:
+        return "app-name";
+    case APPICON:
+        return "app-icon";
+    case ENABELNOTIFICATION:
+        return "enable-notification";
+    case ENABELPREVIEW:
+        return "enable-preview";
+    case ENABELSOUND:
+        return "enable-sound";
+    case SHOWINNOTIFICATIONCENTER:
+        return "show-in-notification-center";
+    case LOCKSCREENSHOWNOTIFICATION:
+        return "lockscreen-show-notification";
+    case SHOWONTOP:
+        return "show-on-top";
+    }
+    return QString();
+}
+
+QJsonObject NotifySettings::appSettingsObject(const QGSettings &settings)
+{
+    QJsonObject itemObj;
+    itemObj.insert(AllowNotifyStr, settings.get("enable-notification").toJsonValue());
+    itemObj.insert(ShowInNotifyCenterStr, settings.get("show-in-notification-center").toJsonValue());
+    itemObj.insert(LockShowNotifyStr, settings.get("lockscreen-show-notification").toJsonValue());
+    itemObj.insert(ShowNotifyPreviewStr, settings.get("enable-preview").toJsonValue());
+    itemObj.insert(NotificationSoundStr, settings.get("enable-sound").toJsonValue());
+    itemObj.insert(AppIconStr, settings.get("app-icon").toJsonValue());
+    itemObj.insert(AppNameStr, settings.get("app-name").toJsonValue());
+    return itemObj;
+}
+
+QJsonObject NotifySettings::systemSettingsObject() const
+{
     QJsonObject jsonObj;
-    foreach (const auto &id, appList) {
-        QGSettings itemSetting(appSchemaKey.toLocal8Bit(), appSchemaPath.arg(id).toLocal8Bit(), this);
-        QJsonObject itemObj;
-        itemObj.insert(AllowNotifyStr, itemSetting.get("enable-notification").toJsonValue());
-        itemObj.insert(ShowInNotifyCenterStr, itemSetting.get("show-in-notification-center").toJsonValue());
-        itemObj.insert(LockShowNotifyStr, itemSetting.get("lockscreen-show-notification").toJsonValue());
-        itemObj.insert(ShowNotifyPreviewStr, itemSetting.get("enable-preview").toJsonValue());
-        itemObj.insert(NotificationSoundStr, itemSetting.get("enable-sound").toJsonValue());
-        itemObj.insert(AppIconStr, itemSetting.get("app-icon").toJsonValue());
-        itemObj.insert(AppNameStr, itemSetting.get("app-name").toJsonValue());
-        jsonObj[id] = itemObj;
+    jsonObj.insert(DoNotDisturbStr, m_systemSetting->get("dndmode").toJsonValue());
+    jsonObj.insert(ScreenLockedStr, m_systemSetting->get("lockscreen-open-dndmode").toJsonValue());
+    jsonObj.insert(TimeSlotStr, m_systemSetting->get("open-by-time-interval").toJsonValue());
+    jsonObj.insert(StartTimeStr, m_systemSetting->get("start-time").toJsonValue());
+    jsonObj.insert(EndTimeStr, m_systemSetting->get("end-time").toJsonValue());
+    jsonObj.insert(ShowIconOnDockStr, m_systemSetting->get("show-icon").toJsonValue());
+    return jsonObj;
+}
+
+void NotifySettings::ensureSettingsCache()
+{
+    if (m_settingsCacheReady)
+        return;
+
+    m_settingsCacheReady = true;
+    // 其他进程直接修改 GSettings 时也能更新缓存
+    connect(m_systemSetting, &QGSettings::changed, this, &NotifySettings::updateSystemSettingsCache);
+    m_allSettings = QJsonObject();
+    m_allSettings[SystemNotifySettingStr] = systemSettingsObject();
+    syncAppSettingsCache();
+}
+
+void NotifySettings::syncAppSettingsCache()
+{
+    if (!m_settingsCacheReady)
+        return;
+
+    const QStringList &appList = m_systemSetting->get("app-list").toStringList();
+    QSet<QString> apps;
+    for (const QString &id : appList)
+        apps.insert(id);
+
+    for (auto it = m_appSettings.begin(); it != m_appSettings.end();) {
+        if (apps.contains(it.key())) {
+            ++it;
+            continue;
+        }
+        m_allSettings.remove(it.key());
+        delete it.value();
+        it = m_appSettings.erase(it);
+    }
+
+    for (const QString &id : appList) {
+        if (m_appSettings.contains(id))
+            continue;
+
+        QGSettings *itemSetting = new QGSettings(appSchemaKey.toLocal8Bit(), appSchemaPath.arg(id).toLocal8Bit(), this);
+        connect(itemSetting, &QGSettings::changed, this, [this, id] {
+            updateAppSettingsCache(id);
+        });
+        m_appSettings.insert(id, itemSetting);
+        m_allSettings[id] = appSettingsObject(*itemSetting);
+    }
+    m_allSettingsJson.clear();
+}
+
+void NotifySettings::updateAppSettingsCache(const QString &id)
+{
+    QGSettings *itemSetting = m_appSettings.value(id);
+    if (itemSetting == nullptr)
+        return;
+
+    m_allSettings[id] = appSettingsObject(*itemSetting);
+    m_allSettingsJson.clear();
+}
+
+void NotifySettings::updateSystemSettingsCache(const QString &key)
+{
+    if (!m_settingsCacheReady)
+        return;
+
+    if (key == "appList") {
+        syncAppSettingsCache();
+        return;
     }
 
-    QJsonObject Obj;
-    Obj.insert(DoNotDisturbStr, m_systemSetting->get("dndmode").toJsonValue());
-    Obj.insert(ScreenLockedStr, m_systemSetting->get("lockscreen-open-dndmode").toJsonValue());
-    Obj.insert(TimeSlotStr, m_systemSetting->get("open-by-time-interval").toJsonValue());
-    Obj.insert(StartTimeStr, m_systemSetting->get("start-time").toJsonValue());
-    Obj.insert(EndTimeStr, m_systemSetting->get("end-time").toJsonValue());
-    Obj.insert(ShowIconOnDockStr, m_systemSetting->get("show-icon").toJsonValue());
-    jsonObj[SystemNotifySettingStr] = Obj;
-    return QString(QJsonDocument(jsonObj).toJson());
+    m_allSettings[SystemNotifySettingStr] = systemSettingsObject();
+    m_allSettingsJson.clear();
 }
 
 // it exists in gsettings-qt package of util.h, but it not installed in dev package.
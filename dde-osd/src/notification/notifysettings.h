@@ -10,9 +10,13 @@
 #include "types/launcheriteminfolist.h"
 
 #include <QObject>
+#include <QHash>
+#include <QJsonObject>
+#include <QVariantMap>
 
 class QGSettings;
 class QTimer;
+class SettingsTransaction;
 
 using LauncherInter = org::deepin::dde::daemon::Launcher1;
 
@@ -46,6 +50,16 @@ public:
     virtual void initAllSettings() = 0;
     virtual void setAppSetting(const QString &id, const AppConfigurationItem &item, const QVariant &var) = 0;
     virtual QVariant getAppSetting(const QString &id, const AppConfigurationItem &item) = 0;
+    /*!
+     * \~chinese \name getAppSettings
+     * \~chinese \brief 批量获取应用的设置,每个应用只读取一次,返回 应用id -> (设置项编号 -> 值)
+     */
+    virtual QVariantMap getAppSettings(const QStringList &ids) = 0;
+    /*!
+     * \~chinese \name setAppSettings
+     * \~chinese \brief 批量修改应用的设置,参数格式和 getAppSettings 的返回值相同,只写入值有变化的设置项
+     */
+    virtual void setAppSettings(const QVariantMap &settings) = 0;
     virtual void setSystemSetting(const SystemConfigurationItem &item, const QVariant &var) = 0;
     virtual QVariant getSystemSetting(const SystemConfigurationItem &item) = 0;
     virtual QStringList getAppLists() = 0;
@@ -64,6 +78,7 @@ signals:
     void appAddedSignal(const QString &id);
     void appRemovedSignal(const QString &id);
     void appSettingChanged(const QString &id, const uint &item, QVariant var);
+    void appSettingsChanged(const QVariantMap &changes);    // 一次批量修改中值有变化的设置项
     void systemSettingChanged(const uint &item, QVariant var);
 };
 
@@ -75,6 +90,8 @@ public:
     void initAllSettings() override;
     void setAppSetting(const QString &id, const AppConfigurationItem &item, const QVariant &var) override;
     QVariant getAppSetting(const QString &id, const AppConfigurationItem &item) override;
+    QVariantMap getAppSettings(const QStringList &ids) override;
+    void setAppSettings(const QVariantMap &settings) override;
     void setSystemSetting(const SystemConfigurationItem &item, const QVariant &var) override;
     QVariant getSystemSetting(const SystemConfigurationItem &item) override;
     QStringList getAppLists() override;
@@ -91,10 +108,31 @@ public:
 
 private:
     bool containsAppSettings(const QGSettings &settings, const QString &id);
+    void addAppSettings(SettingsTransaction &transaction, const LauncherItemInfo &info);    // 新应用的默认设置
+    void resetAppSettings(SettingsTransaction &transaction, const QString &id);
+
+    QVariantMap appSettingsMap(const QGSettings &settings);  // 设置项编号 -> 值
+    static QString appSettingsKey(AppConfigurationItem item);
+
+    static QJsonObject appSettingsObject(const QGSettings &settings);
+    QJsonObject systemSettingsObject() const;
+    /*!
+     * \~chinese \name ensureSettingsCache
+     * \~chinese \brief 第一次获取全部设置时建立缓存,之后按 GSettings 的变化只更新对应的应用或者系统设置,
+     * \~chinese 序列化后的 JSON 在下次获取时才重新生成
+     */
+    void ensureSettingsCache();
+    void syncAppSettingsCache();                            // 按 app-list 增删缓存中的应用
+    void updateAppSettingsCache(const QString &id);
+    void updateSystemSettingsCache(const QString &key);
 
     QTimer *m_initTimer;
     QGSettings *m_systemSetting;
     LauncherInter *m_launcherInter;
+    bool m_settingsCacheReady = false;
+    QHash<QString, QGSettings *> m_appSettings;             // 缓存中每个应用的设置,用于监听变化
+    QJsonObject m_allSettings;                              // 所有应用和系统设置
+    QString m_allSettingsJson;                              // m_allSettings 序列化的结果,为空时需要重新生成
 };
 
 #endif // NOTIFYSETTINGS_H
@@ -0,0 +1,131 @@
+// SPDX-FileCopyrightText: 2024 UnionTech Software Technology Co., Ltd.
+//
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+#include "notifystyle.h"
+
+#include <QWidget>
+#include <QEvent>
+#include <QTimer>
+#include <QFontMetrics>
+
+#include <DFontSizeManager>
+
+DGUI_USE_NAMESPACE
+DWIDGET_USE_NAMESPACE
+
+NotifyStyle::NotifyStyle(QObject *parent)
+    : QObject(parent)
+    , m_style(compute(1))
+    , m_refreshTimer(new QTimer(this))
+{
+    m_refreshTimer->setSingleShot(true);
+    m_refreshTimer->setInterval(0);
+    connect(m_refreshTimer, &QTimer::timeout, this, &NotifyStyle::refresh);
+
+    connect(DGuiApplicationHelper::instance(), &DGuiApplicationHelper::themeTypeChanged, m_refreshTimer, static_cast<void (QTimer::*)()>(&QTimer::start));
+    connect(DGuiApplicationHelper::instance(), &DGuiApplicationHelper::fontChanged, m_refreshTimer, static_cast<void (QTimer::*)()>(&QTimer::start));
+}
+
+void NotifyStyle::subscribe(QWidget *widget, const Applier &apply)
+{
+    if (widget == nullptr || !apply)
+        return;
+
+    if (!m_subscribers.contains(widget)) {
+        widget->installEventFilter(this);
+        // 发出 destroyed 时 QWidget 部分已经析构,只用指针作为键删除
+        connect(widget, &QObject::destroyed, this, [this, widget] {
+            m_subscribers.remove(widget);
+        });
+    }
+
+    Subscriber &subscriber = m_subscribers[widget];
+    subscriber.apply = apply;
+    subscriber.generation = m_style->generation;
+    apply(m_style);
+}
+
+void NotifyStyle::unsubscribe(QWidget *widget)
+{
+    if (m_subscribers.remove(widget) == 0)
+        return;
+
+    widget->removeEventFilter(this);
+    disconnect(widget, &QObject::destroyed, this, nullptr);
+}
+
+int NotifyStyle::pendingCount() const
+{
+    int count = 0;
+    for (const Subscriber &subscriber : m_subscribers) {
+        if (subscriber.generation != m_style->generation)
+            count++;
+    }
+    return count;
+}
+
+void NotifyStyle::refresh()
+{
+    m_refreshTimer->stop();
+    m_style = compute(m_style->generation + 1);
+    Q_EMIT styleChanged(m_style);
+
+    // 只更新可见的控件,同一个窗口中的控件更新完后整个窗口重绘一次
+    QHash<QWidget *, QList<QWidget *>> windows;
+    for (auto it = m_subscribers.cbegin(); it != m_subscribers.cend(); ++it) {
+        if (it.key()->isVisible())
+            windows[it.key()->window()].append(it.key());
+    }
+
+    for (auto it = windows.cbegin(); it != windows.cend(); ++it) {
+        QWidget *window = it.key();
+        const bool updatesEnabled = window->updatesEnabled();
+        window->setUpdatesEnabled(false);
+        for (QWidget *widget : it.value()) {
+            auto subscriber = m_subscribers.find(widget);
+            if (subscriber == m_subscribers.end())
+                continue;
+            subscriber->generation = m_style->generation;
+            const Applier apply = subscriber->apply;
+            apply(m_style);
+        }
+        if (updatesEnabled)
+            window->setUpdatesEnabled(true);
+    }
+}
+
+bool NotifyStyle::eventFilter(QObject *watched, QEvent *event)
+{
+    if (event->type() == QEvent::Show) {
+        // 隐藏期间错过的样式在显示之前补上
+        auto subscriber = m_subscribers.find(static_cast<QWidget *>(watched));
+        if (subscriber != m_subscribers.end() && subscriber->generation != m_style->generation) {
+            subscriber->generation = m_style->generation;
+            const Applier apply = subscriber->apply;
+            apply(m_style);
+        }
+    }
+    return QObject::eventFilter(watched, event);
+}
+
+NotifyStylePtr NotifyStyle::compute(quint64 generation)
+{
+    QSharedPointer<NotifyStyleData> style(new NotifyStyleData);
+    style->themeType = DGuiApplicationHelper::instance()->themeType();
+    style->generation = generation;
+
+    DFontSizeManager *fontManager = DFontSizeManager::instance();
+    style->groupTitleFont = fontManager->t4();
+    style->groupTitleFont.setBold(true);
+    style->groupTitleFont.setWeight(QFont::DemiBold);
+    style->summaryFont = fontManager->t6();
+    style->bodyFont = fontManager->t7();
+    style->captionFont = fontManager->t8();
+
+    style->groupTitleHeight = QFontMetrics(style->groupTitleFont).height();
+    style->summaryHeight = QFontMetrics(style->summaryFont).height();
+    style->bodyHeight = QFontMetrics(style->bodyFont).height();
+    style->captionHeight = QFontMetrics(style->captionFont).height();
+    return style;
+}
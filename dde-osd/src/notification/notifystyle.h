@@ -0,0 +1,90 @@
+// SPDX-FileCopyrightText: 2024 UnionTech Software Technology Co., Ltd.
+//
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+#ifndef NOTIFYSTYLE_H
+#define NOTIFYSTYLE_H
+
+#include <QObject>
+#include <QFont>
+#include <QHash>
+#include <QSharedPointer>
+#include <DSingleton>
+#include <DGuiApplicationHelper>
+
+#include <functional>
+
+class QTimer;
+
+/*!
+ * \~chinese \class NotifyStyleData
+ * \~chinese \brief 由主题和系统字体计算出来的样式数据,创建后不再修改,可以在多个控件之间共享
+ */
+struct NotifyStyleData {
+    Dtk::Gui::DGuiApplicationHelper::ColorType themeType = Dtk::Gui::DGuiApplicationHelper::UnknownType;
+    quint64 generation = 0;     // 每次重新计算加一
+    QFont groupTitleFont;       // T4 加粗, 通知中心分组标题
+    QFont summaryFont;          // T6, 通知标题
+    QFont bodyFont;             // T7, 通知正文和按钮
+    QFont captionFont;          // T8, 应用名称和时间
+    int groupTitleHeight = 0;
+    int summaryHeight = 0;
+    int bodyHeight = 0;
+    int captionHeight = 0;
+};
+typedef QSharedPointer<const NotifyStyleData> NotifyStylePtr;
+
+/*!
+ * \~chinese \class NotifyStyle
+ * \~chinese \brief 通知控件的样式广播,只有它监听主题和字体的变化,样式数据计算一次后发布给所有订阅的控件.
+ * \~chinese 可见的控件按顶层窗口成批更新,只重绘一次;不可见的控件等到显示时再更新
+ */
+class NotifyStyle : public QObject, public Dtk::Core::DSingleton<NotifyStyle>
+{
+    Q_OBJECT
+    friend class Dtk::Core::DSingleton<NotifyStyle>;
+
+public:
+    typedef std::function<void(const NotifyStylePtr &)> Applier;
+
+    NotifyStylePtr current() const { return m_style; }
+
+    /*!
+     * \~chinese \name subscribe
+     * \~chinese \brief 订阅样式变化,apply 立即以当前样式调用一次,控件销毁时自动取消订阅
+     */
+    void subscribe(QWidget *widget, const Applier &apply);
+    void unsubscribe(QWidget *widget);
+    int subscriberCount() const { return m_subscribers.size(); }
+    int pendingCount() const;   // 等待显示时更新的控件数量
+
+public Q_SLOTS:
+    void refresh();             // 立即重新计算样式并更新订阅的控件
+
+Q_SIGNALS:
+    /*!
+     * \~chinese \name styleChanged
+     * \~chinese \brief 新的样式已经计算好,在更新控件之前发出,缓存应该在这里清空
+     */
+    void styleChanged(const NotifyStylePtr &style);
+
+protected:
+    bool eventFilter(QObject *watched, QEvent *event) override;
+
+private:
+    explicit NotifyStyle(QObject *parent = nullptr);
+
+    static NotifyStylePtr compute(quint64 generation);
+
+private:
+    struct Subscriber {
+        Applier apply;
+        quint64 generation = 0; // 控件已经应用的样式
+    };
+
+    NotifyStylePtr m_style;
+    QHash<QWidget *, Subscriber> m_subscribers;
+    QTimer *m_refreshTimer;     // 主题和字体同时变化时合并为一次更新
+};
+
+#endif // NOTIFYSTYLE_H
@@ -14,6 +14,9 @@
 #include <QJsonObject>
 #include <QMapIterator>
 #include <QSqlTableModel>
+#include <QHash>
+
+#include <algorithm>
 
 #include "notificationentity.h"
 
@@ -30,6 +33,65 @@ static const QString ColumnHint = "Hint";
 static const QString ColumnReplacesId = "ReplacesId";
 static const QString ColumnTimeout = "Timeout";
 
+QList<NotificationRecord> AbstractPersistence::getAllNotifyRecords()
+{
+    QList<NotificationRecord> records;
+    for (const EntityPtr &entity : getAllNotify()) {
+        records.append(entity->record());
+    }
+    return records;
+}
+
+QList<NotifyGroupSummary> AbstractPersistence::getGroupSummaries()
+{
+    QHash<QString, int> indexes;
+    QList<NotifyGroupSummary> summaries;
+    for (const NotificationRecord &record : getAllNotifyRecords()) {
+        auto it = indexes.find(record.appName());
+        if (it == indexes.end()) {
+            it = indexes.insert(record.appName(), summaries.size());
+            NotifyGroupSummary summary;
+            summary.appName = record.appName();
+            summaries.append(summary);
+        }
+        NotifyGroupSummary &summary = summaries[it.value()];
+        summary.lastCTime = qMax(summary.lastCTime, record.ctime());
+        summary.count++;
+    }
+    return summaries;
+}
+
+// 和数据库查询的排序一致: 时间从新到旧,时间相同时ID大的在前
+static bool newerThan(const NotificationRecord &record, qint64 ctime, qint64 id)
+{
+    return record.ctime() > ctime || (record.ctime() == ctime && record.id() > id);
+}
+
+QList<NotificationRecord> AbstractPersistence::getAppNotifyRecords(const QString &appName, qint64 beforeCTime, qint64 beforeId, int limit)
+{
+    QList<NotificationRecord> records;
+    for (const NotificationRecord &record : getAllNotifyRecords()) {
+        if (record.appName() != appName)
+            continue;
+        if (beforeCTime > 0 && (newerThan(record, beforeCTime, beforeId)
+                                || (record.ctime() == beforeCTime && record.id() == beforeId)))
+            continue;
+        records.append(record);
+    }
+    std::sort(records.begin(), records.end(), [](const NotificationRecord &record1, const NotificationRecord &record2) {
+        return newerThan(record1, record2.ctime(), record2.id());
+    });
+    return records.mid(0, limit);
+}
+
+void AbstractPersistence::removeBefore(qint64 ctime)
+{
+    for (const NotificationRecord &record : getAllNotifyRecords()) {
+        if (record.ctime() < ctime)
+            removeOne(QString::number(record.id()));
+    }
+}
+
 Persistence::Persistence(QObject *parent)
     : AbstractPersistence(parent)
 {
@@ -125,6 +187,29 @@ void Persistence::addAll(QList<EntityPtr> entities)
     }
 }
 
+bool Persistence::updateOne(EntityPtr entity)
+{
+    // 没有保存到数据库的通知不需要更新
+    if (entity->storageId().isEmpty())
+        return true;
+
+    m_query.prepare(QString("UPDATE %1 SET %2 = :ctime, %3 = :hint WHERE ID = :id").arg(TableName_v2, ColumnCTime, ColumnHint));
+    m_query.bindValue(":ctime", entity->ctime());
+    m_query.bindValue(":hint", ConvertMapToString(entity->hints()));
+    m_query.bindValue(":id", entity->storageId());
+
+    if (!m_query.exec()) {
+        qWarning() << "update value:" << entity->storageId() << "failed: " << m_query.lastError().text();
+        return false;
+    }
+    // 通知中心或者 RemoveRecord 已经删除了这条记录
+    if (m_query.numRowsAffected() <= 0)
+        return false;
+
+    Q_EMIT RecordUpdated(entity);
+    return true;
+}
+
 void Persistence::removeOne(const QString &id)
 {
     m_query.prepare(QString("DELETE FROM %1 WHERE ID = (:id)").arg(TableName_v2));
@@ -227,15 +312,46 @@ QString Persistence::getAll()
 QList<EntityPtr> Persistence::getAllNotify()
 {
     QList<EntityPtr> db_notification;
-    QString json = getAll();
-    QJsonArray notify_array = QJsonDocument::fromJson(json.toLocal8Bit().data()).array();
+    const QList<NotificationRecord> &records = getAllNotifyRecords();
+    db_notification.reserve(records.size());
 
-    foreach (auto notify, notify_array) {
-        db_notification.append(fromJsonValue(notify));
+    for (const NotificationRecord &record : records) {
+        db_notification.append(std::make_shared<NotificationEntity>(record));
     }
     return db_notification;
 }
 
+QList<NotificationRecord> Persistence::getAllNotifyRecords()
+{
+    QList<NotificationRecord> records;
+
+    QString sqlCmd = QString("SELECT ");
+    sqlCmd += ColumnId + ",";
+    sqlCmd += ColumnIcon + ",";
+    sqlCmd += ColumnSummary + ",";
+    sqlCmd += ColumnBody + ",";
+    sqlCmd += ColumnAppName + ",";
+    sqlCmd += ColumnCTime + ",";
+    sqlCmd += ColumnAction + ",";
+    sqlCmd += ColumnHint + ",";
+    sqlCmd += ColumnReplacesId + ",";
+    sqlCmd += ColumnTimeout + " FROM ";
+    sqlCmd += TableName_v2;
+
+    // 直接从查询结果构造记录,不再经过一次JSON的序列化和解析
+    if (!m_query.exec(sqlCmd)) {
+        qWarning() << "get all from database failed: " << m_query.lastError().text();
+        return records;
+    }
+
+    while (m_query.next()) {
+        records.append(recordFromQuery(m_query));
+    }
+    m_query.finish();
+
+    return records;
+}
+
 QString Persistence::getById(const QString &id)
 {
     QString sqlCmd = QString("SELECT ");
@@ -310,11 +426,27 @@ EntityPtr Persistence::fromJsonValue(const QJsonValue &jsonValue)
                                                              actions, ConvertStringToMap(obj.value("hint").toString()),
                                                              obj.value("time").toString(),
                                                              obj.value("replacesid").toString(),
-                                                             obj.value("timeout").toString(),
-                                                             this);
+                                                             obj.value("timeout").toString());
     return notification;
 }
 
+NotificationRecord Persistence::recordFromQuery(const QSqlQuery &query)
+{
+    NotificationRecord record;
+    record.setId(query.value(0).toUInt());
+    record.setStorageId(query.value(0).toLongLong());
+    record.setAppIcon(query.value(1).toString());
+    record.setSummary(query.value(2).toString());
+    record.setBody(query.value(3).toString());
+    record.setAppName(query.value(4).toString());
+    record.setCTime(query.value(5).toLongLong());
+    record.setActions(query.value(6).toString().split(ACTION_SEGMENT));
+    record.setHints(ConvertStringToMap(query.value(7).toString()));
+    record.setReplacesId(query.value(8).toUInt());
+    record.setTimeout(query.value(9).toInt());
+    return record;
+}
+
 QString Persistence::getFrom(int rowCount, const QString &offsetId)
 {
     // gets the line number of the specified offset
@@ -405,6 +537,83 @@ int Persistence::getRecordCount()
     return count;
 }
 
+QList<NotifyGroupSummary> Persistence::getGroupSummaries()
+{
+    QList<NotifyGroupSummary> summaries;
+
+    // CTime 是以文本保存的13位毫秒时间戳,长度相同,按文本比较和按数值比较的结果一致
+    const QString sqlCmd = QString("SELECT %1, MAX(%2), COUNT(*) FROM %3 GROUP BY %1").arg(ColumnAppName, ColumnCTime, TableName_v2);
+    if (!m_query.exec(sqlCmd)) {
+        qWarning() << "get group summaries failed: " << m_query.lastError().text();
+        return summaries;
+    }
+
+    while (m_query.next()) {
+        NotifyGroupSummary summary;
+        summary.appName = m_query.value(0).toString();
+        summary.lastCTime = m_query.value(1).toLongLong();
+        summary.count = m_query.value(2).toInt();
+        summaries.append(summary);
+    }
+    m_query.finish();
+
+    return summaries;
+}
+
+QList<NotificationRecord> Persistence::getAppNotifyRecords(const QString &appName, qint64 beforeCTime, qint64 beforeId, int limit)
+{
+    QList<NotificationRecord> records;
+
+    QString sqlCmd = QString("SELECT ");
+    sqlCmd += ColumnId + ",";
+    sqlCmd += ColumnIcon + ",";
+    sqlCmd += ColumnSummary + ",";
+    sqlCmd += ColumnBody + ",";
+    sqlCmd += ColumnAppName + ",";
+    sqlCmd += ColumnCTime + ",";
+    sqlCmd += ColumnAction + ",";
+    sqlCmd += ColumnHint + ",";
+    sqlCmd += ColumnReplacesId + ",";
+    sqlCmd += ColumnTimeout + " FROM ";
+    sqlCmd += TableName_v2;
+    sqlCmd += QString(" WHERE %1 = (:app)").arg(ColumnAppName);
+    // 以上一页最后一条通知为游标,查询可以直接使用(AppName, CTime)索引,不需要跳过前面的行
+    if (beforeCTime > 0)
+        sqlCmd += QString(" AND (%1 < (:ctime) OR (%1 = (:sameCTime) AND %2 < (:id)))").arg(ColumnCTime, ColumnId);
+    sqlCmd += QString(" ORDER BY %1 DESC, %2 DESC LIMIT (:limit)").arg(ColumnCTime, ColumnId);
+
+    m_query.prepare(sqlCmd);
+    m_query.bindValue(":app", appName);
+    if (beforeCTime > 0) {
+        m_query.bindValue(":ctime", QString::number(beforeCTime));
+        m_query.bindValue(":sameCTime", QString::number(beforeCTime));
+        m_query.bindValue(":id", beforeId);
+    }
+    m_query.bindValue(":limit", limit);
+
+    if (!m_query.exec()) {
+        qWarning() << "get notifications of" << appName << "failed: " << m_query.lastError().text();
+        return records;
+    }
+
+    while (m_query.next()) {
+        records.append(recordFromQuery(m_query));
+    }
+    m_query.finish();
+
+    return records;
+}
+
+void Persistence::removeBefore(qint64 ctime)
+{
+    m_query.prepare(QString("DELETE FROM %1 WHERE %2 < (:ctime)").arg(TableName_v2, ColumnCTime));
+    m_query.bindValue(":ctime", QString::number(ctime));
+
+    if (!m_query.exec()) {
+        qWarning() << "remove notifications before" << ctime << "failed: " << m_query.lastError().text();
+    }
+}
+
 void Persistence::attemptCreateTable()
 {
     QString text = QString("CREATE TABLE IF NOT EXISTS %1("
@@ -440,6 +649,12 @@ void Persistence::attemptCreateTable()
     if (!IsAttributeValid(TableName_v2, ColumnTimeout)) {
         AddAttributeToTable(TableName_v2, ColumnTimeout);
     }
+
+    // 通知中心按应用分页加载时使用
+    text = QString("CREATE INDEX IF NOT EXISTS %1_app_ctime ON %1(%2, %3)").arg(TableName_v2, ColumnAppName, ColumnCTime);
+    if (!m_query.exec(text)) {
+        qWarning() << "create index failed" << m_query.lastError().text();
+    }
 }
 
 QString Persistence::ConvertMapToString(const QVariantMap &map)
@@ -10,6 +10,7 @@
 #include <QSqlQuery>
 
 #include "constants.h"
+#include "notificationrecord.h"
 
 #define ACTION_SEGMENT ("|")
 #define HINT_SEGMENT ("|")
@@ -17,6 +18,13 @@
 
 class NotificationEntity;
 
+// 通知中心按应用分组加载时使用的每个应用的概要信息
+struct NotifyGroupSummary {
+    QString appName;
+    qint64 lastCTime = 0;       // 此应用最新一条通知的时间
+    int count = 0;              // 此应用的通知数量
+};
+
 class AbstractPersistence : public QObject
 {
     Q_OBJECT
@@ -28,11 +36,14 @@ public:
 
     virtual void addOne(EntityPtr entity) = 0;
     virtual void addAll(QList<EntityPtr> entities) = 0;
+    // 更新已保存的通知,记录已经被删除时返回false
+    virtual bool updateOne(EntityPtr entity) { Q_UNUSED(entity) return true; }
     virtual void removeOne(const QString &id) = 0;
     virtual void removeApp(const QString &app_name) = 0;
     virtual void removeAll() = 0;
 
     virtual QList<EntityPtr> getAllNotify() = 0;
+    virtual QList<NotificationRecord> getAllNotifyRecords();
     virtual QString getAll() = 0;
     virtual QString getById(const QString &id) = 0;
     virtual EntityPtr getNotifyById(const QString &id) { return EntityPtr{}; }
@@ -40,8 +51,24 @@ public:
     virtual QString getFrom(int rowCount, const QString &offsetId) = 0;
     virtual int getRecordCount() = 0;
 
+    /*!
+     * \~chinese \name getGroupSummaries
+     * \~chinese \brief 获取每个应用的通知数量和最新时间,通知中心据此建立分组而不用读取全部通知
+     */
+    virtual QList<NotifyGroupSummary> getGroupSummaries();
+    /*!
+     * \~chinese \name getAppNotifyRecords
+     * \~chinese \brief 按时间从新到旧分页获取一个应用的通知
+     * \~chinese \param beforeCTime, beforeId: 只返回比这条通知更早的通知,beforeCTime 为0时从最新的开始
+     * \~chinese \param limit: 最多返回的条数
+     */
+    virtual QList<NotificationRecord> getAppNotifyRecords(const QString &appName, qint64 beforeCTime, qint64 beforeId, int limit);
+    // 删除早于ctime的所有通知
+    virtual void removeBefore(qint64 ctime);
+
 signals:
     void RecordAdded(EntityPtr entity);
+    void RecordUpdated(EntityPtr entity);
 };
 
 class Persistence : public AbstractPersistence
@@ -51,11 +78,13 @@ public:
 
     void addOne(EntityPtr entity) override;              //向数据库添加一条通知数据
     void addAll(QList<EntityPtr> entities) override;     //向数据库添加多条通知数据
+    bool updateOne(EntityPtr entity) override;           //更新数据库中已有通知的时间和hints
     void removeOne(const QString &id) override;          //根据通知的ID,从数据库删除一条通知.
     void removeApp(const QString &app_name) override;    //根据App名称从数据库删除App组的通知
     void removeAll() override;                           //从数据库删除所有通知
 
     QList<EntityPtr> getAllNotify() override;            //获取所有通知
+    QList<NotificationRecord> getAllNotifyRecords() override; //以紧凑的值类型获取所有通知
     QString getAll() override;                           //将所有通知转为Json格式的字符串返回
     QString getById(const QString &id) override;         //根据ID获取通知信息
     EntityPtr getNotifyById(const QString &id) override;
@@ -66,6 +95,10 @@ public:
 
     int getRecordCount() override;                       //获取通知记录有多少条
 
+    QList<NotifyGroupSummary> getGroupSummaries() override;
+    QList<NotificationRecord> getAppNotifyRecords(const QString &appName, qint64 beforeCTime, qint64 beforeId, int limit) override;
+    void removeBefore(qint64 ctime) override;
+
 private:
     void attemptCreateTable();  //在数据库中尝试创建一个表,记录通知信息
     QString ConvertMapToString(const QVariantMap &map); //将QVariantMap类型转换为QString类型
@@ -76,6 +109,7 @@ private:
     //添加一个属性到数据库表中,成功返回true,失败返回false
     bool AddAttributeToTable(const QString &tableName, const QString &attributeName);
     EntityPtr fromJsonValue(const QJsonValue &jsonValue);
+    NotificationRecord recordFromQuery(const QSqlQuery &query);
 
 private:
     QSqlDatabase m_dbConnection;
@@ -0,0 +1,124 @@
+// SPDX-FileCopyrightText: 2024 UnionTech Software Technology Co., Ltd.
+//
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+#include "settingstransaction.h"
+
+#include <QDebug>
+#include <QStringList>
+
+// gio 的头文件中有名为 signals 的成员,和 Qt 的宏冲突
+#undef signals
+#include <gio/gio.h>
+#define signals Q_SIGNALS
+
+// 按 schema 中键的类型把 QVariant 转换为 GVariant,返回浮动引用,无法转换时返回nullptr
+static GVariant *toGVariant(const GVariantType *type, const QVariant &value)
+{
+    if (g_variant_type_equal(type, G_VARIANT_TYPE_BOOLEAN))
+        return g_variant_new_boolean(value.toBool());
+    if (g_variant_type_equal(type, G_VARIANT_TYPE_STRING))
+        return g_variant_new_string(value.toString().toUtf8().constData());
+    if (g_variant_type_equal(type, G_VARIANT_TYPE_INT32))
+        return g_variant_new_int32(value.toInt());
+    if (g_variant_type_equal(type, G_VARIANT_TYPE_UINT32))
+        return g_variant_new_uint32(value.toUInt());
+    if (g_variant_type_equal(type, G_VARIANT_TYPE_INT64))
+        return g_variant_new_int64(value.toLongLong());
+    if (g_variant_type_equal(type, G_VARIANT_TYPE_DOUBLE))
+        return g_variant_new_double(value.toDouble());
+    if (g_variant_type_equal(type, G_VARIANT_TYPE_STRING_ARRAY)) {
+        GVariantBuilder builder;
+        g_variant_builder_init(&builder, G_VARIANT_TYPE_STRING_ARRAY);
+        for (const QString &item : value.toStringList())
+            g_variant_builder_add(&builder, "s", item.toUtf8().constData());
+        return g_variant_builder_end(&builder);
+    }
+    return nullptr;
+}
+
+void SettingsTransaction::set(const QByteArray &schema, const QByteArray &path, const QString &key, const QVariant &value)
+{
+    Change change;
+    change.key = key;
+    change.value = value;
+    record(qMakePair(schema, path), change);
+}
+
+void SettingsTransaction::reset(const QByteArray &schema, const QByteArray &path, const QString &key)
+{
+    Change change;
+    change.key = key;
+    change.reset = true;
+    record(qMakePair(schema, path), change);
+}
+
+int SettingsTransaction::changeCount() const
+{
+    int count = 0;
+    for (const QVector<Change> &changes : m_changes)
+        count += changes.size();
+    return count;
+}
+
+void SettingsTransaction::record(const SchemaPath &schemaPath, const Change &change)
+{
+    QVector<Change> &changes = m_changes[schemaPath];
+    for (Change &existing : changes) {
+        if (existing.key == change.key) {
+            existing = change;
+            return;
+        }
+    }
+    changes.append(change);
+}
+
+bool SettingsTransaction::commit()
+{
+    bool ok = true;
+    GSettingsSchemaSource *source = g_settings_schema_source_get_default();
+
+    for (auto it = m_changes.cbegin(); it != m_changes.cend(); ++it) {
+        const QByteArray &schemaId = it.key().first;
+        const QByteArray &path = it.key().second;
+        GSettingsSchema *schema = source != nullptr ? g_settings_schema_source_lookup(source, schemaId.constData(), TRUE) : nullptr;
+        if (schema == nullptr) {
+            qWarning() << "settings schema is not installed:" << schemaId;
+            ok = false;
+            continue;
+        }
+
+        // 延迟模式下修改只保存在 GSettings 对象中,apply 时一次写入
+        GSettings *settings = g_settings_new_full(schema, nullptr, path.isEmpty() ? nullptr : path.constData());
+        g_settings_delay(settings);
+        for (const Change &change : it.value()) {
+            const QByteArray &key = change.key.toUtf8();
+            if (!g_settings_schema_has_key(schema, key.constData())) {
+                qWarning() << "settings key does not exist:" << schemaId << change.key;
+                ok = false;
+                continue;
+            }
+
+            if (change.reset) {
+                g_settings_reset(settings, key.constData());
+                continue;
+            }
+
+            GSettingsSchemaKey *schemaKey = g_settings_schema_get_key(schema, key.constData());
+            GVariant *value = toGVariant(g_settings_schema_key_get_value_type(schemaKey), change.value);
+            g_settings_schema_key_unref(schemaKey);
+            if (value == nullptr || !g_settings_set_value(settings, key.constData(), value)) {
+                qWarning() << "failed to write settings key:" << schemaId << change.key << change.value;
+                ok = false;
+            }
+        }
+        g_settings_apply(settings);
+        g_object_unref(settings);
+        g_settings_schema_unref(schema);
+    }
+
+    if (!m_changes.isEmpty())
+        g_settings_sync();
+    m_changes.clear();
+    return ok;
+}
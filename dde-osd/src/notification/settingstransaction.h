@@ -0,0 +1,53 @@
+// SPDX-FileCopyrightText: 2024 UnionTech Software Technology Co., Ltd.
+//
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+#ifndef SETTINGSTRANSACTION_H
+#define SETTINGSTRANSACTION_H
+
+#include <QByteArray>
+#include <QMap>
+#include <QPair>
+#include <QString>
+#include <QVariant>
+#include <QVector>
+
+/*!
+ * \~chinese \class SettingsTransaction
+ * \~chinese \brief GSettings 的批量写入,修改先记录在内存中,提交时每个(schema, 路径)只延迟写入一次,
+ * \~chinese 监听者只收到一次包含所有键的变化通知.同一个键多次修改时只保留最后一次.
+ * \~chinese 没有提交的修改在析构时丢弃
+ */
+class SettingsTransaction
+{
+public:
+    SettingsTransaction() = default;
+
+    void set(const QByteArray &schema, const QByteArray &path, const QString &key, const QVariant &value);
+    void reset(const QByteArray &schema, const QByteArray &path, const QString &key);
+    bool isEmpty() const { return m_changes.isEmpty(); }
+    int schemaCount() const { return m_changes.size(); }
+    int changeCount() const;
+    void rollback() { m_changes.clear(); }
+
+    /*!
+     * \~chinese \name commit
+     * \~chinese \brief 写入所有修改并清空事务,schema 没有安装、键不存在或者值的类型无法转换时跳过并返回false
+     */
+    bool commit();
+
+private:
+    struct Change {
+        QString key;
+        QVariant value;
+        bool reset = false;
+    };
+    typedef QPair<QByteArray, QByteArray> SchemaPath;
+
+    void record(const SchemaPath &schemaPath, const Change &change);
+
+private:
+    QMap<SchemaPath, QVector<Change>> m_changes;
+};
+
+#endif // SETTINGSTRANSACTION_H
@@ -0,0 +1,109 @@
+// SPDX-FileCopyrightText: 2024 UnionTech Software Technology Co., Ltd.
+//
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+#include "textelider.h"
+
+#include <QFontMetrics>
+#include <QTextLayout>
+#include <QTextBoundaryFinder>
+
+// 缓存的省略结果数量
+static const int DefaultTextEliderCacheSize = 256;
+static const QChar Ellipsis(0x2026);
+
+uint qHash(const TextElider::Key &key, uint seed)
+{
+    return qHash(key.text, seed) ^ qHash(key.font, seed) ^ uint(key.size.width()) ^ (uint(key.size.height()) << 16);
+}
+
+// pos 之前最近的字素边界,不会把一个字符的组合拆开
+static int graphemeBefore(const QString &text, int pos)
+{
+    QTextBoundaryFinder finder(QTextBoundaryFinder::Grapheme, text);
+    finder.setPosition(pos);
+    if (finder.isAtBoundary())
+        return pos;
+
+    const int boundary = finder.toPreviousBoundary();
+    return boundary < 0 ? 0 : boundary;
+}
+
+TextElider::TextElider(QObject *parent)
+    : QObject(parent)
+    , m_cache(DefaultTextEliderCacheSize)
+{
+}
+
+QString TextElider::elide(const QString &text, const QFont &font, const QSize &size)
+{
+    const Key key {text, font, size};
+    if (QString *cached = m_cache.object(key))
+        return *cached;
+
+    const QString &result = elideText(text, font, size);
+    m_cache.insert(key, new QString(result));
+    return result;
+}
+
+QString TextElider::elideText(const QString &text, const QFont &font, const QSize &size)
+{
+    const QFontMetrics fm(font);
+    const int width = qMax(1, size.width());
+    const int maxLines = qMax(1, size.height() / fm.height());
+
+    // 每个字符至少占一个像素,超出这个长度的文字不会出现在前 maxLines + 1 行中,不需要排版
+    const int limit = (maxLines + 1) * (width + 1);
+    const QString source = text.size() > limit ? text.left(graphemeBefore(text, limit)) : text;
+
+    QTextOption option;
+    option.setWrapMode(QTextOption::WrapAtWordBoundaryOrAnywhere);
+    QTextLayout layout(source, font);
+    layout.setTextOption(option);
+    layout.beginLayout();
+    int lineCount = 0;
+    while (lineCount <= maxLines) {
+        QTextLine line = layout.createLine();
+        if (!line.isValid())
+            break;
+        line.setLineWidth(width);
+        ++lineCount;
+    }
+    layout.endLayout();
+
+    if (lineCount <= maxLines && source.size() == text.size())
+        return text;
+
+    // 截断位置在最后一行中,行内的文字宽度在排版结果中已经有了,只需要在字素边界上二分查找
+    const QTextLine line = layout.lineAt(qMin(lineCount, maxLines) - 1);
+    const int start = line.textStart();
+    const int end = start + line.textLength();
+    const qreal available = width - fm.horizontalAdvance(Ellipsis);
+
+    QVector<int> boundaries;
+    QTextBoundaryFinder finder(QTextBoundaryFinder::Grapheme, source);
+    finder.setPosition(start);
+    boundaries.append(start);
+    for (int pos = finder.toNextBoundary(); pos != -1 && pos <= end; pos = finder.toNextBoundary()) {
+        boundaries.append(pos);
+    }
+
+    const qreal startX = line.cursorToX(start);
+    int low = 0;
+    int high = boundaries.size() - 1;
+    while (low < high) {
+        const int mid = (low + high + 1) / 2;
+        if (qAbs(line.cursorToX(boundaries.at(mid)) - startX) <= available) {
+            low = mid;
+        } else {
+            high = mid - 1;
+        }
+    }
+
+    // 去掉截断处的空白和换行,省略号紧跟在文字后面
+    int cut = boundaries.at(low);
+    while (cut > start && source.at(cut - 1).isSpace())
+        --cut;
+
+    return source.left(cut) + Ellipsis;
+}
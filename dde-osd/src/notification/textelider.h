@@ -0,0 +1,56 @@
+// SPDX-FileCopyrightText: 2024 UnionTech Software Technology Co., Ltd.
+//
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+#ifndef TEXTELIDER_H
+#define TEXTELIDER_H
+
+#include <QObject>
+#include <QCache>
+#include <QFont>
+#include <QSize>
+#include <DSingleton>
+
+/*!
+ * \~chinese \class TextElider
+ * \~chinese \brief 按单词换行后放入矩形区域的文字省略,超出区域时在最后一行的末尾加上省略号.
+ * \~chinese 只排版可能显示出来的部分,在最后一行的字素边界上二分查找截断位置,耗时和正文长度无关;
+ * \~chinese 结果以(文字, 字体, 区域大小)为键缓存
+ */
+class TextElider : public QObject, public Dtk::Core::DSingleton<TextElider>
+{
+    Q_OBJECT
+    friend class Dtk::Core::DSingleton<TextElider>;
+
+public:
+    /*!
+     * \~chinese \name elide
+     * \~chinese \brief 获取可以放入 size 的文字,至少保留一行
+     */
+    QString elide(const QString &text, const QFont &font, const QSize &size);
+
+    void clear() { m_cache.clear(); }
+    int count() const { return m_cache.count(); }
+
+    static QString elideText(const QString &text, const QFont &font, const QSize &size);   // 不使用缓存
+
+private:
+    explicit TextElider(QObject *parent = nullptr);
+
+    struct Key {
+        QString text;
+        QFont font;
+        QSize size;
+
+        bool operator==(const Key &other) const
+        {
+            return size == other.size && text == other.text && font == other.font;
+        }
+    };
+    friend uint qHash(const Key &key, uint seed);
+
+private:
+    QCache<Key, QString> m_cache;
+};
+
+#endif // TEXTELIDER_H
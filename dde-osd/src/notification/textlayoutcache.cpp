@@ -0,0 +1,99 @@
+// SPDX-FileCopyrightText: 2024 UnionTech Software Technology Co., Ltd.
+//
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+#include "textlayoutcache.h"
+#include "textelider.h"
+
+#include <QFontMetrics>
+#include <QPainter>
+#include <QTextLine>
+
+// 缓存的排版数量,通知气泡和通知中心可见的文字加起来不会超过这个数量
+static const int DefaultTextLayoutCacheSize = 256;
+
+void TextLayoutData::draw(QPainter *painter, const QPointF &pos) const
+{
+    for (int i = 0; i < m_wrappedCount; ++i) {
+        m_lines->lineAt(i).draw(painter, pos);
+    }
+    if (m_elided)
+        m_elided->lineAt(0).draw(painter, pos);
+}
+
+uint qHash(const TextLayoutCache::Key &key, uint seed)
+{
+    return qHash(key.text, seed) ^ qHash(key.font, seed) ^ uint(key.width) ^ (uint(key.maxLines) << 16) ^ (uint(key.flags) << 20);
+}
+
+TextLayoutCache::TextLayoutCache(QObject *parent)
+    : QObject(parent)
+    , m_cache(DefaultTextLayoutCacheSize)
+{
+}
+
+TextLayoutPtr TextLayoutCache::layout(const QString &text, const QFont &font, int width, int maxLines,
+                                      Qt::Alignment alignment, Qt::LayoutDirection direction)
+{
+    Key key {text, font, width, qMax(0, maxLines), int(alignment) | (int(direction) << 16)};
+    if (TextLayoutPtr *cached = m_cache.object(key))
+        return *cached;
+
+    // 不限制行数的排版没有超出行数时,绘制也直接使用它
+    if (key.maxLines > 0) {
+        Key unlimited = key;
+        unlimited.maxLines = 0;
+        TextLayoutPtr *cached = m_cache.object(unlimited);
+        if (cached != nullptr && (*cached)->lineCount() <= key.maxLines)
+            return *cached;
+    }
+
+    TextLayoutPtr layout(createLayout(key));
+    m_cache.insert(key, new TextLayoutPtr(layout));
+    return layout;
+}
+
+TextLayoutData *TextLayoutCache::createLayout(const Key &key)
+{
+    TextLayoutData *data = new TextLayoutData;
+    const QFontMetrics fm(key.font);
+    data->m_lineHeight = fm.height();
+
+    QTextOption option;
+    option.setWrapMode(QTextOption::WrapAtWordBoundaryOrAnywhere);
+    option.setAlignment(Qt::Alignment(key.flags & 0xffff));
+    option.setTextDirection(Qt::LayoutDirection(key.flags >> 16));
+
+    data->m_lines.reset(new QTextLayout(key.text, key.font));
+    data->m_lines->setTextOption(option);
+    data->m_lines->beginLayout();
+    for (QTextLine line = data->m_lines->createLine(); line.isValid(); line = data->m_lines->createLine()) {
+        line.setLineWidth(key.width);
+        line.setPosition(QPointF(0, data->m_wrappedCount * data->m_lineHeight));
+        ++data->m_wrappedCount;
+    }
+    data->m_lines->endLayout();
+
+    data->m_lineCount = data->m_wrappedCount;
+    data->m_elidedText = key.text;
+    if (key.maxLines == 0 || data->m_wrappedCount <= key.maxLines)
+        return data;
+
+    // 超出行数时最后一行放入剩余的全部文字,在末尾省略
+    const int start = data->m_lines->lineAt(key.maxLines - 1).textStart();
+    const QString &lastLine = TextElider::ref().elide(key.text.mid(start), key.font, QSize(key.width - 1, data->m_lineHeight));
+    data->m_wrappedCount = key.maxLines - 1;
+    data->m_lineCount = key.maxLines;
+    data->m_elidedText = key.text.left(start) + lastLine;
+
+    option.setWrapMode(QTextOption::NoWrap);
+    data->m_elided.reset(new QTextLayout(lastLine, key.font));
+    data->m_elided->setTextOption(option);
+    data->m_elided->beginLayout();
+    QTextLine line = data->m_elided->createLine();
+    line.setLineWidth(key.width - 1);
+    line.setPosition(QPointF(0, data->m_wrappedCount * data->m_lineHeight));
+    data->m_elided->endLayout();
+
+    return data;
+}
@@ -0,0 +1,93 @@
+// SPDX-FileCopyrightText: 2024 UnionTech Software Technology Co., Ltd.
+//
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+#ifndef TEXTLAYOUTCACHE_H
+#define TEXTLAYOUTCACHE_H
+
+#include <QObject>
+#include <QCache>
+#include <QFont>
+#include <QSharedPointer>
+#include <QTextLayout>
+#include <DSingleton>
+
+class QPainter;
+
+/*!
+ * \~chinese \class TextLayoutData
+ * \~chinese \brief 一段文字按宽度和行数限制排版后的结果,行的位置相对于左上角,超出行数时最后一行是省略后的文字
+ */
+class TextLayoutData
+{
+public:
+    int lineCount() const { return m_lineCount; }
+    int lineHeight() const { return m_lineHeight; }
+    int height() const { return m_lineCount * m_lineHeight; }
+    bool isElided() const { return !m_elided.isNull(); }
+    QString elidedText() const { return m_elidedText; }      // 实际显示的文字
+
+    void draw(QPainter *painter, const QPointF &pos) const;
+
+private:
+    friend class TextLayoutCache;
+
+    QSharedPointer<QTextLayout> m_lines;    // 按宽度换行的完整排版,只显示前 m_wrappedCount 行
+    QSharedPointer<QTextLayout> m_elided;   // 省略后的最后一行,没有省略时为空
+    QString m_elidedText;
+    int m_wrappedCount = 0;
+    int m_lineCount = 0;
+    int m_lineHeight = 0;
+};
+
+typedef QSharedPointer<const TextLayoutData> TextLayoutPtr;
+
+/*!
+ * \~chinese \class TextLayoutCache
+ * \~chinese \brief 进程内共享的文字排版缓存,以(文字, 字体, 宽度, 最大行数, 对齐方式, 文字方向)为键,
+ * \~chinese 计算尺寸和绘制使用同一份排版结果,同一段文字只在宽度或者字体变化时重新排版
+ */
+class TextLayoutCache : public QObject, public Dtk::Core::DSingleton<TextLayoutCache>
+{
+    Q_OBJECT
+    friend class Dtk::Core::DSingleton<TextLayoutCache>;
+
+public:
+    /*!
+     * \~chinese \name layout
+     * \~chinese \brief 获取排版结果,按单词边界换行,单词过长时在任意位置换行
+     * \~chinese \param maxLines: 最多显示的行数,超出时最后一行在末尾省略; 0 表示不限制
+     */
+    TextLayoutPtr layout(const QString &text, const QFont &font, int width, int maxLines = 0,
+                         Qt::Alignment alignment = Qt::AlignLeft, Qt::LayoutDirection direction = Qt::LeftToRight);
+
+    void clear() { m_cache.clear(); }
+    int maxCost() const { return m_cache.maxCost(); }
+    void setMaxCost(int count) { m_cache.setMaxCost(count); }
+    int count() const { return m_cache.count(); }
+
+private:
+    explicit TextLayoutCache(QObject *parent = nullptr);
+
+    struct Key {
+        QString text;
+        QFont font;
+        int width;
+        int maxLines;
+        int flags;                          // 对齐方式和文字方向
+
+        bool operator==(const Key &other) const
+        {
+            return width == other.width && maxLines == other.maxLines && flags == other.flags
+                    && text == other.text && font == other.font;
+        }
+    };
+    friend uint qHash(const Key &key, uint seed);
+
+    static TextLayoutData *createLayout(const Key &key);
+
+private:
+    QCache<Key, TextLayoutPtr> m_cache;
+};
+
+#endif // TEXTLAYOUTCACHE_H
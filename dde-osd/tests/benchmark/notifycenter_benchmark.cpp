@@ -0,0 +1,260 @@
+// SPDX-FileCopyrightText: 2024 UnionTech Software Technology Co., Ltd.
+//
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+/*
+ * 通知中心的性能测试,不属于单元测试,需要单独构建和运行:
+ *   cmake --build build --target dde-osd-benchmark
+ *   ./dde-osd-benchmark --records 10000 --apps 200
+ * 在临时目录中生成数据库,统计通知中心的创建、首次绘制、滚动、展开折叠和插入的耗时以及内存峰值
+ */
+
+#include "notification/persistence.h"
+#include "notification/notificationentity.h"
+#include "notification-center/notifycenterwidget.h"
+#include "notification-center/notifywidget.h"
+#include "notification-center/notifylistview.h"
+#include "notification-center/notifymodel.h"
+
+#include <QApplication>
+#include <QCommandLineParser>
+#include <QElapsedTimer>
+#include <QTemporaryDir>
+#include <QTextStream>
+#include <QScrollBar>
+#include <QSqlDatabase>
+#include <QImage>
+#include <QFile>
+#include <QDateTime>
+#include <QRandomGenerator>
+
+#include <algorithm>
+
+static QTextStream out(stdout);
+
+// 一组耗时样本,单位毫秒
+class Samples
+{
+public:
+    void add(qint64 nsecs) { m_values.append(nsecs / 1000000.0); }
+    bool isEmpty() const { return m_values.isEmpty(); }
+
+    void report(const QString &name)
+    {
+        if (m_values.isEmpty())
+            return;
+
+        std::sort(m_values.begin(), m_values.end());
+        double total = 0;
+        for (double value : m_values)
+            total += value;
+        auto percentile = [this](double p) {
+            return m_values.at(qMin(m_values.size() - 1, int(m_values.size() * p)));
+        };
+
+        out << QString("%1 %2 %3 %4 %5 %6 %7\n")
+               .arg(name, -24)
+               .arg(m_values.size(), 8)
+               .arg(total / m_values.size(), 10, 'f', 3)
+               .arg(m_values.first(), 10, 'f', 3)
+               .arg(percentile(0.5), 10, 'f', 3)
+               .arg(percentile(0.95), 10, 'f', 3)
+               .arg(m_values.last(), 10, 'f', 3);
+        out.flush();
+    }
+
+private:
+    QVector<double> m_values;
+};
+
+// 进程的内存峰值(KB)
+static qint64 peakRss()
+{
+    QFile file("/proc/self/status");
+    if (!file.open(QIODevice::ReadOnly))
+        return -1;
+
+    for (const QByteArray &line : file.readAll().split('\n')) {
+        if (line.startsWith("VmHWM:"))
+            return line.mid(6).trimmed().split(' ').first().toLongLong();
+    }
+    return -1;
+}
+
+static QString bodyText(QRandomGenerator *random)
+{
+    static const QString word("notification ");
+    // 大部分是短文本,少量是很长的日志
+    const int kind = random->bounded(100);
+    if (kind < 60)
+        return word.repeated(1 + random->bounded(4));
+    if (kind < 95)
+        return word.repeated(10 + random->bounded(30));
+    return QString("log line with some content\n").repeated(200 + random->bounded(200));
+}
+
+static EntityPtr createEntity(const QString &appName, uint id, qint64 ctime, const QStringList &images, QRandomGenerator *random)
+{
+    QVariantMap hints;
+    QString icon = appName;
+    if (!images.isEmpty() && random->bounded(100) < 20) {
+        // 一部分通知使用本地图片作为图标,一部分带有图片
+        const QString &image = images.at(random->bounded(images.size()));
+        if (random->bounded(2) == 0) {
+            icon = image;
+        } else {
+            hints.insert("image-path", image);
+        }
+    }
+
+    return std::make_shared<NotificationEntity>(appName, QString::number(id), icon, QString("summary %1").arg(id),
+                                                bodyText(random), QStringList(), hints, QString::number(ctime));
+}
+
+static void processEvents()
+{
+    QApplication::processEvents(QEventLoop::AllEvents);
+}
+
+int main(int argc, char *argv[])
+{
+    if (qEnvironmentVariableIsEmpty("QT_QPA_PLATFORM"))
+        qputenv("QT_QPA_PLATFORM", "offscreen");
+
+    // 数据库放在临时目录中,不影响用户的通知记录
+    QTemporaryDir dataDir;
+    qputenv("XDG_DATA_HOME", dataDir.path().toLocal8Bit());
+
+    QApplication app(argc, argv);
+    app.setOrganizationName("deepin");
+    app.setApplicationName("dde-osd-benchmark");
+
+    QCommandLineParser parser;
+    parser.addHelpOption();
+    QCommandLineOption recordsOption("records", "Number of stored notifications.", "count", "10000");
+    QCommandLineOption appsOption("apps", "Number of applications.", "count", "200");
+    QCommandLineOption imagesOption("images", "Number of distinct image files.", "count", "20");
+    QCommandLineOption insertsOption("inserts", "Number of notifications inserted after startup.", "count", "200");
+    QCommandLineOption expandOption("expand", "Number of groups to expand and collapse.", "count", "20");
+    QCommandLineOption stepOption("scroll-step", "Pixels scrolled per frame.", "pixels", "120");
+    QCommandLineOption paintedOption("painted-rows", "Paint rows in the delegate instead of editors.");
+    parser.addOptions({recordsOption, appsOption, imagesOption, insertsOption, expandOption, stepOption, paintedOption});
+    parser.process(app);
+
+    const int records = parser.value(recordsOption).toInt();
+    const int apps = qMax(1, parser.value(appsOption).toInt());
+    const int inserts = parser.value(insertsOption).toInt();
+    const int expandCount = parser.value(expandOption).toInt();
+    const int scrollStep = qMax(1, parser.value(stepOption).toInt());
+
+    QRandomGenerator random(20240101);
+    QStringList images;
+    for (int i = 0; i < parser.value(imagesOption).toInt(); ++i) {
+        QImage image(128, 128, QImage::Format_ARGB32);
+        image.fill(QColor::fromHsv(i * 37 % 360, 200, 200));
+        const QString path = QString("%1/image-%2.png").arg(dataDir.path()).arg(i);
+        image.save(path);
+        images.append(path);
+    }
+
+    QElapsedTimer timer;
+
+    // 1.生成数据,时间分布在保留期限之内
+    Persistence database;
+    timer.start();
+    const qint64 now = QDateTime::currentMSecsSinceEpoch();
+    const qint64 span = qint64(OVERLAPTIMEOUT_7_DAY - 24 * 60 * 60) * 1000;
+    QList<EntityPtr> entities;
+    entities.reserve(records);
+    for (int i = 0; i < records; ++i) {
+        const QString appName = QString("benchmark-app-%1").arg(random.bounded(apps));
+        entities.append(createEntity(appName, uint(i + 1), now - span + span * i / qMax(1, records), images, &random));
+    }
+    QSqlDatabase connection = QSqlDatabase::database("QSQLITE");
+    connection.transaction();
+    database.addAll(entities);
+    connection.commit();
+    entities.clear();
+    const qint64 seedTime = timer.elapsed();
+
+    out << QString("records %1, apps %2, seed %3 ms\n").arg(records).arg(apps).arg(seedTime);
+    out << QString("%1 %2 %3 %4 %5 %6 %7\n").arg("stage", -24).arg("samples", 8).arg("mean", 10)
+           .arg("min", 10).arg("median", 10).arg("p95", 10).arg("max", 10);
+
+    // 2.创建通知中心
+    Samples construct;
+    timer.restart();
+    NotifyCenterWidget center(&database);
+    construct.add(timer.nsecsElapsed());
+    construct.report("construct");
+
+    NotifyWidget *notifyWidget = center.findChild<NotifyWidget *>();
+    NotifyListView *view = center.findChild<NotifyListView *>();
+    if (notifyWidget == nullptr || view == nullptr) {
+        qWarning() << "notification center widgets not found";
+        return 1;
+    }
+    NotifyModel *model = notifyWidget->model();
+    view->setPaintedRows(parser.isSet(paintedOption));
+
+    // 3.首次显示和绘制
+    Samples firstPaint;
+    timer.restart();
+    center.resize(400, 900);
+    center.show();
+    processEvents();
+    center.repaint();
+    firstPaint.add(timer.nsecsElapsed());
+    firstPaint.report("first paint");
+
+    // 4.从头滚动到底,每一帧同步绘制
+    Samples scroll;
+    QScrollBar *scrollBar = view->verticalScrollBar();
+    for (int value = 0; value <= scrollBar->maximum(); value += scrollStep) {
+        timer.restart();
+        scrollBar->setValue(value);
+        processEvents();
+        view->viewport()->repaint();
+        scroll.add(timer.nsecsElapsed());
+    }
+    scroll.report("scroll frame");
+    scrollBar->setValue(0);
+
+    // 5.依次展开和折叠前面的分组
+    Samples expand;
+    Samples collapse;
+    for (int i = 0; i < expandCount; ++i) {
+        const QString appName = QString("benchmark-app-%1").arg(i % apps);
+        timer.restart();
+        model->expandData(appName);
+        processEvents();
+        view->viewport()->repaint();
+        expand.add(timer.nsecsElapsed());
+
+        timer.restart();
+        model->collapseData();
+        processEvents();
+        view->viewport()->repaint();
+        collapse.add(timer.nsecsElapsed());
+    }
+    expand.report("expand");
+    collapse.report("collapse");
+
+    // 6.逐条插入新通知,包括模型更新和重新绘制
+    Samples insert;
+    for (int i = 0; i < inserts; ++i) {
+        const QString appName = QString("benchmark-app-%1").arg(random.bounded(apps));
+        EntityPtr entity = createEntity(appName, uint(records + i + 1), QDateTime::currentMSecsSinceEpoch(), images, &random);
+        timer.restart();
+        model->addNotify(entity);
+        processEvents();
+        view->viewport()->repaint();
+        insert.add(timer.nsecsElapsed());
+    }
+    insert.report("insert");
+
+    out << QString("rows %1, peak rss %2 KB\n").arg(model->rowCount(QModelIndex())).arg(peakRss());
+    out.flush();
+
+    return 0;
+}
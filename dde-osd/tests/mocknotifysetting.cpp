@@ -99,6 +99,29 @@ QVariant NotifySettingHelper::getAppSetting(const QString &id, const AbstractNot
     return QVariant();
 }
 
+QVariantMap NotifySettingHelper::getAppSettings(const QStringList &ids) const
+{
+    QVariantMap results;
+    foreach(auto id, ids) {
+        QVariantMap values;
+        for (int item = AbstractNotifySetting::APPNAME; item <= AbstractNotifySetting::SHOWONTOP; ++item) {
+            values[QString::number(item)] = getAppSetting(id, static_cast<AbstractNotifySetting::AppConfigurationItem>(item));
+        }
+        results[id] = values;
+    }
+    return results;
+}
+
+void NotifySettingHelper::setAppSettings(const QVariantMap &settings)
+{
+    for (auto it = settings.cbegin(); it != settings.cend(); ++it) {
+        const QVariantMap &values = it.value().toMap();
+        for (auto valueIt = values.cbegin(); valueIt != values.cend(); ++valueIt) {
+            setAppSetting(it.key(), static_cast<AbstractNotifySetting::AppConfigurationItem>(valueIt.key().toInt()), valueIt.value());
+        }
+    }
+}
+
 void NotifySettingHelper::setSystemSetting(const AbstractNotifySetting::SystemConfigurationItem &item, const QVariant &var)
 {
     switch (item) {
@@ -16,6 +16,8 @@ public:
     MOCK_METHOD0(initAllSettings, void());
     MOCK_METHOD3(setAppSetting, void(const QString &, const AppConfigurationItem &, const QVariant &));
     MOCK_METHOD2(getAppSetting,  QVariant(const QString &, const AppConfigurationItem &));
+    MOCK_METHOD1(getAppSettings, QVariantMap(const QStringList &));
+    MOCK_METHOD1(setAppSettings, void(const QVariantMap &));
     MOCK_METHOD2(setSystemSetting,  void(const SystemConfigurationItem &, const QVariant &));
     MOCK_METHOD1(getSystemSetting,  QVariant(const SystemConfigurationItem &));
     MOCK_METHOD0(getAppLists, QStringList());
@@ -40,6 +42,8 @@ public:
                        const QVariant &var);
     QVariant getAppSetting(const QString &id,
                            const AbstractNotifySetting::AppConfigurationItem &item) const;
+    QVariantMap getAppSettings(const QStringList &ids) const;
+    void setAppSettings(const QVariantMap &settings);
     void setSystemSetting(const AbstractNotifySetting::SystemConfigurationItem &item,
                           const QVariant &var);
     QVariant getSystemSetting(const AbstractNotifySetting::SystemConfigurationItem &item) const;
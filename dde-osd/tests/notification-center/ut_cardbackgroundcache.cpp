@@ -0,0 +1,57 @@
+// SPDX-FileCopyrightText: 2024 UnionTech Software Technology Co., Ltd.
+//
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+#include "notification-center/cardbackgroundcache.h"
+
+#include <QImage>
+#include <QPainter>
+
+#include <gtest/gtest.h>
+
+class UT_CardBackgroundCache : public testing::Test
+{
+public:
+    void SetUp() override
+    {
+        obj = &CardBackgroundCache::ref();
+        obj->clear();
+    }
+
+    void TearDown() override
+    {
+        obj->clear();
+        obj = nullptr;
+    }
+
+public:
+    CardBackgroundCache *obj = nullptr;
+};
+
+TEST_F(UT_CardBackgroundCache, tileTest)
+{
+    const QColor color(255, 255, 255, 60);
+    const QPixmap &first = obj->tile(8, 8, color, 1.0);
+    EXPECT_EQ(first.size(), QSize(17, 17));
+    EXPECT_EQ(obj->tile(8, 8, color, 1.0).cacheKey(), first.cacheKey());
+    EXPECT_EQ(obj->count(), 1);
+
+    // 缩放比和圆角不同时分别缓存
+    EXPECT_EQ(obj->tile(8, 8, color, 2.0).size(), QSize(34, 34));
+    EXPECT_EQ(obj->tile(0, 6, color, 1.0).size(), QSize(13, 7));
+    EXPECT_EQ(obj->count(), 3);
+}
+
+TEST_F(UT_CardBackgroundCache, drawTest)
+{
+    QImage image(100, 60, QImage::Format_ARGB32_Premultiplied);
+    image.fill(Qt::transparent);
+    QPainter painter(&image);
+    obj->draw(&painter, image.rect(), 8, 8, QColor(255, 0, 0), 1.0);
+    painter.end();
+
+    // 中间填满,圆角外透明
+    EXPECT_EQ(image.pixelColor(50, 30), QColor(255, 0, 0));
+    EXPECT_EQ(image.pixelColor(0, 0).alpha(), 0);
+    EXPECT_EQ(image.pixelColor(99, 59).alpha(), 0);
+}
@@ -0,0 +1,100 @@
+// SPDX-FileCopyrightText: 2024 UnionTech Software Technology Co., Ltd.
+//
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+#define private public
+#define protected public
+#include "notification-center/expiryscheduler.h"
+#undef private
+#undef protected
+
+#include <QDateTime>
+#include <QTimer>
+#include <QSignalSpy>
+
+#include <gtest/gtest.h>
+
+class UT_ExpiryScheduler : public testing::Test
+{
+public:
+    void SetUp() override
+    {
+        obj = new ExpiryScheduler(1000);
+    }
+
+    void TearDown() override
+    {
+        delete obj;
+        obj = nullptr;
+    }
+
+public:
+    ExpiryScheduler *obj = nullptr;
+};
+
+TEST_F(UT_ExpiryScheduler, addTest)
+{
+    EXPECT_EQ(obj->nextExpiry(), -1);
+    EXPECT_FALSE(obj->m_timer->isActive());
+
+    const qint64 now = QDateTime::currentMSecsSinceEpoch();
+    obj->add(1, now + 5000);
+    obj->add(2, now);
+    EXPECT_EQ(obj->count(), 2);
+    EXPECT_EQ(obj->nextExpiry(), now + 1000);
+    EXPECT_TRUE(obj->m_timer->isActive());
+
+    // 更新后以新的到期时间为准
+    obj->add(2, now + 10000);
+    EXPECT_EQ(obj->count(), 2);
+    EXPECT_EQ(obj->nextExpiry(), now + 6000);
+}
+
+TEST_F(UT_ExpiryScheduler, removeTest)
+{
+    obj->add(1, 100);
+    obj->add(2, 200);
+    obj->remove(1);
+    EXPECT_FALSE(obj->contains(1));
+    EXPECT_EQ(obj->nextExpiry(), 1200);
+
+    obj->remove(2);
+    EXPECT_EQ(obj->nextExpiry(), -1);
+    EXPECT_FALSE(obj->m_timer->isActive());
+
+    // 大量删除后堆的大小跟随有效的条目
+    for (uint id = 1; id <= 100; ++id)
+        obj->add(id, id);
+    for (uint id = 1; id <= 90; ++id)
+        obj->remove(id);
+    EXPECT_EQ(obj->count(), 10);
+    EXPECT_LE(obj->m_heap.size(), 2 * obj->count() + 16);
+    EXPECT_EQ(obj->nextExpiry(), 1091);
+
+    obj->clear();
+    EXPECT_EQ(obj->count(), 0);
+}
+
+TEST_F(UT_ExpiryScheduler, takeExpiredTest)
+{
+    obj->add(3, 300);
+    obj->add(1, 100);
+    obj->add(2, 200);
+    obj->remove(2);
+
+    EXPECT_TRUE(obj->takeExpired(1000).isEmpty());
+    EXPECT_EQ(obj->takeExpired(1300), QList<uint>() << 1 << 3);
+    EXPECT_EQ(obj->count(), 0);
+}
+
+TEST_F(UT_ExpiryScheduler, timeoutTest)
+{
+    QSignalSpy spy(obj, &ExpiryScheduler::expired);
+    obj->add(1, QDateTime::currentMSecsSinceEpoch() - 2000);
+    EXPECT_EQ(obj->m_timer->interval(), 0);
+
+    obj->onTimeout();
+    ASSERT_EQ(spy.count(), 1);
+    EXPECT_EQ(spy.first().first().value<QList<uint>>(), QList<uint>() << 1);
+    EXPECT_FALSE(obj->m_timer->isActive());
+}
@@ -131,7 +131,7 @@ TEST_F(UT_NotifyListview, coverageTest)
     ListItem listItem;
     listItem.appName = entity->appName();
     listItem.showList = QList<EntityPtr>({entity});
-    listItem.hideList = QList<EntityPtr>({entity});
+    listItem.hideList = QList<NotificationRecord>({entity->record()});
     auto option = QStyleOptionViewItem();
     option.rect = QRect(0,0,10,10);
     for (int row = 0; row < model->rowCount(QModelIndex()); row++) {
@@ -150,3 +150,83 @@ TEST_F(UT_NotifyListview, coverageTest)
     model->removeAllData();
 }
 
+
+TEST_F(UT_NotifyListview, paintedRowsTest)
+{
+    obj->setPaintedRows(true);
+    EXPECT_TRUE(obj->paintedRows());
+    for (int i = 0; i < 5; ++i) {
+        model->addNotify(std::make_shared<NotificationEntity>(QString("app-%1").arg(i)));
+    }
+
+    // 绘制模式下 flags 不再为每一行打开编辑控件
+    int editorCount = 0;
+    for (int row = 0; row < model->rowCount(QModelIndex()); row++) {
+        model->flags(model->index(row));
+        if (obj->indexWidget(model->index(row)) != nullptr)
+            editorCount++;
+    }
+    EXPECT_EQ(editorCount, 0);
+
+    // 只有焦点行和悬停行有编辑控件
+    obj->setCurrentRow(1);
+    EXPECT_NE(obj->indexWidget(model->index(1)), nullptr);
+    obj->setHoverIndex(model->index(3));
+    EXPECT_NE(obj->indexWidget(model->index(3)), nullptr);
+    obj->setCurrentRow(5);
+    EXPECT_EQ(obj->indexWidget(model->index(1)), nullptr);
+    EXPECT_NE(obj->indexWidget(model->index(3)), nullptr);
+    EXPECT_NE(obj->indexWidget(model->index(5)), nullptr);
+
+    obj->resize(BubbleItemWidth, 600);
+    obj->grab();
+
+    obj->setPaintedRows(false);
+    for (int row = 0; row < model->rowCount(QModelIndex()); row++) {
+        EXPECT_NE(obj->indexWidget(model->index(row)), nullptr);
+    }
+}
+
+TEST_F(UT_NotifyListview, layoutCacheTest)
+{
+    EntityPtr notify = std::make_shared<NotificationEntity>("deepin-editor");
+    const NotificationEntity *key = notify.get();
+    delegate->rowLayout(notify);
+    EXPECT_EQ(delegate->layoutCacheCount(), 1);
+
+    // 模型删除通知后缓存项仍然持有它,作为键的地址不会被新的通知复用
+    std::weak_ptr<NotificationEntity> weak = notify;
+    notify.reset();
+    EXPECT_FALSE(weak.expired());
+    EXPECT_EQ(delegate->m_layouts.object(key)->entity.get(), key);
+
+    delegate->clearLayouts();
+    EXPECT_TRUE(weak.expired());
+}
+
+TEST_F(UT_NotifyListview, inputFilterTest)
+{
+    // 通知中心以外的窗口收到的按键不经过列表的过滤
+    class KeyWidget : public QWidget
+    {
+    public:
+        int count = 0;
+    protected:
+        void keyPressEvent(QKeyEvent *) override { count++; }
+    };
+
+    KeyWidget other;
+    QWidget *child = new QWidget(obj->viewport());
+    obj->show();
+    QTest::keyPress(&other, Qt::Key_Down);
+    EXPECT_EQ(other.count, 1);
+
+    // 焦点控件在列表所在的窗口中时才安装过滤器
+    obj->onFocusChanged(nullptr, &other);
+    EXPECT_TRUE(obj->m_focusFilterWidget.isNull());
+    obj->onFocusChanged(nullptr, child);
+    EXPECT_EQ(obj->m_focusFilterWidget, child);
+
+    obj->hide();
+    EXPECT_TRUE(obj->m_focusFilterWidget.isNull());
+}
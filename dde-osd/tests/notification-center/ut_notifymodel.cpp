@@ -0,0 +1,297 @@
+// SPDX-FileCopyrightText: 2024 UnionTech Software Technology Co., Ltd.
+//
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+#define private public
+#include "notifymodel.h"
+#include "notification/notificationentity.h"
+#include "notification/persistence.h"
+#undef private
+
+#include <QAbstractItemModelTester>
+#include <QDateTime>
+#include <QSignalSpy>
+
+#include <gtest/gtest.h>
+
+// 只实现分页加载用到的接口的内存数据库
+class PagedPersistence : public AbstractPersistence
+{
+public:
+    void addOne(EntityPtr entity) override { m_records.append(entity->record()); }
+    void addAll(QList<EntityPtr> entities) override { for (EntityPtr entity : entities) addOne(entity); }
+    void removeOne(const QString &id) override
+    {
+        for (int i = 0; i < m_records.size(); ++i) {
+            if (QString::number(m_records.at(i).id()) == id) {
+                m_records.removeAt(i);
+                return;
+            }
+        }
+    }
+    void removeApp(const QString &) override {}
+    void removeAll() override { m_records.clear(); }
+    QList<EntityPtr> getAllNotify() override { return QList<EntityPtr>(); }
+    QList<NotificationRecord> getAllNotifyRecords() override { return m_records; }
+    QString getAll() override { return QString(); }
+    QString getById(const QString &) override { return QString(); }
+    QString getFrom(int, const QString &) override { return QString(); }
+    int getRecordCount() override { return m_records.size(); }
+
+    QList<NotificationRecord> m_records;
+};
+
+class UT_NotifyModel : public testing::Test
+{
+public:
+    void SetUp() override
+    {
+        obj = new NotifyModel(nullptr, nullptr, nullptr);
+        tester = new QAbstractItemModelTester(obj, QAbstractItemModelTester::FailureReportingMode::Warning);
+    }
+
+    void TearDown() override
+    {
+        delete tester;
+        tester = nullptr;
+        delete obj;
+        obj = nullptr;
+    }
+
+    EntityPtr createEntity(const QString &appName)
+    {
+        // 保证后创建的通知时间更新
+        ++id;
+        return std::make_shared<NotificationEntity>(appName, QString::number(id), appName, "summary", "body",
+                                                    QStringList(), QVariantMap(),
+                                                    QString::number(startTime + id));
+    }
+
+public:
+    NotifyModel *obj = nullptr;
+    QAbstractItemModelTester *tester = nullptr;
+    uint id = 0;
+    qint64 startTime = QDateTime::currentMSecsSinceEpoch() - 60 * 1000;
+};
+
+TEST_F(UT_NotifyModel, incrementalTest)
+{
+    QSignalSpy resetSpy(obj, &QAbstractItemModel::modelReset);
+    QSignalSpy insertSpy(obj, &QAbstractItemModel::rowsInserted);
+    QSignalSpy removeSpy(obj, &QAbstractItemModel::rowsRemoved);
+    QSignalSpy moveSpy(obj, &QAbstractItemModel::rowsMoved);
+
+    EntityPtr editor = createEntity("deepin-editor");
+    obj->addNotify(editor);
+    EXPECT_EQ(obj->rowCount(QModelIndex()), 2);
+    EXPECT_EQ(insertSpy.count(), 1);
+
+    obj->addNotify(createEntity("dde-control-center"));
+    EXPECT_EQ(obj->rowCount(QModelIndex()), 4);
+
+    // 已有分组收到新通知时整组移动到最前面,只插入新的一行
+    insertSpy.clear();
+    obj->addNotify(createEntity("deepin-editor"));
+    EXPECT_EQ(obj->rowCount(QModelIndex()), 5);
+    EXPECT_EQ(moveSpy.count(), 1);
+    EXPECT_EQ(insertSpy.count(), 1);
+    EXPECT_TRUE(obj->data(obj->index(0), Qt::DisplayRole).value<EntityPtr>()->isTitle());
+    EXPECT_EQ(obj->data(obj->index(0), Qt::DisplayRole).value<EntityPtr>()->appName(), "deepin-editor");
+    EXPECT_EQ(obj->data(obj->index(2), Qt::DisplayRole).value<EntityPtr>(), editor);
+    EXPECT_EQ(editor->currentIndex(), 2);
+
+    obj->removeNotify(editor);
+    EXPECT_EQ(obj->rowCount(QModelIndex()), 4);
+    EXPECT_EQ(removeSpy.count(), 1);
+
+    EXPECT_EQ(resetSpy.count(), 0);
+}
+
+TEST_F(UT_NotifyModel, collapseTest)
+{
+    for (int i = 0; i < 5; ++i)
+        obj->addNotify(createEntity("deepin-editor"));
+
+    // 显示列表最多三条,其余层叠在最后一条下面
+    EXPECT_EQ(obj->rowCount(QModelIndex()), 4);
+    EXPECT_EQ(obj->data(obj->index(3), Qt::DisplayRole).value<EntityPtr>()->hideCount(), 2);
+
+    obj->expandData("deepin-editor");
+    EXPECT_EQ(obj->rowCount(QModelIndex()), 6);
+    EXPECT_EQ(obj->data(obj->index(3), Qt::DisplayRole).value<EntityPtr>()->hideCount(), 0);
+
+    obj->collapseData();
+    EXPECT_EQ(obj->rowCount(QModelIndex()), 4);
+}
+
+TEST_F(UT_NotifyModel, rowIndexTest)
+{
+    obj->addNotify(createEntity("deepin-editor"));
+    obj->addNotify(createEntity("dde-control-center"));
+
+    // 标题行数据是缓存的,多次获取得到同一个对象
+    const QModelIndex &titleIndex = obj->index(2);
+    EntityPtr title = obj->data(titleIndex, Qt::DisplayRole).value<EntityPtr>();
+    EXPECT_TRUE(title->isTitle());
+    EXPECT_EQ(title, obj->data(titleIndex, Qt::DisplayRole).value<EntityPtr>());
+    EXPECT_EQ(title->currentIndex(), 2);
+
+    // 行号随着分组移动更新
+    obj->addNotify(createEntity("deepin-editor"));
+    EXPECT_EQ(title->currentIndex(), 0);
+    EXPECT_EQ(obj->data(obj->index(0), Qt::DisplayRole).value<EntityPtr>(), title);
+    EXPECT_EQ(title->ctime(), obj->data(obj->index(1), Qt::DisplayRole).value<EntityPtr>()->ctime());
+}
+
+TEST_F(UT_NotifyModel, expiryTest)
+{
+    obj->addNotify(createEntity("deepin-editor"));
+    obj->addNotify(createEntity("dde-control-center"));
+    EXPECT_EQ(obj->rowCount(QModelIndex()), 4);
+
+    // 超过保留期限的通知到期后整组移除
+    startTime -= qint64(OVERLAPTIMEOUT_7_DAY) * 1000;
+    obj->addNotify(createEntity("deepin-music"));
+    EXPECT_EQ(obj->rowCount(QModelIndex()), 6);
+
+    obj->removeTimeOutNotify();
+    EXPECT_EQ(obj->rowCount(QModelIndex()), 4);
+    EXPECT_NE(obj->data(obj->index(2), Qt::DisplayRole).value<EntityPtr>()->appName(), "deepin-music");
+
+    // 未到期的通知不受影响
+    obj->removeTimeOutNotify();
+    EXPECT_EQ(obj->rowCount(QModelIndex()), 4);
+}
+
+TEST_F(UT_NotifyModel, groupOrderTest)
+{
+    for (int i = 0; i < 50; ++i)
+        obj->addNotify(createEntity(QString("app-%1").arg(i)));
+
+    // 分组按最后活动时间从新到旧排列
+    EXPECT_EQ(obj->m_notifications.size(), 50);
+    EXPECT_EQ(obj->m_groupOrders.size(), 50);
+    EXPECT_EQ(obj->m_notifications.first().appName, "app-49");
+    EXPECT_EQ(obj->m_notifications.last().appName, "app-0");
+
+    // 已有分组收到新通知时移动到最前面,其余分组顺序不变
+    obj->addNotify(createEntity("app-10"));
+    EXPECT_EQ(obj->m_notifications.first().appName, "app-10");
+    EXPECT_EQ((++obj->m_notifications.begin()).value().appName, "app-49");
+    EXPECT_EQ(obj->getAppData("app-10").showList.size(), 2);
+
+    // 分组的最后一条通知删除后分组和索引一起移除
+    obj->removeNotify(obj->getAppData("app-0").showList.first());
+    EXPECT_EQ(obj->m_notifications.size(), 50 - 1);
+    EXPECT_FALSE(obj->m_groupOrders.contains("app-0"));
+    EXPECT_EQ(obj->m_notifications.last().appName, "app-1");
+    EXPECT_EQ(obj->m_notifications.first().appName, "app-49");
+}
+
+TEST_F(UT_NotifyModel, groupRowsTest)
+{
+    obj->addNotify(createEntity("deepin-music"));
+    for (int i = 0; i < 5; ++i)
+        obj->addNotify(createEntity("deepin-editor"));
+    obj->addNotify(createEntity("dde-control-center"));
+
+    // 每组的起始行和行数随行的变化更新,包含标题行
+    EXPECT_EQ(obj->m_groupRows.value("dde-control-center"), qMakePair(0, 2));
+    EXPECT_EQ(obj->m_groupRows.value("deepin-editor"), qMakePair(2, 4));
+    EXPECT_EQ(obj->m_groupRows.value("deepin-music"), qMakePair(6, 2));
+
+    obj->expandData("deepin-editor");
+    EXPECT_EQ(obj->m_groupRows.value("deepin-editor"), qMakePair(2, 6));
+    EXPECT_EQ(obj->m_groupRows.value("deepin-music"), qMakePair(8, 2));
+
+    // 分组的行与可见的行范围相交时可见
+    EXPECT_TRUE(obj->groupVisible("deepin-editor", 0, 2));
+    EXPECT_TRUE(obj->groupVisible("deepin-editor", 7, 9));
+    EXPECT_FALSE(obj->groupVisible("deepin-editor", 0, 1));
+    EXPECT_FALSE(obj->groupVisible("deepin-editor", 8, 9));
+    EXPECT_FALSE(obj->groupVisible("deepin-music", 0, -1));
+    EXPECT_FALSE(obj->groupVisible("unknown", 0, 9));
+
+    // 没有视图时没有可见的行
+    int firstRow = 0, lastRow = 0;
+    EXPECT_FALSE(obj->visibleRows(firstRow, lastRow));
+
+    obj->removeNotify(obj->getAppData("deepin-music").showList.first());
+    EXPECT_FALSE(obj->m_groupRows.contains("deepin-music"));
+    EXPECT_EQ(obj->m_groupRows.value("deepin-editor"), qMakePair(2, 6));
+}
+
+TEST(UT_NotifyModelPaged, fetchMoreTest)
+{
+    PagedPersistence database;
+    const qint64 now = QDateTime::currentMSecsSinceEpoch();
+    const int total = NOTIFY_PAGE_SIZE * 2 + 20;
+    for (int i = 0; i < total; ++i) {
+        NotificationRecord record;
+        record.setId(uint(i + 1));
+        record.setAppName("deepin-editor");
+        record.setCTime(now - (total - i) * 1000);
+        database.m_records.append(record);
+    }
+
+    NotifyModel model(nullptr, &database, nullptr);
+    EXPECT_EQ(model.getAppData("deepin-editor").storedCount, total);
+    EXPECT_EQ(model.getAppData("deepin-editor").showList.size() + model.getAppData("deepin-editor").hideList.size(), NOTIFY_PAGE_SIZE);
+    EXPECT_FALSE(model.canFetchMore(QModelIndex()));
+
+    // 展开后显示第一页,并预先加载下一页作为层叠
+    model.expandData("deepin-editor");
+    EXPECT_EQ(model.rowCount(QModelIndex()), 1 + NOTIFY_PAGE_SIZE);
+    EXPECT_EQ(model.getAppData("deepin-editor").hideList.size(), NOTIFY_PAGE_SIZE);
+    EXPECT_TRUE(model.canFetchMore(QModelIndex()));
+
+    model.fetchMore(QModelIndex());
+    EXPECT_EQ(model.rowCount(QModelIndex()), 1 + NOTIFY_PAGE_SIZE * 2);
+    EXPECT_EQ(model.getAppData("deepin-editor").hideList.size(), 20);
+
+    model.fetchMore(QModelIndex());
+    EXPECT_EQ(model.rowCount(QModelIndex()), 1 + total);
+    EXPECT_FALSE(model.canFetchMore(QModelIndex()));
+
+    // 通知按时间从新到旧排列,没有重复
+    EntityPtr last = model.data(model.index(model.rowCount(QModelIndex()) - 1), Qt::DisplayRole).value<EntityPtr>();
+    EXPECT_EQ(last->id(), 1u);
+
+    // 折叠后只保留一页
+    model.collapseData();
+    EXPECT_LE(model.getAppData("deepin-editor").hideList.size(), NOTIFY_PAGE_SIZE);
+}
+
+TEST_F(UT_NotifyModel, updateTest)
+{
+    QSignalSpy insertSpy(obj, &QAbstractItemModel::rowsInserted);
+    QSignalSpy removeSpy(obj, &QAbstractItemModel::rowsRemoved);
+
+    EntityPtr first = createEntity("deepin-editor");
+    EntityPtr second = createEntity("deepin-editor");
+    obj->addNotify(first);
+    obj->addNotify(second);
+    EXPECT_EQ(obj->data(obj->index(2), Qt::DisplayRole).value<EntityPtr>(), first);
+
+    // 合并重复通知后,原来那一行换成新的行显示在分组最前面
+    EntityPtr merged = std::make_shared<NotificationEntity>(*first);
+    merged->setStorageId(QString::number(first->id()));
+    merged->setRepeatCount(3);
+    merged->setTime(QString::number(startTime + 100));
+    insertSpy.clear();
+    obj->updateNotify(merged);
+
+    EXPECT_EQ(obj->rowCount(QModelIndex()), 3);
+    EXPECT_EQ(removeSpy.count(), 1);
+    EXPECT_EQ(insertSpy.count(), 1);
+    EntityPtr top = obj->data(obj->index(1), Qt::DisplayRole).value<EntityPtr>();
+    EXPECT_EQ(top->id(), first->id());
+    EXPECT_EQ(top->repeatCount(), 3);
+    EXPECT_EQ(top->ctime(), QString::number(startTime + 100));
+    EXPECT_EQ(obj->data(obj->index(2), Qt::DisplayRole).value<EntityPtr>(), second);
+
+    // 已经删除的通知不再更新
+    obj->removeNotify(top);
+    obj->updateNotify(merged);
+    EXPECT_EQ(obj->rowCount(QModelIndex()), 2);
+}
@@ -0,0 +1,105 @@
+// SPDX-FileCopyrightText: 2024 UnionTech Software Technology Co., Ltd.
+//
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+#define private public
+#define protected public
+#include "notification-center/relativetimescheduler.h"
+#undef private
+#undef protected
+
+#include <QDateTime>
+#include <QTimer>
+
+#include <gtest/gtest.h>
+
+class UT_RelativeTimeScheduler : public testing::Test
+{
+public:
+    void SetUp() override
+    {
+        obj = &RelativeTimeScheduler::ref();
+        context = new QObject;
+    }
+
+    void TearDown() override
+    {
+        delete context;
+        context = nullptr;
+        obj->setSuspended(false);
+    }
+
+public:
+    RelativeTimeScheduler *obj = nullptr;
+    QObject *context = nullptr;
+};
+
+TEST_F(UT_RelativeTimeScheduler, nextTransitionTest)
+{
+    const qint64 minute = 60 * 1000;
+    const QDateTime noon(QDate(2024, 5, 10), QTime(12, 0));
+    const qint64 ctime = noon.toMSecsSinceEpoch();
+
+    // 未来的时间在到达时开始显示
+    EXPECT_EQ(RelativeTimeScheduler::nextTransition(ctime, ctime - minute), ctime);
+    // 一小时内按分钟变化
+    EXPECT_EQ(RelativeTimeScheduler::nextTransition(ctime, ctime + 30 * 1000), ctime + minute);
+    EXPECT_EQ(RelativeTimeScheduler::nextTransition(ctime, ctime + 5 * minute), ctime + 6 * minute);
+    // 超过一小时按小时变化,不会晚于当天结束
+    EXPECT_EQ(RelativeTimeScheduler::nextTransition(ctime, ctime + 90 * minute), ctime + 120 * minute);
+    EXPECT_EQ(RelativeTimeScheduler::nextTransition(ctime, ctime + 11 * 60 * minute + minute),
+              QDateTime(QDate(2024, 5, 11), QTime(0, 0)).toMSecsSinceEpoch());
+    // 昨天和一周内按天变化
+    EXPECT_EQ(RelativeTimeScheduler::nextTransition(ctime, QDateTime(QDate(2024, 5, 11), QTime(8, 0)).toMSecsSinceEpoch()),
+              QDateTime(QDate(2024, 5, 12), QTime(0, 0)).toMSecsSinceEpoch());
+    EXPECT_EQ(RelativeTimeScheduler::nextTransition(ctime, QDateTime(QDate(2024, 5, 13), QTime(8, 0)).toMSecsSinceEpoch()),
+              QDateTime(QDate(2024, 5, 17), QTime(0, 0)).toMSecsSinceEpoch());
+    // 超过一周只显示日期,不再变化
+    EXPECT_EQ(RelativeTimeScheduler::nextTransition(ctime, QDateTime(QDate(2024, 5, 20), QTime(8, 0)).toMSecsSinceEpoch()), -1);
+}
+
+TEST_F(UT_RelativeTimeScheduler, addTest)
+{
+    const int count = obj->count();
+    const qint64 now = QDateTime::currentMSecsSinceEpoch();
+
+    EXPECT_EQ(obj->add(now - 30LL * 24 * 60 * 60 * 1000, context, [] {}), quint64(0));
+    EXPECT_EQ(obj->count(), count);
+
+    const quint64 handle = obj->add(now, context, [] {});
+    EXPECT_NE(handle, quint64(0));
+    EXPECT_EQ(obj->count(), count + 1);
+    EXPECT_TRUE(obj->isActive());
+    EXPECT_LE(obj->m_timer->interval(), 60 * 1000);
+
+    obj->remove(handle);
+    EXPECT_EQ(obj->count(), count);
+}
+
+TEST_F(UT_RelativeTimeScheduler, contextTest)
+{
+    const int count = obj->count();
+    const qint64 now = QDateTime::currentMSecsSinceEpoch();
+
+    obj->add(now, context, [] {});
+    obj->add(now - 60 * 1000, context, [] {});
+    EXPECT_EQ(obj->count(), count + 2);
+
+    delete context;
+    context = nullptr;
+    EXPECT_EQ(obj->count(), count);
+}
+
+TEST_F(UT_RelativeTimeScheduler, suspendTest)
+{
+    const quint64 handle = obj->add(QDateTime::currentMSecsSinceEpoch(), context, [] {});
+    EXPECT_TRUE(obj->isActive());
+
+    // 隐藏期间不唤醒,恢复后重新按最早的变化时间启动
+    obj->setSuspended(true);
+    EXPECT_FALSE(obj->isActive());
+    obj->setSuspended(false);
+    EXPECT_TRUE(obj->isActive());
+
+    obj->remove(handle);
+}
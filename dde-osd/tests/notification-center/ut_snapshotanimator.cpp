@@ -0,0 +1,78 @@
+// SPDX-FileCopyrightText: 2024 UnionTech Software Technology Co., Ltd.
+//
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+#include "notification-center/snapshotanimator.h"
+
+#include <QLabel>
+#include <QTest>
+
+#include <gtest/gtest.h>
+
+class UT_SnapshotAnimator : public testing::Test
+{
+public:
+    void SetUp() override
+    {
+        parent = new QWidget;
+        parent->resize(200, 200);
+        widget = new QLabel("unittest", parent);
+        widget->setGeometry(10, 20, 100, 40);
+        obj = new SnapshotAnimator(parent);
+        parent->show();
+    }
+
+    void TearDown() override
+    {
+        delete parent;
+        parent = nullptr;
+    }
+
+public:
+    QWidget *parent = nullptr;
+    QLabel *widget = nullptr;
+    SnapshotAnimator *obj = nullptr;
+};
+
+TEST_F(UT_SnapshotAnimator, finishTest)
+{
+    EXPECT_EQ(obj->widgetRect(widget), QRect(10, 20, 100, 40));
+
+    // 动画期间真实的控件隐藏,结束后恢复并调用回调
+    bool finished = false;
+    obj->addWidget(widget, QRect(10, 80, 100, 40), 1000);
+    EXPECT_EQ(obj->spriteCount(), 1);
+    EXPECT_FALSE(widget->isVisible());
+
+    obj->start([ &finished ] { finished = true; });
+    EXPECT_TRUE(obj->isRunning());
+    EXPECT_TRUE(obj->isVisible());
+    obj->repaint();
+
+    obj->finish();
+    EXPECT_TRUE(finished);
+    EXPECT_FALSE(obj->isRunning());
+    EXPECT_TRUE(widget->isVisible());
+    EXPECT_EQ(obj->spriteCount(), 0);
+}
+
+TEST_F(UT_SnapshotAnimator, timeoutTest)
+{
+    bool finished = false;
+    QLabel label("snapshot");
+    const QPixmap &pixmap = SnapshotAnimator::snapshot(&label, QSize(100, 40));
+    EXPECT_FALSE(pixmap.isNull());
+
+    obj->addPixmap(pixmap, QRect(0, 0, 100, 0), QRect(0, 0, 100, 40), 50, 20);
+    obj->start([ &finished ] { finished = true; });
+    EXPECT_TRUE(QTest::qWaitFor([ &finished ] { return finished; }, 1000));
+}
+
+TEST_F(UT_SnapshotAnimator, emptyTest)
+{
+    // 没有截图时立即结束
+    bool finished = false;
+    obj->start([ &finished ] { finished = true; });
+    EXPECT_TRUE(finished);
+    EXPECT_FALSE(obj->isRunning());
+}
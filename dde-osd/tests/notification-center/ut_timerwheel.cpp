@@ -0,0 +1,86 @@
+// SPDX-FileCopyrightText: 2024 UnionTech Software Technology Co., Ltd.
+//
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+#include "notification-center/timerwheel.h"
+
+#include <gtest/gtest.h>
+
+#include <algorithm>
+
+class UT_TimerWheel : public testing::Test
+{
+public:
+    void SetUp() override
+    {
+        obj = new TimerWheel(0);
+    }
+
+    void TearDown() override
+    {
+        delete obj;
+        obj = nullptr;
+    }
+
+public:
+    TimerWheel *obj = nullptr;
+};
+
+TEST_F(UT_TimerWheel, addTest)
+{
+    EXPECT_TRUE(obj->isEmpty());
+    EXPECT_EQ(obj->nextWakeup(), -1);
+
+    obj->add(1, 5500);
+    obj->add(2, 3000);
+    EXPECT_EQ(obj->count(), 2);
+    EXPECT_TRUE(obj->contains(1));
+    EXPECT_LE(obj->nextWakeup(), 3000);
+
+    // 重新安排时只保留最新的到期时间
+    obj->add(2, 10000);
+    EXPECT_EQ(obj->count(), 2);
+    EXPECT_TRUE(obj->advance(5000).isEmpty());
+    EXPECT_EQ(obj->advance(6000), QList<quint64>() << 1);
+    EXPECT_EQ(obj->advance(10000), QList<quint64>() << 2);
+    EXPECT_TRUE(obj->isEmpty());
+}
+
+TEST_F(UT_TimerWheel, removeTest)
+{
+    obj->add(1, 2000);
+    obj->add(2, 2000);
+    obj->remove(1);
+    EXPECT_FALSE(obj->contains(1));
+    EXPECT_EQ(obj->advance(2000), QList<quint64>() << 2);
+
+    obj->add(3, 4000);
+    obj->remove(3);
+    EXPECT_EQ(obj->nextWakeup(), -1);
+    EXPECT_TRUE(obj->advance(5000).isEmpty());
+}
+
+TEST_F(UT_TimerWheel, advanceTest)
+{
+    // 过期的时间在下一秒到期
+    obj->add(1, -1000);
+    EXPECT_EQ(obj->advance(1000), QList<quint64>() << 1);
+
+    // 高层槽中的条目下沉后按时到期,不会提前
+    const qint64 hour = 60 * 60 * 1000;
+    obj->add(2, hour);
+    obj->add(3, 24 * hour);
+    EXPECT_TRUE(obj->advance(hour - 1000).isEmpty());
+    EXPECT_EQ(obj->advance(hour), QList<quint64>() << 2);
+    EXPECT_LE(obj->nextWakeup(), 24 * hour);
+    EXPECT_TRUE(obj->advance(24 * hour - 1000).isEmpty());
+    EXPECT_EQ(obj->advance(24 * hour), QList<quint64>() << 3);
+
+    // 一次推进很长时间也会返回所有到期的条目
+    obj->add(4, 25 * hour);
+    obj->add(5, 30 * 24 * hour);
+    QList<quint64> expired = obj->advance(60 * 24 * hour);
+    std::sort(expired.begin(), expired.end());
+    EXPECT_EQ(expired, QList<quint64>() << 4 << 5);
+    EXPECT_TRUE(obj->isEmpty());
+}
@@ -0,0 +1,162 @@
+// SPDX-FileCopyrightText: 2024 UnionTech Software Technology Co., Ltd.
+//
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+#include "notification/bubbleimagestore.h"
+
+#include <QDBusArgument>
+#include <QDBusConnection>
+#include <QDBusMessage>
+#include <QDBusServer>
+#include <QDBusUnixFileDescriptor>
+#include <QDBusVirtualObject>
+#include <QMutex>
+#include <QTemporaryDir>
+#include <QTest>
+
+#include <gtest/gtest.h>
+
+#include <sys/mman.h>
+#include <unistd.h>
+
+// 点对点总线上收到的消息,其中的图片数据和通知服务收到的一样是待解析的 QDBusArgument
+class MessageReceiver : public QDBusVirtualObject
+{
+public:
+    QString introspect(const QString &) const override { return QString(); }
+    bool handleMessage(const QDBusMessage &message, const QDBusConnection &) override
+    {
+        QMutexLocker locker(&m_mutex);
+        m_message = message;
+        return true;
+    }
+    QDBusMessage message()
+    {
+        QMutexLocker locker(&m_mutex);
+        return m_message;
+    }
+
+private:
+    QMutex m_mutex;
+    QDBusMessage m_message;
+};
+
+static QVariantMap sendHints(const QVariantMap &hints)
+{
+    QTemporaryDir dir;
+    QDBusServer server(QString("unix:tmpdir=%1").arg(dir.path()));
+    MessageReceiver receiver;
+    QObject::connect(&server, &QDBusServer::newConnection, [&receiver](const QDBusConnection &connection) {
+        QDBusConnection(connection).registerVirtualObject("/", &receiver);
+    });
+
+    QDBusConnection client = QDBusConnection::connectToPeer(server.address(), "ut_bubbleimagestore");
+    client.send(QDBusMessage::createMethodCall(QString(), "/", "org.deepin.dde.Notification1", "Notify") << hints);
+    for (int i = 0; i < 100 && receiver.message().type() == QDBusMessage::InvalidMessage; ++i)
+        QTest::qWait(50);
+    QDBusConnection::disconnectFromPeer("ut_bubbleimagestore");
+
+    return receiver.message().arguments().value(0).toMap();
+}
+
+class UT_BubbleImageStore : public testing::Test
+{
+public:
+    void SetUp() override
+    {
+        obj = new BubbleImageStore(2);
+    }
+
+    void TearDown() override
+    {
+        delete obj;
+        obj = nullptr;
+    }
+
+public:
+    BubbleImageStore *obj = nullptr;
+};
+
+TEST_F(UT_BubbleImageStore, coverageTest)
+{
+    QVariantMap hints;
+    hints["image-path"] = "dde-control-center";
+    EXPECT_TRUE(obj->takeImages(hints).isEmpty());
+    EXPECT_TRUE(hints.contains("image-path"));
+
+    EXPECT_FALSE(obj->contains("unknown"));
+    EXPECT_EQ(obj->image("unknown").fd, -1);
+
+    obj->clear();
+    EXPECT_EQ(obj->count(), 0);
+}
+
+TEST_F(UT_BubbleImageStore, imageDataTest)
+{
+    const int width = 3;
+    const int height = 2;
+    const int rowStride = 12;
+    QByteArray pixels;
+    for (int i = 0; i < rowStride * height; ++i)
+        pixels.append(char(i));
+
+    QDBusArgument image;
+    image.beginStructure();
+    image << width << height << rowStride << true << 8 << 4 << pixels;
+    image.endStructure();
+    QDBusArgument icon;
+    icon.beginStructure();
+    icon << 1 << 1 << 4 << true << 8 << 4 << QByteArray(4, '1');
+    icon.endStructure();
+
+    QVariantMap hints;
+    hints["image-data"] = QVariant::fromValue(image);
+    hints["icon_data"] = QVariant::fromValue(icon);
+    hints["image-path"] = "dde-control-center";
+    hints = sendHints(hints);
+    ASSERT_TRUE(hints.value("image-data").canConvert<QDBusArgument>());
+
+    // 图片数据从 hints 中移走,只保存发布的那一张
+    const QString handle = obj->takeImages(hints);
+    ASSERT_FALSE(handle.isEmpty());
+    EXPECT_FALSE(hints.contains("image-data"));
+    EXPECT_FALSE(hints.contains("icon_data"));
+    EXPECT_TRUE(hints.contains("image-path"));
+    EXPECT_EQ(obj->count(), 1);
+
+    const BubbleImageStore::Image stored = obj->image(handle);
+    ASSERT_GE(stored.fd, 0);
+    EXPECT_EQ(stored.width, width);
+    EXPECT_EQ(stored.height, height);
+    EXPECT_EQ(stored.rowStride, rowStride);
+    EXPECT_TRUE(stored.hasAlpha);
+    EXPECT_EQ(stored.bitsPerSample, 8);
+    EXPECT_EQ(stored.channels, 4);
+    EXPECT_EQ(stored.size, pixels.size());
+
+    // 和 GetBubbleImage 一样复制一份描述符给调用者映射
+    QDBusUnixFileDescriptor fd(stored.fd);
+    ASSERT_TRUE(fd.isValid());
+    void *data = mmap(nullptr, size_t(stored.size), PROT_READ, MAP_SHARED, fd.fileDescriptor(), 0);
+    ASSERT_NE(data, MAP_FAILED);
+    EXPECT_EQ(QByteArray(static_cast<const char *>(data), stored.size), pixels);
+    munmap(data, size_t(stored.size));
+
+    // 密封之后不能再写入
+    EXPECT_LT(::write(fd.fileDescriptor(), "x", 1), 0);
+
+    // 相同的图片使用同一个句柄
+    QVariantMap same;
+    same["image-data"] = QVariant::fromValue(image);
+    same = sendHints(same);
+    EXPECT_EQ(obj->takeImages(same), handle);
+    EXPECT_EQ(obj->count(), 1);
+
+    // 仓库释放句柄后,已经发出的描述符仍然可以读取
+    obj->clear();
+    EXPECT_FALSE(obj->contains(handle));
+    EXPECT_EQ(obj->image(handle).fd, -1);
+    char byte = 0;
+    EXPECT_EQ(pread(fd.fileDescriptor(), &byte, 1, 5), 1);
+    EXPECT_EQ(byte, pixels.at(5));
+}
@@ -8,6 +8,9 @@
 #include "mockpersistence.h"
 #include "mocknotifysetting.h"
 
+#include <QDBusArgument>
+#include <QSignalSpy>
+
 #include <gtest/gtest.h>
 #include <gmock/gmock.h>
 
@@ -61,6 +64,10 @@ public:
                     WillRepeatedly(testing::Invoke(settingHelper, &NotifySettingHelper::setAppSetting));
         EXPECT_CALL(*notifySetting, getAppSetting(testing::_, testing::_)).
                     WillRepeatedly(testing::Invoke(settingHelper, &NotifySettingHelper::getAppSetting));
+        EXPECT_CALL(*notifySetting, getAppSettings(testing::_)).
+                    WillRepeatedly(testing::Invoke(settingHelper, &NotifySettingHelper::getAppSettings));
+        EXPECT_CALL(*notifySetting, setAppSettings(testing::_)).
+                    WillRepeatedly(testing::Invoke(settingHelper, &NotifySettingHelper::setAppSettings));
         EXPECT_CALL(*notifySetting, setSystemSetting(testing::_, testing::_)).
                     WillRepeatedly(testing::Invoke(settingHelper, &NotifySettingHelper::setSystemSetting));
         EXPECT_CALL(*notifySetting, getSystemSetting(testing::_)).
@@ -143,6 +150,27 @@ TEST_F(UT_BubbleManager, coverageTest)
     obj->geometryChanged();
 }
 
+TEST_F(UT_BubbleManager, appInfosTest)
+{
+    QVariantMap infos = obj->GetAppInfos(QStringList() << "deepin-editor" << "google-chrome");
+    ASSERT_EQ(infos.size(), 2);
+    EXPECT_EQ(infos["deepin-editor"].toMap().value(QString::number(AbstractNotifySetting::APPNAME)).toString(), "deepin-editor");
+
+    // 一次修改多个应用的设置
+    QVariantMap editor;
+    editor[QString::number(AbstractNotifySetting::ENABELSOUND)] = false;
+    QVariantMap chrome;
+    chrome[QString::number(AbstractNotifySetting::ENABELPREVIEW)] = false;
+    infos.clear();
+    infos["deepin-editor"] = editor;
+    infos["google-chrome"] = chrome;
+    obj->SetAppInfos(infos);
+
+    infos = obj->GetAppInfos(QStringList() << "deepin-editor" << "google-chrome");
+    EXPECT_FALSE(infos["deepin-editor"].toMap().value(QString::number(AbstractNotifySetting::ENABELSOUND)).toBool());
+    EXPECT_FALSE(infos["google-chrome"].toMap().value(QString::number(AbstractNotifySetting::ENABELPREVIEW)).toBool());
+}
+
 TEST_F(UT_BubbleManager, NotifyTest)
 {
     obj->Notify("deepin-editor", 1, "", "", "", QStringList(), QVariantMap(), 1);
@@ -151,3 +179,108 @@ TEST_F(UT_BubbleManager, NotifyTest)
     obj->Notify("dde-control-center", 1, "", "", "", QStringList(), QVariantMap(), 1);
     obj->Notify("deepin-editor", 1, "", "", "", QStringList(), QVariantMap(), 1);
 }
+
+TEST_F(UT_BubbleManager, DuplicateTest)
+{
+    EntityPtr first = std::make_shared<NotificationEntity>("deepin-editor", "1", "", "summary", "body");
+    EntityPtr second = std::make_shared<NotificationEntity>("deepin-editor", "2", "", "summary ", " body");
+    EntityPtr other = std::make_shared<NotificationEntity>("deepin-editor", "3", "", "summary", "other body");
+
+    EXPECT_EQ(obj->fingerprint(first), obj->fingerprint(second));
+    EXPECT_NE(obj->fingerprint(first), obj->fingerprint(other));
+
+    EXPECT_EQ(obj->mergeDuplicate(first, false), nullptr);
+    EXPECT_EQ(obj->mergeDuplicate(second, false), first);
+    EXPECT_EQ(first->repeatCount(), 2);
+    EXPECT_EQ(obj->mergeDuplicate(other, false), nullptr);
+}
+
+TEST_F(UT_BubbleManager, DuplicateActionTest)
+{
+    // 内容相同但动作不同的通知不合并
+    const QStringList actions { "_open", "Open" };
+    QVariantMap hints;
+    hints["x-deepin-action-_open"] = "deepin-editor,/tmp/a.txt";
+    EntityPtr first = std::make_shared<NotificationEntity>("deepin-editor", "1", "", "summary", "body", actions, hints);
+    EntityPtr same = std::make_shared<NotificationEntity>("deepin-editor", "2", "", "summary", "body", actions, hints);
+    EntityPtr noAction = std::make_shared<NotificationEntity>("deepin-editor", "3", "", "summary", "body");
+    EntityPtr otherAction = std::make_shared<NotificationEntity>("deepin-editor", "4", "", "summary", "body",
+                                                                 QStringList { "_view", "View" }, hints);
+    hints["x-deepin-action-_open"] = "deepin-editor,/tmp/b.txt";
+    EntityPtr otherCommand = std::make_shared<NotificationEntity>("deepin-editor", "5", "", "summary", "body", actions, hints);
+
+    EXPECT_EQ(obj->fingerprint(first), obj->fingerprint(same));
+    EXPECT_NE(obj->fingerprint(first), obj->fingerprint(noAction));
+    EXPECT_NE(obj->fingerprint(first), obj->fingerprint(otherAction));
+    EXPECT_NE(obj->fingerprint(first), obj->fingerprint(otherCommand));
+
+    EXPECT_EQ(obj->mergeDuplicate(first, false), nullptr);
+    EXPECT_EQ(obj->mergeDuplicate(otherAction, false), nullptr);
+    EXPECT_EQ(obj->mergeDuplicate(otherCommand, false), nullptr);
+    EXPECT_EQ(obj->mergeDuplicate(same, false), first);
+    EXPECT_EQ(first->repeatCount(), 2);
+}
+
+TEST_F(UT_BubbleManager, DuplicateRemovedTest)
+{
+    // 记录已经从通知中心删除时不再合并,按新通知处理
+    class RemovedPersistence : public MockPersistence
+    {
+    public:
+        bool updateOne(EntityPtr) override { return false; }
+    };
+    RemovedPersistence removed;
+    AbstractPersistence *persistence = obj->m_persistence;
+    obj->m_persistence = &removed;
+
+    EntityPtr first = std::make_shared<NotificationEntity>("deepin-editor", "1", "", "summary", "body");
+    EntityPtr second = std::make_shared<NotificationEntity>("deepin-editor", "2", "", "summary", "body");
+    EntityPtr third = std::make_shared<NotificationEntity>("deepin-editor", "3", "", "summary", "body");
+
+    const QString ctime = first->ctime();
+    EXPECT_EQ(obj->mergeDuplicate(first, false), nullptr);
+    EXPECT_EQ(obj->mergeDuplicate(second, false), nullptr);
+    EXPECT_EQ(first->repeatCount(), 1);
+    EXPECT_EQ(first->ctime(), ctime);
+
+    // 之后的重复通知合并到新的记录上
+    obj->m_persistence = persistence;
+    EXPECT_EQ(obj->mergeDuplicate(third, false), second);
+    EXPECT_EQ(second->repeatCount(), 2);
+}
+
+TEST_F(UT_BubbleManager, compactBubbleTest)
+{
+    QSignalSpy bubbleSpy(obj, &BubbleManager::ShowBubble);
+    QSignalSpy compactSpy(obj, &BubbleManager::ShowCompactBubble);
+    const auto publish = [this] {
+        QVariantMap hints;
+        hints["image-data"] = QVariant::fromValue(QDBusArgument());
+        hints["urgency"] = 1;
+        obj->publishBubble("deepin-editor", 0, "", "summary", "body", QStringList(), hints, -1, QVariantMap());
+    };
+    const auto hints = [](const QSignalSpy &spy) {
+        return spy.last().at(6).toMap();
+    };
+
+    publish();
+    EXPECT_EQ(bubbleSpy.count(), 1);
+    EXPECT_EQ(compactSpy.count(), 0);
+    EXPECT_TRUE(hints(bubbleSpy).contains("image-data"));
+
+    // 有调用者使用紧凑格式时,两个信号都不携带图片数据
+    obj->SetCompactBubble(true);
+    publish();
+    EXPECT_EQ(bubbleSpy.count(), 2);
+    EXPECT_EQ(compactSpy.count(), 1);
+    EXPECT_FALSE(hints(bubbleSpy).contains("image-data"));
+    EXPECT_FALSE(hints(compactSpy).contains("image-data"));
+    EXPECT_EQ(hints(bubbleSpy).value("urgency"), 1);
+
+    obj->SetCompactBubble(false);
+    publish();
+    EXPECT_EQ(bubbleSpy.count(), 3);
+    EXPECT_EQ(compactSpy.count(), 1);
+    EXPECT_TRUE(hints(bubbleSpy).contains("image-data"));
+    EXPECT_TRUE(obj->m_compactListeners.isEmpty());
+}
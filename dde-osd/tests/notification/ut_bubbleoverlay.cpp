@@ -0,0 +1,81 @@
+// SPDX-FileCopyrightText: 2024 UnionTech Software Technology Co., Ltd.
+//
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+#include "notification/bubbleoverlay.h"
+#include "notification/bubble.h"
+#include "notification/notificationentity.h"
+
+#include <QApplication>
+#include <QPropertyAnimation>
+#include <QScreen>
+#include <QTest>
+
+#include <gtest/gtest.h>
+
+class UT_BubbleOverlay : public testing::Test
+{
+public:
+    void SetUp() override
+    {
+        obj = new BubbleOverlay(qApp->primaryScreen());
+    }
+
+    void TearDown() override
+    {
+        delete obj;
+        obj = nullptr;
+    }
+
+public:
+    BubbleOverlay *obj = nullptr;
+};
+
+TEST_F(UT_BubbleOverlay, maskTest)
+{
+    EXPECT_EQ(obj->overlayScreen(), qApp->primaryScreen());
+    EXPECT_EQ(obj->geometry(), qApp->primaryScreen()->geometry());
+
+    QWidget *child = new QWidget(obj);
+    child->setGeometry(10, 10, 100, 50);
+    child->show();
+    obj->updateMask();
+    EXPECT_TRUE(obj->isVisible());
+    EXPECT_TRUE(obj->mask().contains(QPoint(20, 20)));
+    EXPECT_FALSE(obj->mask().contains(QPoint(200, 200)));
+
+    child->hide();
+    obj->updateMask();
+    EXPECT_FALSE(obj->isVisible());
+}
+
+TEST_F(UT_BubbleOverlay, bubbleTest)
+{
+    EntityPtr entity = std::make_shared<NotificationEntity>("deepin-editor", "0", "deepin-editor", "summary", "body");
+    Bubble *bubble = new Bubble(obj, entity);
+    EXPECT_TRUE(bubble->isOverlayItem());
+    EXPECT_FALSE(bubble->isWindow());
+
+    const QRect rect(obj->geometry().topLeft() + QPoint(30, 40), bubble->size());
+    bubble->setFixedGeometry(rect);
+    EXPECT_EQ(bubble->bubbleGeometry().topLeft(), rect.topLeft());
+}
+
+TEST_F(UT_BubbleOverlay, moveAnimationTest)
+{
+    // 叠加窗口不在屏幕原点时,动画的起止位置也要转换为叠加窗口中的坐标
+    obj->setGeometry(QRect(QPoint(1920, 300), obj->size()));
+    EntityPtr entity = std::make_shared<NotificationEntity>("deepin-editor", "0", "deepin-editor", "summary", "body");
+    Bubble *bubble = new Bubble(obj, entity);
+
+    const QRect start(obj->geometry().topLeft() + QPoint(20, 10), bubble->size());
+    const QRect end = start.translated(0, 80);
+    QPropertyAnimation *animation = bubble->createMoveAnimation(start, end);
+    EXPECT_EQ(animation->startValue().toRect().topLeft(), QPoint(20, 10));
+    EXPECT_EQ(animation->endValue().toRect().topLeft(), QPoint(20, 90));
+
+    animation->start();
+    animation->setCurrentTime(animation->duration());
+    EXPECT_EQ(bubble->pos(), QPoint(20, 90));
+    EXPECT_EQ(bubble->bubbleGeometry().topLeft(), end.topLeft());
+}
@@ -0,0 +1,71 @@
+// SPDX-FileCopyrightText: 2024 UnionTech Software Technology Co., Ltd.
+//
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+#include "notification/htmlsanitizer.h"
+
+#include <QTextDocument>
+
+#include <gtest/gtest.h>
+
+static QString documentPlainText(const QString &source)
+{
+    QTextDocument document;
+    document.setHtml(source);
+    return document.toPlainText();
+}
+
+TEST(UT_HtmlSanitizer, differentialTest)
+{
+    // 和 QTextDocument 的结果保持一致
+    const QStringList sources {
+        "",
+        "plain text",
+        "中文正文",
+        "Hello <b>world</b>",
+        "<i>italic</i> and <u>underline</u>",
+        "<a href=\"https://www.deepin.org\">deepin</a> link",
+        "<span style=\"color:red\">red</span> text",
+        "a &amp; b &lt;c&gt; &quot;d&quot;",
+        "a&nbsp;&nbsp;b",
+        "&#20320;&#x597d;",
+        "caf&eacute; sch&ouml;n &euro;5 &AElig;&szlig; &alpha;&beta; &hearts; &thetasym;",
+        "&Eacute;&eacute; &frac12; &le; &rarr; &zwnj;",
+        "  multiple   spaces\nand\tnewlines",
+        "line1<br>line2<br/>line3",
+        "<p>first</p><p>second</p>",
+        "<p>first</p>\n<p>second</p>",
+        "before<div>inside</div>after",
+        "<!-- comment -->text",
+    };
+
+    for (const QString &source : sources)
+        EXPECT_EQ(HtmlSanitizer::toPlainText(source), documentPlainText(source)) << source.toStdString();
+}
+
+TEST(UT_HtmlSanitizer, markupTest)
+{
+    // 不是标签和实体的字符保持原样
+    EXPECT_EQ(HtmlSanitizer::toPlainText("1 < 2 & 3 > 2"), "1 < 2 & 3 > 2");
+    EXPECT_EQ(HtmlSanitizer::toPlainText("&unknown; &amp"), "&unknown; &amp");
+    // 实体名区分大小写
+    EXPECT_EQ(HtmlSanitizer::toPlainText("&Eacute;&eacute;&EACUTE;"), QString::fromUtf8("Éé&EACUTE;"));
+
+    // 图片显示 alt 文字
+    EXPECT_EQ(HtmlSanitizer::toPlainText("<img src=\"a.png\" alt=\"photo &amp; text\"/> sent"), "photo & text sent");
+    EXPECT_EQ(HtmlSanitizer::toPlainText("<img src=\"a.png\">"), "");
+
+    // 属性中的 > 不会结束标签
+    EXPECT_EQ(HtmlSanitizer::toPlainText("<a title=\"a>b\">link</a>"), "link");
+
+    // 不显示的内容
+    EXPECT_EQ(HtmlSanitizer::toPlainText("<style>p { color: red; }</style>body"), "body");
+    EXPECT_EQ(HtmlSanitizer::toPlainText("<SCRIPT>alert('<b>')</SCRIPT>body"), "body");
+    EXPECT_EQ(HtmlSanitizer::toPlainText("<html><head><title>title</title></head><body><p>body</p></body></html>"), "body");
+
+    // pre 中保留空白
+    EXPECT_EQ(HtmlSanitizer::toPlainText("<pre>a  b\nc</pre>"), "a  b\nc");
+
+    // 补充平面的字符
+    EXPECT_EQ(HtmlSanitizer::toPlainText("&#x1F600;"), QString::fromUcs4(U"\U0001F600"));
+}
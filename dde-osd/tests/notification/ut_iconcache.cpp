@@ -0,0 +1,142 @@
+// SPDX-FileCopyrightText: 2024 UnionTech Software Technology Co., Ltd.
+//
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+#define private public
+#include "notification/iconcache.h"
+#undef private
+
+#include <QBuffer>
+#include <QDateTime>
+#include <QFile>
+#include <QImage>
+#include <QTemporaryDir>
+#include <QUrl>
+
+#include <gtest/gtest.h>
+
+// 生成一张纯色的 PNG,不依赖系统的图标主题
+static QByteArray pngData(const QColor &color)
+{
+    QImage image(16, 16, QImage::Format_ARGB32);
+    image.fill(color);
+
+    QByteArray data;
+    QBuffer buffer(&data);
+    buffer.open(QIODevice::WriteOnly);
+    image.save(&buffer, "PNG");
+    return data;
+}
+
+static QString dataUri(const QColor &color)
+{
+    return QString("data:image/png;base64,") + QString::fromLatin1(pngData(color).toBase64());
+}
+
+class UT_IconCache : public testing::Test
+{
+public:
+    void SetUp() override
+    {
+        obj = &IconCache::ref();
+        obj->clear();
+        maxCost = obj->maxCost();
+    }
+
+    void TearDown() override
+    {
+        obj->setMaxCost(maxCost);
+        obj->clear();
+        obj = nullptr;
+    }
+
+public:
+    IconCache *obj = nullptr;
+    int maxCost = 0;
+};
+
+TEST_F(UT_IconCache, hitTest)
+{
+    const QString red = dataUri(Qt::red);
+    const QPixmap &first = obj->pixmap(red, "", QSize(48, 48), 1.0);
+    ASSERT_FALSE(first.isNull());
+    EXPECT_EQ(first.size(), QSize(48, 48));
+    EXPECT_EQ(first.toImage().pixelColor(24, 24), QColor(Qt::red));
+    EXPECT_EQ(obj->count(), 1);
+
+    // 命中缓存时返回同一张图片
+    const QPixmap &second = obj->pixmap(red, "", QSize(48, 48), 1.0);
+    EXPECT_EQ(first.cacheKey(), second.cacheKey());
+    EXPECT_EQ(obj->count(), 1);
+
+    // 缩放比和尺寸是键的一部分
+    const QPixmap &hiDpi = obj->pixmap(red, "", QSize(48, 48), 2.0);
+    EXPECT_EQ(hiDpi.size(), QSize(96, 96));
+    EXPECT_EQ(hiDpi.devicePixelRatio(), 2.0);
+    EXPECT_NE(hiDpi.cacheKey(), first.cacheKey());
+    obj->pixmap(red, "", QSize(24, 24), 1.0);
+    EXPECT_EQ(obj->count(), 3);
+
+    // 清空后重新加载
+    obj->clear();
+    EXPECT_EQ(obj->count(), 0);
+    const QPixmap &reloaded = obj->pixmap(red, "", QSize(48, 48), 1.0);
+    EXPECT_NE(reloaded.cacheKey(), first.cacheKey());
+    EXPECT_EQ(obj->count(), 1);
+}
+
+TEST_F(UT_IconCache, costTest)
+{
+    // 48x48 的 32 位图片
+    const int cost = 48 * 48 * 4;
+
+    obj->setMaxCost(0);
+    EXPECT_FALSE(obj->pixmap(dataUri(Qt::red), "", QSize(48, 48), 1.0).isNull());
+    EXPECT_EQ(obj->count(), 0);
+
+    // 按字节数淘汰最久没有使用的图标
+    obj->setMaxCost(cost * 2);
+    const QString red = dataUri(Qt::red);
+    const QString green = dataUri(Qt::green);
+    const QString blue = dataUri(Qt::blue);
+    const qint64 redKey = obj->pixmap(red, "", QSize(48, 48), 1.0).cacheKey();
+    const qint64 greenKey = obj->pixmap(green, "", QSize(48, 48), 1.0).cacheKey();
+    EXPECT_EQ(obj->count(), 2);
+
+    EXPECT_EQ(obj->pixmap(red, "", QSize(48, 48), 1.0).cacheKey(), redKey);
+    obj->pixmap(blue, "", QSize(48, 48), 1.0);
+    EXPECT_EQ(obj->count(), 2);
+    EXPECT_EQ(obj->pixmap(red, "", QSize(48, 48), 1.0).cacheKey(), redKey);
+    EXPECT_NE(obj->pixmap(green, "", QSize(48, 48), 1.0).cacheKey(), greenKey);
+
+    // 超过容量的图片不缓存
+    obj->clear();
+    EXPECT_FALSE(obj->pixmap(red, "", QSize(96, 96), 1.0).isNull());
+    EXPECT_EQ(obj->count(), 0);
+}
+
+TEST_F(UT_IconCache, fileTest)
+{
+    QTemporaryDir dir;
+    const QString path = dir.filePath("icon.png");
+    QFile file(path);
+    ASSERT_TRUE(file.open(QIODevice::WriteOnly));
+    file.write(pngData(Qt::red));
+    file.close();
+
+    // 同一个路径的图片被覆盖写入后,修改时间不同,不再使用旧的缓存
+    const QString &key = IconCache::cacheKey(path, "", QSize(48, 48), 1.0);
+    EXPECT_EQ(IconCache::cacheKey(path, "", QSize(48, 48), 1.0), key);
+    EXPECT_EQ(IconCache::cacheKey(QUrl::fromLocalFile(path).toString(), "", QSize(48, 48), 1.0).section('|', -1), key.section('|', -1));
+
+    ASSERT_TRUE(file.open(QIODevice::WriteOnly | QIODevice::Truncate));
+    file.write(pngData(Qt::blue));
+    file.flush();
+    ASSERT_TRUE(file.setFileTime(QDateTime::currentDateTime().addSecs(10), QFileDevice::FileModificationTime));
+    file.close();
+    EXPECT_NE(IconCache::cacheKey(path, "", QSize(48, 48), 1.0), key);
+
+    // 不存在的文件和 data: 图片不包含修改时间
+    EXPECT_EQ(IconCache::cacheKey(dir.filePath("none.png"), "", QSize(48, 48), 1.0).count('|'), 2);
+    EXPECT_EQ(IconCache::cacheKey(dataUri(Qt::red), "", QSize(48, 48), 1.0).count('|'), 2);
+}
@@ -45,4 +45,7 @@ TEST_F(UT_NotificationEntity, coverageTest)
     EXPECT_EQ(obj->currentIndex(), 0);
     obj->setShowInNotifyCenter(true);
     EXPECT_TRUE(obj->isShowInNotifyCenter());
+    EXPECT_EQ(obj->repeatCount(), 1);
+    obj->setRepeatCount(3);
+    EXPECT_EQ(obj->repeatCount(), 3);
 }
@@ -0,0 +1,88 @@
+// SPDX-FileCopyrightText: 2024 UnionTech Software Technology Co., Ltd.
+//
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+#include "notification/notificationrecord.h"
+#include "notification/notificationentity.h"
+
+#include <gtest/gtest.h>
+
+class UT_NotificationRecord : public testing::Test
+{
+};
+
+TEST_F(UT_NotificationRecord, internTest)
+{
+    NotificationRecord record1;
+    NotificationRecord record2;
+    record1.setAppName(QString("deepin-") + "editor");
+    record2.setAppName(QString("deepin-ed") + "itor");
+
+    EXPECT_EQ(record1.appName(), "deepin-editor");
+    // 驻留后两条记录共享同一份字符串数据
+    EXPECT_EQ(record1.appName().constData(), record2.appName().constData());
+    EXPECT_TRUE(StringPool::intern(QString()).isNull());
+
+    // 图标可能是每条通知都不同的 data URI,不放入字符串表
+    const int poolSize = StringPool::size();
+    record1.setAppIcon("data:image/png;base64,iVBORw0KGgo=");
+    EXPECT_EQ(StringPool::size(), poolSize);
+
+    record1.setActions({"default", "Open", "reply", "Reply"});
+    record2.setActions({QString("def") + "ault", "Open"});
+    EXPECT_EQ(record1.actions().first().constData(), record2.actions().first().constData());
+    EXPECT_EQ(record1.actions(), QStringList({"default", "Open", "reply", "Reply"}));
+}
+
+TEST_F(UT_NotificationRecord, hintsTest)
+{
+    NotificationRecord record;
+    QVariantMap hints;
+    hints["urgency"] = 1;
+    hints["desktop-entry"] = "deepin-editor";
+    record.setHints(hints);
+
+    EXPECT_EQ(record.hints(), hints);
+    EXPECT_EQ(record.hint("urgency").toInt(), 1);
+    EXPECT_FALSE(record.hint("x-deepin-action").isValid());
+    EXPECT_EQ(record.hint("x-deepin-action", "none").toString(), "none");
+
+    record.setHint("category", "im");
+    record.setHint("urgency", 2);
+    EXPECT_EQ(record.hints().keys(), QStringList({"category", "desktop-entry", "urgency"}));
+    EXPECT_EQ(record.hint("urgency").toInt(), 2);
+
+    record.removeHint("category");
+    EXPECT_FALSE(record.hints().contains("category"));
+}
+
+TEST_F(UT_NotificationRecord, flagTest)
+{
+    NotificationRecord record;
+    EXPECT_FALSE(record.testFlag(NotificationRecord::IsTitle));
+    EXPECT_TRUE(record.testFlag(NotificationRecord::ShowPreview));
+    EXPECT_TRUE(record.testFlag(NotificationRecord::ShowInNotifyCenter));
+
+    record.setFlag(NotificationRecord::IsTitle);
+    record.setFlag(NotificationRecord::ShowPreview, false);
+    EXPECT_TRUE(record.testFlag(NotificationRecord::IsTitle));
+    EXPECT_FALSE(record.testFlag(NotificationRecord::ShowPreview));
+}
+
+TEST_F(UT_NotificationRecord, entityTest)
+{
+    NotificationEntity entity("deepin-editor", "3", "deepin-editor", "summary", "body",
+                              QStringList(), QVariantMap(), "1600000000000", "3", "-1");
+    entity.setStorageId("12");
+
+    const NotificationRecord &record = entity.record();
+    EXPECT_EQ(record.id(), 3u);
+    EXPECT_EQ(record.ctime(), 1600000000000);
+    EXPECT_EQ(record.timeout(), -1);
+    EXPECT_EQ(record.storageId(), 12);
+
+    NotificationEntity copy(record);
+    EXPECT_EQ(copy.ctime(), "1600000000000");
+    EXPECT_EQ(copy.storageId(), "12");
+    EXPECT_TRUE(NotificationEntity().storageId().isEmpty());
+}
@@ -0,0 +1,79 @@
+// SPDX-FileCopyrightText: 2024 UnionTech Software Technology Co., Ltd.
+//
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+#include "notification/notifystyle.h"
+
+#include <QWidget>
+#include <QSignalSpy>
+
+#include <gtest/gtest.h>
+
+class UT_NotifyStyle : public testing::Test
+{
+public:
+    void SetUp() override
+    {
+        obj = &NotifyStyle::ref();
+    }
+
+    void TearDown() override
+    {
+        obj = nullptr;
+    }
+
+public:
+    NotifyStyle *obj = nullptr;
+};
+
+TEST_F(UT_NotifyStyle, snapshotTest)
+{
+    const NotifyStylePtr &style = obj->current();
+    ASSERT_FALSE(style.isNull());
+    EXPECT_TRUE(style->groupTitleFont.bold());
+    EXPECT_GT(style->captionHeight, 0);
+
+    // 每次刷新都是新的快照,旧的快照不受影响
+    QSignalSpy spy(obj, &NotifyStyle::styleChanged);
+    obj->refresh();
+    EXPECT_EQ(spy.count(), 1);
+    EXPECT_NE(obj->current(), style);
+    EXPECT_EQ(obj->current()->generation, style->generation + 1);
+}
+
+TEST_F(UT_NotifyStyle, subscribeTest)
+{
+    const int subscribers = obj->subscriberCount();
+    QWidget window;
+    QWidget *visible = new QWidget(&window);
+    QWidget *hidden = new QWidget(&window);
+    hidden->setVisible(false);
+    window.show();
+
+    int visibleCount = 0;
+    int hiddenCount = 0;
+    obj->subscribe(visible, [&visibleCount](const NotifyStylePtr &) { visibleCount++; });
+    obj->subscribe(hidden, [&hiddenCount](const NotifyStylePtr &) { hiddenCount++; });
+    EXPECT_EQ(obj->subscriberCount(), subscribers + 2);
+    EXPECT_EQ(visibleCount, 1);
+    EXPECT_EQ(hiddenCount, 1);
+
+    // 可见的控件立即更新,隐藏的控件显示时再更新
+    obj->refresh();
+    EXPECT_EQ(visibleCount, 2);
+    EXPECT_EQ(hiddenCount, 1);
+    EXPECT_EQ(obj->pendingCount(), 1);
+    EXPECT_TRUE(window.updatesEnabled());
+
+    hidden->show();
+    EXPECT_EQ(hiddenCount, 2);
+    EXPECT_EQ(obj->pendingCount(), 0);
+
+    obj->unsubscribe(visible);
+    obj->refresh();
+    EXPECT_EQ(visibleCount, 2);
+    EXPECT_EQ(hiddenCount, 3);
+
+    delete hidden;
+    EXPECT_EQ(obj->subscriberCount(), subscribers);
+}
@@ -0,0 +1,37 @@
+// SPDX-FileCopyrightText: 2024 UnionTech Software Technology Co., Ltd.
+//
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+#include "notification/settingstransaction.h"
+
+#include <gtest/gtest.h>
+
+TEST(UT_SettingsTransaction, collectTest)
+{
+    const QByteArray schema("com.deepin.dde.notifications.applications");
+    SettingsTransaction transaction;
+    EXPECT_TRUE(transaction.isEmpty());
+
+    // 同一个(schema, 路径)的修改合并,同一个键只保留最后一次
+    transaction.set(schema, "/com/deepin/dde/notifications/applications/deepin-editor/", "app-name", "Editor");
+    transaction.set(schema, "/com/deepin/dde/notifications/applications/deepin-editor/", "enable-sound", true);
+    transaction.set(schema, "/com/deepin/dde/notifications/applications/deepin-editor/", "app-name", "Text Editor");
+    transaction.reset(schema, "/com/deepin/dde/notifications/applications/deepin-music/", "app-name");
+    EXPECT_EQ(transaction.schemaCount(), 2);
+    EXPECT_EQ(transaction.changeCount(), 3);
+
+    transaction.rollback();
+    EXPECT_TRUE(transaction.isEmpty());
+    EXPECT_EQ(transaction.changeCount(), 0);
+}
+
+TEST(UT_SettingsTransaction, commitTest)
+{
+    SettingsTransaction transaction;
+    EXPECT_TRUE(transaction.commit());
+
+    // 没有安装的 schema 跳过,提交后事务清空
+    transaction.set("com.deepin.dde.notifications.not-installed", "/com/deepin/dde/notifications/not-installed/", "dndmode", true);
+    EXPECT_FALSE(transaction.commit());
+    EXPECT_TRUE(transaction.isEmpty());
+}
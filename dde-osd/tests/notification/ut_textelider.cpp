@@ -0,0 +1,78 @@
+// SPDX-FileCopyrightText: 2024 UnionTech Software Technology Co., Ltd.
+//
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+#include "notification/textelider.h"
+
+#include <QApplication>
+#include <QElapsedTimer>
+#include <QFontMetrics>
+
+#include <gtest/gtest.h>
+
+class UT_TextElider : public testing::Test
+{
+public:
+    void SetUp() override
+    {
+        obj = &TextElider::ref();
+        obj->clear();
+    }
+
+    void TearDown() override
+    {
+        obj->clear();
+        obj = nullptr;
+    }
+
+    QRect boundingRect(const QString &text, const QSize &size) const
+    {
+        return QFontMetrics(font).boundingRect(QRect(QPoint(0, 0), size), Qt::AlignTop | Qt::AlignLeft | Qt::TextWordWrap, text);
+    }
+
+public:
+    TextElider *obj = nullptr;
+    QFont font = qApp->font();
+};
+
+TEST_F(UT_TextElider, elideTest)
+{
+    const QSize size(200, QFontMetrics(font).height() * 2);
+
+    // 放得下时保持不变
+    EXPECT_EQ(obj->elide("unittest", font, size), QString("unittest"));
+
+    const QString text = QString("notification body ").repeated(20);
+    const QString &elided = obj->elide(text, font, size);
+    EXPECT_LT(elided.size(), text.size());
+    EXPECT_TRUE(elided.endsWith(QChar(0x2026)));
+    EXPECT_TRUE(text.startsWith(elided.chopped(1)));
+    EXPECT_LE(boundingRect(elided, size).height(), size.height());
+
+    // 同样的参数直接使用缓存的结果
+    EXPECT_EQ(obj->count(), 2);
+    EXPECT_EQ(obj->elide(text, font, size), elided);
+    EXPECT_EQ(obj->count(), 2);
+}
+
+TEST_F(UT_TextElider, graphemeTest)
+{
+    // 组合字符和代理对不会被拆开
+    const QString text = QString("e\u0301\U0001F600").repeated(200);
+    const QString &elided = TextElider::elideText(text, font, QSize(100, QFontMetrics(font).height()));
+    const QString prefix = elided.chopped(1);
+    ASSERT_FALSE(prefix.isEmpty());
+    EXPECT_FALSE(prefix.at(prefix.size() - 1).isHighSurrogate());
+    EXPECT_NE(prefix.at(prefix.size() - 1), QChar('e'));
+}
+
+TEST_F(UT_TextElider, longTextTest)
+{
+    // 只排版能显示出来的部分,长文本不会阻塞界面
+    const QString text = QString("log line with some content\n").repeated(4000);
+    QElapsedTimer timer;
+    timer.start();
+    const QString &elided = TextElider::elideText(text, font, QSize(300, QFontMetrics(font).height() * 3));
+    EXPECT_LT(timer.elapsed(), 500);
+    EXPECT_LT(elided.size(), 200);
+}
@@ -0,0 +1,71 @@
+// SPDX-FileCopyrightText: 2024 UnionTech Software Technology Co., Ltd.
+//
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+#include "notification/textlayoutcache.h"
+
+#include <QFontMetrics>
+#include <QApplication>
+#include <QImage>
+#include <QPainter>
+
+#include <gtest/gtest.h>
+
+class UT_TextLayoutCache : public testing::Test
+{
+public:
+    void SetUp() override
+    {
+        obj = &TextLayoutCache::ref();
+        obj->clear();
+    }
+
+    void TearDown() override
+    {
+        obj->clear();
+        obj = nullptr;
+    }
+
+public:
+    TextLayoutCache *obj = nullptr;
+    QFont font = qApp->font();
+};
+
+TEST_F(UT_TextLayoutCache, layoutTest)
+{
+    const QString text("short text");
+    TextLayoutPtr first = obj->layout(text, font, 300);
+    TextLayoutPtr second = obj->layout(text, font, 300);
+    EXPECT_EQ(first, second);
+    EXPECT_EQ(obj->count(), 1);
+    EXPECT_EQ(first->lineCount(), 1);
+    EXPECT_EQ(first->height(), QFontMetrics(font).height());
+    EXPECT_FALSE(first->isElided());
+    EXPECT_EQ(first->elidedText(), text);
+
+    // 行数没有超出时直接使用不限制行数的排版
+    EXPECT_EQ(obj->layout(text, font, 300, 2), first);
+    EXPECT_EQ(obj->count(), 1);
+
+    // 宽度变化时重新排版
+    EXPECT_NE(obj->layout(text, font, 200), first);
+    EXPECT_EQ(obj->count(), 2);
+}
+
+TEST_F(UT_TextLayoutCache, elideTest)
+{
+    const QString text = QString("notification body ").repeated(20);
+    TextLayoutPtr full = obj->layout(text, font, 100);
+    ASSERT_GT(full->lineCount(), 2);
+    EXPECT_FALSE(full->isElided());
+
+    TextLayoutPtr elided = obj->layout(text, font, 100, 2);
+    EXPECT_EQ(elided->lineCount(), 2);
+    EXPECT_EQ(elided->height(), 2 * QFontMetrics(font).height());
+    EXPECT_TRUE(elided->isElided());
+    EXPECT_LT(elided->elidedText().size(), text.size());
+
+    QImage image(100, elided->height(), QImage::Format_ARGB32);
+    QPainter painter(&image);
+    elided->draw(&painter, QPointF(0, 0));
+}
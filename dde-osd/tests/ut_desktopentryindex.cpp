@@ -0,0 +1,178 @@
+// SPDX-FileCopyrightText: 2024 UnionTech Software Technology Co., Ltd.
+//
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+#define private public
+#include "desktopentryindex.h"
+#undef private
+
+#include <QDateTime>
+#include <QDir>
+#include <QFile>
+#include <QFileInfo>
+#include <QFileSystemWatcher>
+#include <QSignalSpy>
+#include <QTemporaryDir>
+
+#include <gtest/gtest.h>
+
+class UT_DesktopEntryIndex : public testing::Test
+{
+public:
+    void SetUp() override
+    {
+        // 应用目录只有临时目录下的 applications
+        m_dataHome = qgetenv("XDG_DATA_HOME");
+        m_dataDirs = qgetenv("XDG_DATA_DIRS");
+        m_cacheHome = qgetenv("XDG_CACHE_HOME");
+        qputenv("XDG_DATA_HOME", m_dir.filePath("data").toLocal8Bit());
+        qputenv("XDG_DATA_DIRS", m_dir.filePath("none").toLocal8Bit());
+        qputenv("XDG_CACHE_HOME", m_dir.filePath("cache").toLocal8Bit());
+
+        m_appDir = m_dir.filePath("data/applications");
+        QDir().mkpath(m_appDir + "/deepin");
+        obj = new DesktopEntryIndex;
+    }
+
+    void TearDown() override
+    {
+        delete obj;
+        obj = nullptr;
+        qputenv("XDG_DATA_HOME", m_dataHome);
+        qputenv("XDG_DATA_DIRS", m_dataDirs);
+        qputenv("XDG_CACHE_HOME", m_cacheHome);
+    }
+
+    QString writeDesktop(const QString &fileName, const QString &name, const QString &exec)
+    {
+        const QString path = m_appDir + "/" + fileName;
+        QFile file(path);
+        file.open(QIODevice::WriteOnly | QIODevice::Truncate);
+        file.write(QString("[Desktop Entry]\nType=Application\nName=%1\nExec=%2 %U\nIcon=%3\n")
+                   .arg(name, exec, QFileInfo(exec).fileName()).toUtf8());
+        file.close();
+        return path;
+    }
+
+    bool rebuild()
+    {
+        QSignalSpy spy(obj, &DesktopEntryIndex::updated);
+        obj->rebuild();
+        return spy.wait(5000);
+    }
+
+public:
+    DesktopEntryIndex *obj = nullptr;
+    QTemporaryDir m_dir;
+    QString m_appDir;
+    QByteArray m_dataHome;
+    QByteArray m_dataDirs;
+    QByteArray m_cacheHome;
+};
+
+TEST_F(UT_DesktopEntryIndex, lookupTest)
+{
+    const QString musicPath = writeDesktop("deepin-music.desktop", "Music", "/usr/bin/deepin-music");
+    const QString editorPath = writeDesktop("deepin/editor.desktop", "Editor", "/usr/bin/deepin-editor");
+
+    // 构建完成之前查询不到,不会在调用线程中解析
+    EXPECT_FALSE(obj->isReady());
+    EXPECT_FALSE(obj->entry("deepin-music").isValid());
+
+    QSignalSpy spy(obj, &DesktopEntryIndex::updated);
+    obj->load();
+    ASSERT_TRUE(spy.wait(5000));
+    EXPECT_TRUE(obj->isReady());
+
+    const DesktopEntryInfo &music = obj->entry("deepin-music");
+    EXPECT_EQ(music.path, musicPath);
+    EXPECT_EQ(music.name, "Music");
+    EXPECT_EQ(music.icon, "deepin-music");
+    EXPECT_EQ(music.exec, "deepin-music");
+
+    // 子目录中的desktop id 用 - 连接
+    EXPECT_EQ(obj->entry("deepin-editor").path, editorPath);
+    EXPECT_EQ(obj->entryByPath(editorPath).id, "deepin-editor");
+    EXPECT_EQ(obj->entryByExec("/usr/bin/deepin-editor").id, "deepin-editor");
+    EXPECT_EQ(obj->entryByExec("deepin-music").id, "deepin-music");
+
+    EXPECT_FALSE(obj->entry("unknown").isValid());
+    EXPECT_FALSE(obj->entryByExec("unknown").isValid());
+
+    // 重新扫描后能找到新增的文件,删除的文件不再存在
+    writeDesktop("deepin-terminal.desktop", "Terminal", "/usr/bin/deepin-terminal");
+    QFile::remove(musicPath);
+    ASSERT_TRUE(rebuild());
+    EXPECT_EQ(obj->entry("deepin-terminal").name, "Terminal");
+    EXPECT_EQ(obj->entryByExec("deepin-terminal").id, "deepin-terminal");
+    EXPECT_FALSE(obj->entry("deepin-music").isValid());
+    EXPECT_FALSE(obj->entryByExec("deepin-music").isValid());
+    EXPECT_TRUE(obj->entry("deepin-editor").isValid());
+}
+
+TEST_F(UT_DesktopEntryIndex, cacheTest)
+{
+    const QString cacheFile = m_dir.filePath("desktop-entries.cache");
+    const QStringList dirs { m_appDir };
+    const QString path = writeDesktop("deepin-music.desktop", "Music", "/usr/bin/deepin-music");
+    const QDateTime mtime = QFileInfo(path).lastModified();
+
+    DesktopEntryIndex::Snapshot snapshot = DesktopEntryIndex::scan(dirs, cacheFile);
+    EXPECT_EQ(snapshot.entries.value("deepin-music").name, "Music");
+    ASSERT_TRUE(QFile::exists(cacheFile));
+
+    // 修改时间和大小都没有变化时使用缓存的解析结果
+    writeDesktop("deepin-music.desktop", "Mus1c", "/usr/bin/deepin-music");
+    QFile file(path);
+    ASSERT_TRUE(file.open(QIODevice::ReadWrite));
+    ASSERT_TRUE(file.setFileTime(mtime, QFileDevice::FileModificationTime));
+    file.close();
+    snapshot = DesktopEntryIndex::scan(dirs, cacheFile);
+    EXPECT_EQ(snapshot.entries.value("deepin-music").name, "Music");
+
+    // 修改时间变化后重新解析
+    ASSERT_TRUE(file.open(QIODevice::ReadWrite));
+    ASSERT_TRUE(file.setFileTime(mtime.addSecs(10), QFileDevice::FileModificationTime));
+    file.close();
+    snapshot = DesktopEntryIndex::scan(dirs, cacheFile);
+    EXPECT_EQ(snapshot.entries.value("deepin-music").name, "Mus1c");
+
+    // 缓存损坏时全部重新解析
+    writeDesktop("deepin-music.desktop", "Music", "/usr/bin/deepin-music");
+    ASSERT_TRUE(file.open(QIODevice::ReadWrite));
+    ASSERT_TRUE(file.setFileTime(mtime.addSecs(10), QFileDevice::FileModificationTime));
+    file.close();
+    QFile cache(cacheFile);
+    ASSERT_TRUE(cache.open(QIODevice::WriteOnly | QIODevice::Truncate));
+    cache.write("broken");
+    cache.close();
+    snapshot = DesktopEntryIndex::scan(dirs, cacheFile);
+    EXPECT_EQ(snapshot.entries.value("deepin-music").name, "Music");
+}
+
+TEST_F(UT_DesktopEntryIndex, createdDirTest)
+{
+    // XDG_DATA_DIRS 下的应用目录还不存在时监听最近的已存在的上级目录
+    const QString missingDir = m_dir.filePath("none/applications");
+    QSignalSpy spy(obj, &DesktopEntryIndex::updated);
+    obj->load();
+    ASSERT_TRUE(spy.wait(5000));
+    EXPECT_EQ(obj->m_snapshot.missingDirs.value(missingDir), QDir::cleanPath(m_dir.path()));
+    EXPECT_TRUE(obj->m_fileWatcher->directories().contains(QDir::cleanPath(m_dir.path())));
+    EXPECT_FALSE(obj->entry("deepin-draw").isValid());
+
+    // 上级目录中无关的变化不重新扫描
+    QDir().mkpath(m_dir.filePath("other"));
+    EXPECT_FALSE(spy.wait(2000));
+
+    // 目录创建后重新扫描,之后直接监听创建的目录
+    ASSERT_TRUE(QDir().mkpath(missingDir));
+    QFile file(missingDir + "/deepin-draw.desktop");
+    ASSERT_TRUE(file.open(QIODevice::WriteOnly));
+    file.write("[Desktop Entry]\nType=Application\nName=Draw\nExec=/usr/bin/deepin-draw\n");
+    file.close();
+    ASSERT_TRUE(spy.wait(5000));
+    EXPECT_EQ(obj->entry("deepin-draw").name, "Draw");
+    EXPECT_TRUE(obj->m_snapshot.missingDirs.isEmpty());
+    EXPECT_TRUE(obj->m_fileWatcher->directories().contains(missingDir));
+}
@@ -4,6 +4,7 @@
 
 #include "dmemorywarningdialog.h"
 #include "dmemorywarningdialogadaptor.h"
+#include "desktopentryindex.h"
 #if (defined QT_DEBUG) && (defined CHECK_ACCESSIBLENAME)
 #include "../common/accessibilitycheckerex.h"
 #endif
@@ -36,6 +37,8 @@ int main(int argc, char *args[])
     DLogManager::registerFileAppender();
 #endif
 
+    DesktopEntryIndex::instance()->load();
+
     DMemoryWarningDialog dialog;
     DMemoryWarningDialogAdaptor dbusAdaptor(&dialog);
     Q_UNUSED(dbusAdaptor);
@@ -3,6 +3,7 @@
 // SPDX-License-Identifier: GPL-3.0-or-later
 
 #include "processinfomanager.h"
+#include "desktopentryindex.h"
 
 #include <QTimer>
 #include <QDebug>
@@ -26,32 +27,9 @@ const QStringList BlackListDesktopSuffix = { "google-chrome.desktop",
 
 QString genericAppName(const QString &desktop)
 {
-    do {
-        if (desktop.isEmpty())
-            break;
-
-        QFile f(desktop);
-        if (!f.open(QIODevice::ReadOnly))
-            break;
-
-        const QString output = f.readAll();
-        const QString locale = QLocale().name();
-
-        QRegularExpression regex(QString("Name\\[%1\\]=(.+)$").arg(locale));
-        regex.setPatternOptions(QRegularExpression::MultilineOption);
-        auto match = regex.match(output);
-        if (match.isValid() && match.hasMatch())
-            return match.captured(1);
-
-        regex = QRegularExpression(QString("^Name=(.+)$"));
-        regex.setPatternOptions(QRegularExpression::MultilineOption);
-        match = regex.match(output);
-        if (match.isValid() && match.hasMatch())
-            return match.captured(1);
-
-    } while (false);
+    const QString &name = DesktopEntryIndex::instance()->entryByPath(desktop).name;
 
-    return desktop;
+    return name.isEmpty() ? desktop : name;
 }
 
 QMap<QString, QString> parseValuePairs(const QStringList &valuePairs)
@@ -3,10 +3,10 @@
 // SPDX-License-Identifier: GPL-3.0-or-later
 
 #include "processinfomodel.h"
+#include "desktopentryindex.h"
 
 #include <QDebug>
 #include <QIcon>
-#include <QFile>
 #include <QRegularExpression>
 
 inline QString formatMem(const unsigned mem_bytes)
@@ -29,18 +29,9 @@ QPixmap appIcon(const int size, const QString &desktop)
 {
     static QIcon defaultIcon = QIcon::fromTheme("application-x-desktop");
 
-    QFile file(desktop);
-
-    if (file.open(QIODevice::ReadOnly)) {
-        const QString &content = file.readAll();
-        const QStringList &lines = content.split('\n');
-
-        auto it = std::find_if(lines.begin(), lines.end(), [](const QString &line) { return line.split('=').first() == "Icon"; });
-        if (it != lines.end()) {
-            const QString icon = it->split('=').last();
-            return QIcon::fromTheme(icon, defaultIcon).pixmap(size, size);
-        }
-    }
+    const DesktopEntryInfo &info = DesktopEntryIndex::instance()->entryByPath(desktop);
+    if (!info.icon.isEmpty())
+        return QIcon::fromTheme(info.icon, defaultIcon).pixmap(size, size);
 
     return QIcon::fromTheme(appName(desktop), defaultIcon).pixmap(size, size);
 }
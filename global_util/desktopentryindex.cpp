@@ -0,0 +1,361 @@
+// SPDX-FileCopyrightText: 2024 UnionTech Software Technology Co., Ltd.
+//
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+#include "desktopentryindex.h"
+
+#include <QCoreApplication>
+#include <QDataStream>
+#include <QDateTime>
+#include <QDebug>
+#include <QDir>
+#include <QDirIterator>
+#include <QFileInfo>
+#include <QFileSystemWatcher>
+#include <QLocale>
+#include <QSaveFile>
+#include <QStandardPaths>
+#include <QTimer>
+#include <QtConcurrent>
+
+#include <DDesktopEntry>
+
+DCORE_USE_NAMESPACE
+
+// 安装/卸载应用时目录会在短时间内连续变化,合并后再重新构建
+static const int RescanDelay = 1000;
+
+// 解析结果缓存文件的格式,名称是按系统语言解析的,语言变化后缓存失效
+static const quint32 CacheMagic = 0x44454943;
+static const qint32 CacheVersion = 1;
+
+// 扫描到的一个desktop文件,缓存中以路径为键,修改时间和大小都没有变化时直接使用缓存的解析结果
+struct DesktopFile {
+    QString id;
+    QString path;
+    qint64 mtime = 0;
+    qint64 size = 0;
+    DesktopEntryInfo info;      // 解析失败时为无效的信息,同样缓存,避免每次都重新解析
+};
+
+static QDataStream &operator<<(QDataStream &out, const DesktopEntryInfo &info)
+{
+    return out << info.id << info.path << info.name << info.genericName << info.icon
+               << info.exec << info.vendor << info.createdBy << info.noDisplay;
+}
+
+static QDataStream &operator>>(QDataStream &in, DesktopEntryInfo &info)
+{
+    return in >> info.id >> info.path >> info.name >> info.genericName >> info.icon
+              >> info.exec >> info.vendor >> info.createdBy >> info.noDisplay;
+}
+
+static QHash<QString, DesktopFile> loadCache(const QString &fileName)
+{
+    QHash<QString, DesktopFile> cache;
+    QFile file(fileName);
+    if (fileName.isEmpty() || !file.open(QIODevice::ReadOnly))
+        return cache;
+
+    QDataStream in(&file);
+    quint32 magic = 0;
+    qint32 version = 0;
+    QString locale;
+    in >> magic >> version >> locale;
+    if (magic != CacheMagic || version != CacheVersion || locale != QLocale::system().name())
+        return cache;
+
+    qint32 count = 0;
+    in >> count;
+    for (qint32 i = 0; i < count && in.status() == QDataStream::Ok; ++i) {
+        DesktopFile desktopFile;
+        in >> desktopFile.path >> desktopFile.mtime >> desktopFile.size >> desktopFile.info;
+        cache.insert(desktopFile.path, desktopFile);
+    }
+
+    if (in.status() != QDataStream::Ok) {
+        qWarning() << "desktop entry cache is corrupted:" << fileName;
+        cache.clear();
+    }
+    return cache;
+}
+
+static void saveCache(const QString &fileName, const QVector<DesktopFile> &files)
+{
+    if (fileName.isEmpty())
+        return;
+
+    QDir().mkpath(QFileInfo(fileName).absolutePath());
+    QSaveFile file(fileName);
+    if (!file.open(QIODevice::WriteOnly)) {
+        qWarning() << "failed to write desktop entry cache:" << fileName << file.errorString();
+        return;
+    }
+
+    QDataStream out(&file);
+    out << CacheMagic << CacheVersion << QLocale::system().name() << qint32(files.size());
+    for (const DesktopFile &desktopFile : files)
+        out << desktopFile.path << desktopFile.mtime << desktopFile.size << desktopFile.info;
+    file.commit();
+}
+
+static DesktopEntryInfo parseFile(const DesktopFile &desktopFile)
+{
+    return DesktopEntryIndex::parse(desktopFile.path, desktopFile.id);
+}
+
+DesktopEntryIndex *DesktopEntryIndex::instance()
+{
+    static DesktopEntryIndex *index = new DesktopEntryIndex(qApp);
+    return index;
+}
+
+DesktopEntryIndex::DesktopEntryIndex(QObject *parent)
+    : QObject(parent)
+    , m_ready(false)
+    , m_rescanPending(false)
+    , m_scanWatcher(new QFutureWatcher<Snapshot>(this))
+    , m_fileWatcher(new QFileSystemWatcher(this))
+    , m_rescanTimer(new QTimer(this))
+{
+    m_rescanTimer->setSingleShot(true);
+    m_rescanTimer->setInterval(RescanDelay);
+
+    connect(m_scanWatcher, &QFutureWatcher<Snapshot>::finished, this, &DesktopEntryIndex::onScanFinished);
+    connect(m_rescanTimer, &QTimer::timeout, this, &DesktopEntryIndex::rebuild);
+    connect(m_fileWatcher, &QFileSystemWatcher::directoryChanged, this, &DesktopEntryIndex::onDirectoryChanged);
+}
+
+void DesktopEntryIndex::load()
+{
+    if (m_ready || m_scanWatcher->isRunning())
+        return;
+
+    rebuild();
+}
+
+DesktopEntryInfo DesktopEntryIndex::entry(const QString &id) const
+{
+    if (id.isEmpty())
+        return DesktopEntryInfo();
+
+    // 索引构建完成之前不在调用线程中解析,调用方在 updated 信号之后重新查询
+    return m_snapshot.entries.value(id);
+}
+
+DesktopEntryInfo DesktopEntryIndex::entryByPath(const QString &path) const
+{
+    if (path.isEmpty())
+        return DesktopEntryInfo();
+
+    const QString &id = m_snapshot.pathIndex.value(path);
+    if (!id.isEmpty())
+        return m_snapshot.entries.value(id);
+
+    auto it = m_extraEntries.constFind(path);
+    if (it != m_extraEntries.constEnd())
+        return it.value();
+
+    const DesktopEntryInfo &info = parse(path);
+    if (info.isValid())
+        m_extraEntries.insert(path, info);
+
+    return info;
+}
+
+DesktopEntryInfo DesktopEntryIndex::entryByExec(const QString &exec) const
+{
+    const QString &id = m_snapshot.execIndex.value(QFileInfo(exec).fileName());
+    return id.isEmpty() ? DesktopEntryInfo() : m_snapshot.entries.value(id);
+}
+
+DesktopEntryInfo DesktopEntryIndex::parse(const QString &path, const QString &id)
+{
+    DesktopEntryInfo info;
+
+    if (!QFileInfo(path).isFile())
+        return info;
+
+    DDesktopEntry desktop(path);
+    if (desktop.status() != DDesktopEntry::NoError)
+        return info;
+
+    info.path = path;
+    info.id = id.isEmpty() ? QFileInfo(path).completeBaseName() : id;
+
+    // desktop文件语言配置规则不固定,通过判断 长语言名/短语言名 获取正确的系统语言对应的应用名
+    QString localKey = "default";
+    const QStringList &keys = desktop.keys();
+    const QString language = QLocale::system().name();
+    const QString shortLanguage = QLocale::system().bcp47Name();
+    if (!keys.filter(language).isEmpty()) {
+        localKey = language;
+    } else if (!keys.filter(shortLanguage).isEmpty()) {
+        localKey = shortLanguage;
+    }
+
+    info.name = desktop.localizedValue("Name", localKey);
+    info.genericName = desktop.localizedValue("GenericName", localKey);
+    info.icon = desktop.stringValue("Icon");
+    info.vendor = desktop.stringValue("X-Deepin-Vendor");
+    info.createdBy = desktop.rawValue("X-Created-By");
+    info.noDisplay = desktop.stringValue("NoDisplay") == "true";
+
+    const QString &exec = desktop.stringValue("Exec").trimmed();
+    if (!exec.isEmpty()) {
+        QString program = exec.section(' ', 0, 0, QString::SectionSkipEmpty);
+        program.remove('"');
+        info.exec = QFileInfo(program).fileName();
+    }
+
+    return info;
+}
+
+QStringList DesktopEntryIndex::applicationDirs()
+{
+    QStringList dirs = QStandardPaths::standardLocations(QStandardPaths::ApplicationsLocation);
+    dirs.removeDuplicates();
+    return dirs;
+}
+
+QString DesktopEntryIndex::cacheFile()
+{
+    const QString &dir = QStandardPaths::writableLocation(QStandardPaths::CacheLocation);
+    return dir.isEmpty() ? QString() : dir + "/desktop-entries.cache";
+}
+
+DesktopEntryIndex::Snapshot DesktopEntryIndex::scan(const QStringList &dirs, const QString &cacheFile)
+{
+    Snapshot snapshot;
+
+    // 1.按照 XDG 目录的优先级列出所有desktop文件,只读取文件信息
+    QVector<DesktopFile> files;
+    for (const QString &dir : dirs) {
+        if (!QFileInfo(dir).isDir()) {
+            // 目录之后才创建时,监听上级目录才能收到通知
+            const QString &parent = existingDir(dir);
+            if (!parent.isEmpty())
+                snapshot.missingDirs.insert(dir, parent);
+            continue;
+        }
+
+        snapshot.dirs << dir;
+        QDirIterator it(dir, QDir::Dirs | QDir::NoDotAndDotDot, QDirIterator::Subdirectories);
+        while (it.hasNext())
+            snapshot.dirs << it.next();
+
+        QDirIterator fileIt(dir, QStringList() << "*.desktop", QDir::Files, QDirIterator::Subdirectories);
+        while (fileIt.hasNext()) {
+            DesktopFile desktopFile;
+            desktopFile.path = fileIt.next();
+            desktopFile.id = desktopFile.path.mid(dir.length() + 1);
+            desktopFile.id.chop(QString(".desktop").length());
+            desktopFile.id.replace('/', '-');
+
+            const QFileInfo &info = fileIt.fileInfo();
+            desktopFile.mtime = info.lastModified().toMSecsSinceEpoch();
+            desktopFile.size = info.size();
+            files.append(desktopFile);
+        }
+    }
+
+    // 2.没有变化的文件使用缓存,其余的在线程池中并行解析
+    const QHash<QString, DesktopFile> &cache = loadCache(cacheFile);
+    QList<DesktopFile> staleFiles;
+    QVector<int> staleIndexes;
+    for (int i = 0; i < files.size(); ++i) {
+        DesktopFile &desktopFile = files[i];
+        auto cached = cache.constFind(desktopFile.path);
+        if (cached != cache.constEnd() && cached->mtime == desktopFile.mtime && cached->size == desktopFile.size) {
+            desktopFile.info = cached->info;
+            if (desktopFile.info.isValid())
+                desktopFile.info.id = desktopFile.id;
+        } else {
+            staleFiles.append(desktopFile);
+            staleIndexes.append(i);
+        }
+    }
+
+    if (!staleFiles.isEmpty()) {
+        const QList<DesktopEntryInfo> &parsed = QtConcurrent::blockingMapped(staleFiles, parseFile);
+        for (int i = 0; i < staleIndexes.size(); ++i)
+            files[staleIndexes.at(i)].info = parsed.at(i);
+    }
+
+    // 3.一次性合并结果,同一个 desktop id 以先找到的有效文件为准
+    for (const DesktopFile &desktopFile : qAsConst(files)) {
+        const DesktopEntryInfo &info = desktopFile.info;
+        if (!info.isValid() || snapshot.entries.contains(info.id))
+            continue;
+
+        snapshot.entries.insert(info.id, info);
+        snapshot.pathIndex.insert(info.path, info.id);
+        if (!info.exec.isEmpty() && !snapshot.execIndex.contains(info.exec))
+            snapshot.execIndex.insert(info.exec, info.id);
+    }
+
+    if (!staleFiles.isEmpty() || cache.size() != files.size())
+        saveCache(cacheFile, files);
+
+    return snapshot;
+}
+
+QString DesktopEntryIndex::existingDir(const QString &dir)
+{
+    QString path = QDir::cleanPath(dir);
+    while (!QFileInfo(path).isDir()) {
+        const QString &parent = QFileInfo(path).absolutePath();
+        if (parent == path)
+            return QString();
+        path = parent;
+    }
+    return path;
+}
+
+void DesktopEntryIndex::rebuild()
+{
+    if (m_scanWatcher->isRunning()) {
+        m_rescanPending = true;
+        return;
+    }
+
+    m_scanWatcher->setFuture(QtConcurrent::run(&DesktopEntryIndex::scan, applicationDirs(), cacheFile()));
+}
+
+void DesktopEntryIndex::onScanFinished()
+{
+    m_snapshot = m_scanWatcher->result();
+    m_extraEntries.clear();
+    m_ready = true;
+
+    const QStringList &watched = m_fileWatcher->directories();
+    if (!watched.isEmpty())
+        m_fileWatcher->removePaths(watched);
+    QStringList dirs = m_snapshot.dirs + m_snapshot.missingDirs.values();
+    dirs.removeDuplicates();
+    if (!dirs.isEmpty())
+        m_fileWatcher->addPaths(dirs);
+
+    Q_EMIT updated();
+
+    if (m_rescanPending) {
+        m_rescanPending = false;
+        rebuild();
+    }
+}
+
+void DesktopEntryIndex::onDirectoryChanged(const QString &path)
+{
+    if (m_snapshot.dirs.contains(path)) {
+        m_rescanTimer->start();
+        return;
+    }
+
+    // 上级目录中的其它变化不需要重新扫描,只在等待的应用目录或者它的某一级上级目录被创建、删除时重新扫描
+    for (auto it = m_snapshot.missingDirs.constBegin(); it != m_snapshot.missingDirs.constEnd(); ++it) {
+        if (it.value() == path && existingDir(it.key()) != path) {
+            m_rescanTimer->start();
+            return;
+        }
+    }
+}
@@ -0,0 +1,106 @@
+// SPDX-FileCopyrightText: 2024 UnionTech Software Technology Co., Ltd.
+//
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+#ifndef DESKTOPENTRYINDEX_H
+#define DESKTOPENTRYINDEX_H
+
+#include <QObject>
+#include <QHash>
+#include <QStringList>
+#include <QFutureWatcher>
+
+class QFileSystemWatcher;
+class QTimer;
+
+/*!
+ * \~chinese \class DesktopEntryInfo
+ * \~chinese \brief 从desktop文件中解析出的、各个模块需要用到的应用信息
+ */
+class DesktopEntryInfo
+{
+public:
+    bool isValid() const { return !path.isEmpty(); }
+
+    QString id;             // desktop id, 如 deepin-music
+    QString path;           // desktop文件的完整路径
+    QString name;           // 当前系统语言下的 Name
+    QString genericName;    // 当前系统语言下的 GenericName
+    QString icon;
+    QString exec;           // Exec 中的可执行程序名
+    QString vendor;         // X-Deepin-Vendor
+    QString createdBy;      // X-Created-By
+    bool noDisplay = false;
+};
+
+/*!
+ * \~chinese \class DesktopEntryIndex
+ * \~chinese \brief 进程内共享的desktop文件索引
+ * \~chinese 在后台线程中一次性解析所有应用目录下的desktop文件,建立 desktop id/路径/可执行程序 到应用信息的映射,
+ * \~chinese 并通过 inotify 监听应用目录,目录有变化时在后台重新构建,避免各个模块在主线程中反复解析desktop文件.
+ * \~chinese 还不存在的应用目录监听最近的已存在的上级目录,目录创建后重新构建.
+ * \~chinese 解析在线程池中并行进行,结果按修改时间缓存到文件中,下次启动时没有变化的desktop文件不再解析
+ */
+class DesktopEntryIndex : public QObject
+{
+    Q_OBJECT
+
+public:
+    static DesktopEntryIndex *instance();
+
+    /*!
+     * \~chinese \name load
+     * \~chinese \brief 开始在后台构建索引,重复调用不会重复构建
+     */
+    void load();
+    bool isReady() const { return m_ready; }
+
+    /*!
+     * \~chinese \name entry
+     * \~chinese \brief 根据desktop id查找应用信息,索引尚未构建完成时返回无效的信息,
+     * \~chinese 需要的话在 updated 信号之后重新查询
+     */
+    DesktopEntryInfo entry(const QString &id) const;
+    DesktopEntryInfo entryByPath(const QString &path) const;
+    DesktopEntryInfo entryByExec(const QString &exec) const;
+
+    static DesktopEntryInfo parse(const QString &path, const QString &id = QString());
+    static QStringList applicationDirs();
+
+Q_SIGNALS:
+    /*!
+     * \~chinese \name updated
+     * \~chinese \brief 索引构建完成或者重新构建完成
+     */
+    void updated();
+
+private:
+    explicit DesktopEntryIndex(QObject *parent = nullptr);
+
+    struct Snapshot {
+        QHash<QString, DesktopEntryInfo> entries;   // desktop id -> 应用信息
+        QHash<QString, QString> pathIndex;          // 路径 -> desktop id
+        QHash<QString, QString> execIndex;          // 可执行程序 -> desktop id
+        QStringList dirs;                           // 需要监听的目录
+        QHash<QString, QString> missingDirs;        // 还不存在的应用目录 -> 监听的最近的已存在的上级目录
+    };
+    static Snapshot scan(const QStringList &dirs, const QString &cacheFile);
+    static QString cacheFile();
+    static QString existingDir(const QString &dir);    // 目录本身或者最近的已存在的上级目录
+
+    void rebuild();
+    void onScanFinished();
+    void onDirectoryChanged(const QString &path);
+
+private:
+    Snapshot m_snapshot;
+    // 索引之外按路径单独解析过的desktop文件
+    mutable QHash<QString, DesktopEntryInfo> m_extraEntries;
+    bool m_ready;
+    bool m_rescanPending;
+    QFutureWatcher<Snapshot> *m_scanWatcher;
+    QFileSystemWatcher *m_fileWatcher;
+    QTimer *m_rescanTimer;
+};
+
+#endif // DESKTOPENTRYINDEX_H